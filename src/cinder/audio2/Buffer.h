@@ -23,29 +23,67 @@
 
 #pragma once
 
+#include "cinder/audio2/MemoryPool.h"
 #include "cinder/audio2/CinderAssert.h"
 
 #include <vector>
 #include <memory>
+#include <cstdint>
 #include <cstdlib>
 #include <algorithm>
-
-// TODO: It'd be nice to have a 'BufferView' or similar functionality
-// - would not own the internal buffer, but would point to another one, with offset + size
-// - alt. would be for BufferBaseT to take an alternate constructor
-//		- requires T* as data storage gain, which is also necessary to ensure 16byte alignment
+#include <cstring>
 
 namespace cinder { namespace audio2 {
 
-//! Audio buffer that stores channels of type \a T in contiguous arrays.
+//! Audio buffer that stores channels of type \a T in arrays.
+//! The storage is allocated from a MemoryPool if one is provided, otherwise from the heap, and is aligned to MemoryPool::getAlignment().
+//! The channels of planar buffers are padded to a multiple of getChannelAlignment() frames, so that every channel is aligned too.
 template <typename T>
 class BufferBaseT {
   public:
 	typedef T SampleType;
 
-	BufferBaseT( size_t numFrames, size_t numChannels )
-	: mNumFrames( numFrames ), mNumChannels( numChannels ), mData( numFrames * numChannels )
+	//! Copies \a other's samples. A copy of a view owns its storage, with its channels padded like any other buffer's.
+	BufferBaseT( const BufferBaseT &other )
+		: mNumChannels( other.mNumChannels ), mNumFrames( other.mNumFrames ), mData( nullptr ), mAllocatedSize( 0 ), mMemoryPool( other.mMemoryPool ),
+		mChannelStride( 0 ), mPaddedChannels( other.mPaddedChannels )
+	{
+		copyStorage( other );
+	}
+
+	BufferBaseT( BufferBaseT &&other )
+		: mNumChannels( other.mNumChannels ), mNumFrames( other.mNumFrames ), mData( nullptr ), mAllocatedSize( 0 ), mMemoryPool( other.mMemoryPool ),
+		mChannelStride( 0 ), mPaddedChannels( other.mPaddedChannels )
+	{
+		// a view's storage isn't its to give away
+		if( other.isView() ) {
+			copyStorage( other );
+			return;
+		}
+
+		mData = other.mData;
+		mAllocatedSize = other.mAllocatedSize;
+		other.mNumFrames = 0;
+		other.mData = nullptr;
+		other.mAllocatedSize = 0;
+	}
+
+	BufferBaseT& operator=( BufferBaseT other )
 	{
+		std::swap( mNumChannels, other.mNumChannels );
+		std::swap( mNumFrames, other.mNumFrames );
+		std::swap( mData, other.mData );
+		std::swap( mAllocatedSize, other.mAllocatedSize );
+		std::swap( mMemoryPool, other.mMemoryPool );
+		std::swap( mChannelStride, other.mChannelStride );
+		std::swap( mPaddedChannels, other.mPaddedChannels );
+		return *this;
+	}
+
+	~BufferBaseT()
+	{
+		if( ! isView() )
+			MemoryPool::deallocate( mData );
 	}
 
 	size_t getNumFrames() const		{ return mNumFrames; }
@@ -54,47 +92,158 @@ class BufferBaseT {
 
 	bool isEmpty() const			{ return mNumFrames == 0; }
 
-	T* getData() { return mData.data(); }
-	const T* getData() const { return mData.data(); }
+	//! Returns whether this buffer refers to another buffer's storage rather than owning its own. \see BufferViewT
+	bool	isView() const				{ return mChannelStride != 0; }
+	//! Returns the distance in samples between the start of each channel. Unless this is a view, it is getNumFrames(), rounded up to a multiple of getChannelAlignment() if the buffer is planar.
+	size_t	getChannelStride() const	{ return mChannelStride ? mChannelStride : getPaddedNumFrames( mNumFrames ); }
+	//! Returns whether the channels are adjacent in memory, so that getData() points to getSize() samples. This is the case for mono and interleaved buffers,
+	//! and for planar buffers whose number of frames is a multiple of getChannelAlignment(), which block sizes usually are.
+	bool	isContiguous() const		{ return mNumChannels <= 1 || getChannelStride() == mNumFrames; }
+	//! Returns the smallest number of samples that spans a multiple of MemoryPool::getAlignment(), which the channels of a planar buffer are padded to a multiple of.
+	static size_t getChannelAlignment()
+	{
+		// the largest power of two that sizeof( T ) is a multiple of, for sample types like Int24 that don't divide the alignment.
+		const size_t sampleAlignment = std::min( MemoryPool::getAlignment(), sizeof( T ) & ( ~sizeof( T ) + 1 ) );
+		return MemoryPool::getAlignment() / sampleAlignment;
+	}
+
+	//! Returns the first sample of the first channel. \note If isContiguous() returns false, the channels aren't adjacent to each other and must be accessed separately.
+	T* getData() { return mData; }
+	const T* getData() const { return mData; }
 
 	T& operator[]( size_t n )
 	{
 		CI_ASSERT( n < getSize() );
-		return mData[n];
+		return mData[getIndex( n )];
 	}
 
 	const T& operator[]( size_t n ) const
 	{
 		CI_ASSERT( n < getSize() );
-		return mData[n];
+		return mData[getIndex( n )];
 	}
 
 	void zero()
 	{
-		std::memset( mData.data(), 0, mData.size() * sizeof( T ) );
+		if( isView() ) {
+			for( size_t ch = 0; ch < mNumChannels; ch++ )
+				std::memset( mData + ch * mChannelStride, 0, mNumFrames * sizeof( T ) );
+		}
+		else if( mData )
+			std::memset( mData, 0, mAllocatedSize * sizeof( T ) );
 	}
 
+	//! Moves the storage to \a memoryPool, or to the heap if it is null, preserving its contents. Does nothing if the storage is already there.
+	//! \note Not supported for views.
+	void setMemoryPool( MemoryPool *memoryPool )
+	{
+		CI_ASSERT( ! isView() );
+
+		if( memoryPool != mMemoryPool )
+			reallocate( mAllocatedSize, memoryPool );
+	}
+	//! Returns the MemoryPool that the storage is allocated from, or null if it is allocated from the heap.
+	MemoryPool* getMemoryPool() const	{ return mMemoryPool; }
+
   protected:
-	std::vector<T> mData;
-	size_t mNumChannels, mNumFrames;
+	//! Allocates storage for \a numFrames of \a numChannels from \a memoryPool. If \a paddedChannels is true, the buffer is planar and its channels are padded.
+	BufferBaseT( size_t numFrames, size_t numChannels, MemoryPool *memoryPool, bool paddedChannels )
+		: mNumChannels( numChannels ), mNumFrames( numFrames ), mData( nullptr ), mAllocatedSize( 0 ), mMemoryPool( memoryPool ),
+		mChannelStride( 0 ), mPaddedChannels( paddedChannels )
+	{
+		reallocate( getStorageSize(), memoryPool );
+	}
+
+	//! Returns the number of samples that the storage needs to hold all channels, including their padding.
+	size_t getStorageSize() const	{ return getChannelStride() * mNumChannels; }
+
+	//! Replaces the storage with \a size samples allocated from \a memoryPool. The existing samples that fit are preserved and the rest are zeroed.
+	void reallocate( size_t size, MemoryPool *memoryPool )
+	{
+		CI_ASSERT( ! isView() );
+
+		T *data = nullptr;
+		if( size ) {
+			data = static_cast<T *>( MemoryPool::allocate( memoryPool, size * sizeof( T ) ) );
+
+			size_t numPreserved = std::min( size, mAllocatedSize );
+			std::copy( mData, mData + numPreserved, data );
+			std::memset( data + numPreserved, 0, ( size - numPreserved ) * sizeof( T ) );
+		}
+
+		MemoryPool::deallocate( mData );
+		mData = data;
+		mAllocatedSize = size;
+		mMemoryPool = memoryPool;
+	}
+
+	//! Makes this buffer a view of \a numChannels channels of \a numFrames, starting at \a data and \a channelStride samples apart.
+	void setView( T *data, size_t numFrames, size_t numChannels, size_t channelStride )
+	{
+		if( ! isView() )
+			reallocate( 0, mMemoryPool );
+
+		mData = data;
+		mNumFrames = numFrames;
+		mNumChannels = numChannels;
+		mChannelStride = std::max<size_t>( channelStride, 1 );
+	}
+
+	size_t		mNumChannels, mNumFrames;
+	T			*mData;
+	size_t		mAllocatedSize;
+	MemoryPool	*mMemoryPool;
+	size_t		mChannelStride; // 0 unless this is a view
+	bool		mPaddedChannels;
+
+  private:
+	size_t getPaddedNumFrames( size_t numFrames ) const
+	{
+		if( ! mPaddedChannels )
+			return numFrames;
+
+		const size_t alignment = getChannelAlignment();
+		return ( numFrames + alignment - 1 ) / alignment * alignment;
+	}
+
+	size_t getIndex( size_t n ) const
+	{
+		return isContiguous() ? n : ( n / mNumFrames ) * getChannelStride() + n % mNumFrames;
+	}
+
+	// called on construction, so that storage is allocated for this buffer's frames.
+	void copyStorage( const BufferBaseT &other )
+	{
+		if( other.isView() ) {
+			reallocate( getStorageSize(), mMemoryPool );
+			for( size_t ch = 0; ch < mNumChannels; ch++ ) {
+				const T *channel = other.mData + ch * other.mChannelStride;
+				std::copy( channel, channel + mNumFrames, mData + ch * getChannelStride() );
+			}
+		}
+		else {
+			reallocate( other.mAllocatedSize, mMemoryPool );
+			std::copy( other.mData, other.mData + other.mAllocatedSize, mData );
+		}
+	}
 };
 
 template <typename T>
 class BufferT : public BufferBaseT<T> {
   public:
 
-	BufferT( size_t numFrames = 0, size_t numChannels = 1 ) : BufferBaseT<T>( numFrames, numChannels ) {}
+	BufferT( size_t numFrames = 0, size_t numChannels = 1, MemoryPool *memoryPool = nullptr ) : BufferBaseT<T>( numFrames, numChannels, memoryPool, true ) {}
 
 	T* getChannel( size_t ch )
 	{
 		CI_ASSERT_MSG( ch < this->mNumChannels, "ch out of range" );
-		return &this->mData[ch * this->mNumFrames];
+		return &this->mData[ch * this->getChannelStride()];
 	}
 
 	const T* getChannel( size_t ch ) const
 	{
 		CI_ASSERT_MSG( ch < this->mNumChannels, "ch out of range" );
-		return &this->mData[ch * this->mNumFrames];
+		return &this->mData[ch * this->getChannelStride()];
 	}
 
 	using BufferBaseT<T>::zero;
@@ -144,7 +293,7 @@ class BufferT : public BufferBaseT<T> {
 template <typename T>
 class BufferInterleavedT : public BufferBaseT<T> {
   public:
-	BufferInterleavedT( size_t numFrames = 0, size_t numChannels = 1 ) : BufferBaseT<T>( numFrames, numChannels ) {}
+	BufferInterleavedT( size_t numFrames = 0, size_t numChannels = 1, MemoryPool *memoryPool = nullptr ) : BufferBaseT<T>( numFrames, numChannels, memoryPool, false ) {}
 
 	using BufferBaseT<T>::zero;
 
@@ -167,8 +316,8 @@ class BufferSpectralT : public BufferT<T> {
 	T* getReal()				{ return &this->mData[0]; }
 	const T* getReal() const	{ return &this->mData[0]; }
 
-	T* getImag()				{ return &this->mData[this->mNumFrames]; }
-	const T* getImag() const	{ return &this->mData[this->mNumFrames]; }
+	T* getImag()				{ return this->getChannel( 1 ); }
+	const T* getImag() const	{ return this->getChannel( 1 ); }
 
 };
 
@@ -178,9 +327,7 @@ class BufferSpectralT : public BufferT<T> {
 template <typename T>
 class BufferDynamicT : public BufferT<T> {
   public:
-	BufferDynamicT( size_t numFrames = 0, size_t numChannels = 1 ) : BufferT<T>( numFrames, numChannels ),
-		mAllocatedSize( numFrames * numChannels )
-	{}
+	BufferDynamicT( size_t numFrames = 0, size_t numChannels = 1, MemoryPool *memoryPool = nullptr ) : BufferT<T>( numFrames, numChannels, memoryPool ) {}
 
 	void setSize( size_t numFrames, size_t numChannels )
 	{
@@ -204,23 +351,61 @@ class BufferDynamicT : public BufferT<T> {
 	//! Shrinks the allocated size to match the specified size, freeing any extra memory.
 	void shrinkToFit()
 	{
-		mAllocatedSize = this->getSize();
-		this->mData.resize( mAllocatedSize );
+		this->reallocate( this->getStorageSize(), this->mMemoryPool );
 	}
 
-	size_t getAllocatedSize() const		{ return mAllocatedSize; }
+	//! Returns the number of samples allocated, including the padding of each channel.
+	size_t getAllocatedSize() const		{ return this->mAllocatedSize; }
 
   private:
 	void resizeIfNecessary()
 	{
-		size_t size = this->getSize();
-		if( mAllocatedSize < size ) {
-			mAllocatedSize = size;
-			this->mData.resize( mAllocatedSize );
-		}
+		size_t size = this->getStorageSize();
+		if( this->mAllocatedSize < size )
+			this->reallocate( size, this->mMemoryPool );
+	}
+};
+
+//! \brief Non-owning BufferT that refers to a range of frames of another BufferT's channels.
+//!
+//! Lets code that writes to a BufferT, such as a Converter or a SourceFile, write straight into part of a larger buffer rather than into a
+//! temporary that is then copied. Channels are accessed with getChannel() as usual, but unless isContiguous() returns true they aren't
+//! adjacent in memory, so getData() and getSize() don't describe the whole view. A view is only valid while the buffer it refers to isn't
+//! resized or destroyed. Copying a view makes another view of the same storage, while copying it to a BufferT copies the samples.
+template <typename T>
+class BufferViewT : public BufferT<T> {
+  public:
+	//! Constructs an empty view.
+	BufferViewT() {}
+	//! Constructs a view of \a numFrames frames of \a buffer's channels, starting at \a frameOffset.
+	BufferViewT( BufferT<T> *buffer, size_t frameOffset, size_t numFrames )
+	{
+		CI_ASSERT( frameOffset + numFrames <= buffer->getNumFrames() );
+		this->setView( buffer->getData() + frameOffset, numFrames, buffer->getNumChannels(), buffer->getChannelStride() );
+	}
+	//! Constructs a view of \a buffer's channels from \a frameOffset to the end.
+	explicit BufferViewT( BufferT<T> *buffer, size_t frameOffset = 0 )
+	{
+		CI_ASSERT( frameOffset <= buffer->getNumFrames() );
+		this->setView( buffer->getData() + frameOffset, buffer->getNumFrames() - frameOffset, buffer->getNumChannels(), buffer->getChannelStride() );
 	}
 
-	size_t mAllocatedSize;
+	BufferViewT( const BufferViewT &other )
+		: BufferT<T>()
+	{
+		this->setView( other.mData, other.mNumFrames, other.mNumChannels, other.getChannelStride() );
+	}
+
+	BufferViewT& operator=( const BufferViewT &other )
+	{
+		this->setView( other.mData, other.mNumFrames, other.mNumChannels, other.getChannelStride() );
+		return *this;
+	}
+};
+
+//! Signed 24-bit sample packed into three bytes, least significant first. A BufferT<Int24> takes three quarters of the memory of a Buffer. \see dsp::convert()
+struct Int24 {
+	uint8_t mBytes[3];
 };
 
 //! Simple functor wrapping free(), suitable for unique_ptr's that allocate memory with malloc, calloc and realloc.
@@ -229,31 +414,40 @@ struct FreeDeleter {
 	void operator()( T *x ) { std::free( x ); }
 };
 
-//! Returns an array of \a size elements of type \a T, aligned by \a alignment.
+//! Simple functor wrapping MemoryPool::deallocate(), suitable for unique_ptr's returned by makeAlignedArray().
+template<typename T>
+struct AlignedDeleter {
+	void operator()( T *x ) { MemoryPool::deallocate( x ); }
+};
+
+//! Returns a zeroed array of \a size elements of type \a T, aligned by \a alignment, which must be a power of two no larger than MemoryPool::getAlignment().
 template<typename T>
-std::unique_ptr<T, FreeDeleter<T> > makeAlignedArray( size_t size, size_t alignment = 16 )
+std::unique_ptr<T, AlignedDeleter<T> > makeAlignedArray( size_t size, size_t alignment = 64 )
 {
-	void *ptr = std::calloc( size, sizeof( T ) );
-
-	// FIXME: broken on windows, this is returning NULL.
-	// unnecessary at the moment anyway, so it is commented out until fixed
-	//ptr = std::align( alignment, size, ptr, size );
-	//CI_ASSERT( ptr );
-	
-	return std::unique_ptr<T, FreeDeleter<T> >( static_cast<T *>( ptr ) );
+	CI_ASSERT_MSG( alignment && MemoryPool::getAlignment() % alignment == 0, "unsupported alignment" );
+
+	void *ptr = MemoryPool::allocate( nullptr, size * sizeof( T ) );
+	std::memset( ptr, 0, size * sizeof( T ) );
+
+	return std::unique_ptr<T, AlignedDeleter<T> >( static_cast<T *>( ptr ) );
 }
 
-typedef std::unique_ptr<float, FreeDeleter<float> > AlignedArrayPtr;
-typedef std::unique_ptr<double, FreeDeleter<double> > AlignedArrayPtrd;
+typedef std::unique_ptr<float, AlignedDeleter<float> > AlignedArrayPtr;
+typedef std::unique_ptr<double, AlignedDeleter<double> > AlignedArrayPtrd;
 
 typedef BufferT<float>				Buffer;
 typedef BufferInterleavedT<float>	BufferInterleaved;
 typedef BufferSpectralT<float>		BufferSpectral;
 typedef BufferDynamicT<float>		BufferDynamic;
+typedef BufferViewT<float>			BufferView;
+typedef BufferT<int16_t>			BufferInt16;
+typedef BufferT<Int24>				BufferInt24;
 
 typedef std::shared_ptr<Buffer>				BufferRef;
 typedef std::shared_ptr<BufferInterleaved>	BufferInterleavedRef;
 typedef std::shared_ptr<BufferSpectral>		BufferSpectralRef;
 typedef std::shared_ptr<BufferDynamic>		BufferDynamicRef;
+typedef std::shared_ptr<BufferInt16>		BufferInt16Ref;
+typedef std::shared_ptr<BufferInt24>		BufferInt24Ref;
 
 } } // namespace cinder::audio2
\ No newline at end of file
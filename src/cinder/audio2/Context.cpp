@@ -23,13 +23,18 @@
 
 #include "cinder/audio2/Context.h"
 #include "cinder/audio2/NodeInput.h"
-#include "cinder/audio2/dsp/Converter.h"
+#include "cinder/audio2/GraphRecorder.h"
 #include "cinder/audio2/Debug.h"
 
 #include "cinder/Cinder.h"
 
 #include "cinder/app/App.h"		// for app::console()
 
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
 #if defined( CINDER_COCOA )
 	#include "cinder/audio2/cocoa/ContextAudioUnit.h"
 	#if defined( CINDER_MAC )
@@ -41,12 +46,47 @@
 	#define CINDER_AUDIO_WASAPI
 	#include "cinder/audio2/msw/ContextWasapi.h"
 	#include "cinder/audio2/msw/DeviceManagerWasapi.h"
+#else
+	#define CINDER_AUDIO_NULL
+	#include "cinder/audio2/ContextNull.h"
+	#include "cinder/audio2/DeviceManagerNull.h"
 #endif
 
 using namespace std;
 
 namespace cinder { namespace audio2 {
 
+namespace {
+
+// One housekeeping thread is shared by every Context in the process, so that creating many of them, such as one per BatchRender job,
+// doesn't create as many threads. It is started by the first Context and joined at exit. Defined before sMasterContext so it outlives it.
+struct Housekeeping {
+	Housekeeping() : mRunning( false )	{}
+
+	~Housekeeping()
+	{
+		{
+			lock_guard<mutex> lock( mMutex );
+			mRunning = false;
+		}
+		mCondition.notify_one();
+
+		if( mThread.joinable() )
+			mThread.join();
+	}
+
+	mutex				mMutex;
+	condition_variable	mCondition;
+	thread				mThread;
+	bool				mRunning;
+	// guarded by mMutex
+	vector<Context *>	mContexts;
+};
+
+Housekeeping sHousekeeping;
+
+} // anonymous namespace
+
 std::shared_ptr<Context>		Context::sMasterContext;
 std::unique_ptr<DeviceManager>	Context::sDeviceManager;
 
@@ -75,6 +115,8 @@ Context* Context::master()
 	//#else
 	//	sMasterContext.reset( new msw::ContextXAudio() );
 	#endif
+#elif defined( CINDER_AUDIO_NULL )
+		sMasterContext.reset( new ContextNull() );
 #endif
 		if( ! sIsRegisteredForShutdown )
 			registerClearStatics();
@@ -96,6 +138,8 @@ DeviceManager* Context::deviceManager()
 	//#else
 	//	CI_ASSERT( 0 && "TODO: simple DeviceManagerXp" );
 	#endif
+#elif defined( CINDER_AUDIO_NULL )
+		sDeviceManager.reset( new DeviceManagerNull() );
 #endif
 		if( ! sIsRegisteredForShutdown )
 			registerClearStatics();
@@ -110,11 +154,55 @@ void Context::setMaster( Context *masterContext, DeviceManager *deviceManager )
 	sDeviceManager.reset( deviceManager );
 }
 
+namespace {
+
+const size_t kHousekeepingIntervalMs = 20;
+
+// counts a non-audio thread that reads the published RenderGraph in Context::mNumRenderGraphReaders while in scope.
+struct ScopedRenderGraphReader {
+	ScopedRenderGraphReader( atomic<size_t> &numReaders ) : mNumReaders( numReaders )	{ mNumReaders++; }
+	~ScopedRenderGraphReader()															{ mNumReaders--; }
+
+  private:
+	atomic<size_t>	&mNumReaders;
+};
+
+} // anonymous namespace
+
+Context::Context()
+	: mRenderGraph( nullptr ), mRenderEpoch( 0 ), mNumRenderGraphReaders( 0 ), mRetiredHead( nullptr ), mNumRetired( 0 ), mScheduledStopReached( false ), mEnabled( false ),
+		mNumDeferredUpdates( 0 ), mRenderGraphUpdatePending( false ), mMemoryPool( new MemoryPool )
+{
+	lock_guard<mutex> lock( sHousekeeping.mMutex );
+	sHousekeeping.mContexts.push_back( this );
+
+	if( ! sHousekeeping.mRunning ) {
+		sHousekeeping.mRunning = true;
+		sHousekeeping.mThread = thread( &Context::housekeepingLoop );
+	}
+}
+
 Context::~Context()
 {
 	stop();
-	lock_guard<mutex> lock( mMutex );
-	uninitializeAllNodes();
+	{
+		lock_guard<mutex> lock( mMutex );
+		uninitializeAllNodes();
+	}
+
+	delete mRenderGraph.exchange( nullptr );
+
+	// once removed, the housekeeping thread no longer collects from this Context.
+	{
+		lock_guard<mutex> lock( sHousekeeping.mMutex );
+		vector<Context *> &contexts = sHousekeeping.mContexts;
+		contexts.erase( remove( contexts.begin(), contexts.end(), this ), contexts.end() );
+	}
+
+	// the audio thread has stopped, so anything still retired is destroyed now.
+	collectRetired();
+
+	mMemoryPool->release();
 }
 
 void Context::start()
@@ -125,8 +213,10 @@ void Context::start()
 	const auto &output = getOutput();
 
 	// output may not yet be initialized if no Node's are connected to it.
-	if( ! output->isInitialized() )
+	if( ! output->isInitialized() ) {
 		output->initializeImpl();
+		updateRenderGraph();
+	}
 
 	mEnabled = true;
 	getOutput()->start();
@@ -145,6 +235,8 @@ void Context::initializeAllNodes()
 {
 	set<NodeRef> traversedNodes;
 	initRecursisve( mOutput, traversedNodes );
+
+	updateRenderGraph();
 }
 
 void Context::uninitializeAllNodes()
@@ -167,9 +259,44 @@ void Context::setEnabled( bool enabled )
 		stop();
 }
 
+void Context::enableParallelProcessing( bool enable, size_t numThreads )
+{
+	if( ! enable )
+		setWorkerPool( nullptr );
+	else if( ! mWorkerPool || ( numThreads && mWorkerPool->getNumThreads() != numThreads ) )
+		setWorkerPool( make_shared<WorkerPool>( numThreads ) );
+}
+
+void Context::setWorkerPool( const WorkerPoolRef &workerPool )
+{
+	{
+		lock_guard<mutex> lock( mMutex );
+		mWorkerPool = workerPool;
+	}
+
+	// the previous WorkerPool is released along with the RenderGraph that uses it, once the audio thread is done with it.
+	updateRenderGraph();
+}
+
+void Context::setGraphRecorder( const GraphRecorderRef &recorder )
+{
+	if( recorder ) {
+		const NodeOutputRef &output = getOutput();
+		recorder->begin( getSampleRate(), getFramesPerBlock(), output->getNumChannels(), output.get(), getNumProcessedFrames() );
+	}
+
+	atomic_store( &mGraphRecorder, recorder );
+}
+
+GraphRecorderRef Context::getGraphRecorder() const
+{
+	return atomic_load( &mGraphRecorder );
+}
+
 void Context::setOutput( const NodeOutputRef &output )
 {
 	mOutput = output;
+	updateRenderGraph();
 }
 
 const NodeOutputRef& Context::getOutput()
@@ -182,6 +309,9 @@ const NodeOutputRef& Context::getOutput()
 void Context::initializeNode( const NodeRef &node )
 {
 	node->initializeImpl();
+
+	// uninitializing a Node suspends rendering if it is part of the RenderGraph
+	updateRenderGraph();
 }
 
 void Context::uninitializeNode( const NodeRef &node )
@@ -230,52 +360,302 @@ void Context::uninitRecursisve( const NodeRef &node, set<NodeRef> &traversedNode
 
 void Context::addAutoPulledNode( const NodeRef &node )
 {
-	mAutoPulledNodes.insert( node );
-	mAutoPullRequired = true;
-	mAutoPullCacheDirty = true;
+	// make sure there is an output to pull the auto-pulled nodes
+	getOutput();
+
+	{
+		lock_guard<mutex> lock( mMutex );
+		mAutoPulledNodes.insert( node );
+	}
 
-	// if not done already, allocate a buffer for auto-pulling that is large enough for stereo processing
-	size_t framesPerBlock = getFramesPerBlock();
-	if( mAutoPullBuffer.getNumFrames() < framesPerBlock )
-		mAutoPullBuffer.setSize( framesPerBlock, 2 );
+	updateRenderGraph();
 }
 
 void Context::removeAutoPulledNode( const NodeRef &node )
 {
-	size_t result = mAutoPulledNodes.erase( node );
-	CI_ASSERT( result );
+	{
+		lock_guard<mutex> lock( mMutex );
+		size_t result = mAutoPulledNodes.erase( node );
+		CI_ASSERT( result );
+	}
 
-	mAutoPullCacheDirty = true;
-	if( mAutoPulledNodes.empty() )
-		mAutoPullRequired = false;
+	updateRenderGraph();
 }
 
-void Context::processAutoPulledNodes()
+void Context::connectionsDidChange( const NodeRef &node )
+{
+	updateRenderGraph();
+}
+
+void Context::updateRenderGraph()
+{
+	RenderGraph *retiredGraph;
+	{
+		lock_guard<mutex> lock( mMutex );
+
+		if( mNumDeferredUpdates ) {
+			mRenderGraphUpdatePending = true;
+			return;
+		}
+
+		RenderGraph *renderGraph = nullptr;
+		if( mOutput ) {
+			renderGraph = new RenderGraph( mOutput, mAutoPulledNodes, mOutput->getOutputFramesPerBlock(), mWorkerPool, mMemoryPool );
+			mMemoryReport = renderGraph->getMemoryReport();
+		}
+		else
+			mMemoryReport = RenderGraph::MemoryReport();
+
+		// published while locked, so that concurrent updates are published in the order they were compiled.
+		retiredGraph = mRenderGraph.exchange( renderGraph );
+	}
+
+	// The retired RenderGraph may hold the last references to disconnected Node's, so it is retired after the lock is released.
+	if( retiredGraph )
+		retire( shared_ptr<RenderGraph>( retiredGraph ) );
+}
+
+void Context::deferRenderGraphUpdates()
+{
+	lock_guard<mutex> lock( mMutex );
+	mNumDeferredUpdates++;
+}
+
+void Context::resumeRenderGraphUpdates()
 {
-	if( ! mAutoPullRequired )
+	bool update;
+	{
+		lock_guard<mutex> lock( mMutex );
+		CI_ASSERT( mNumDeferredUpdates );
+
+		update = ( --mNumDeferredUpdates == 0 && mRenderGraphUpdatePending );
+		if( update )
+			mRenderGraphUpdatePending = false;
+	}
+
+	if( update )
+		updateRenderGraph();
+}
+
+void Context::suspendRenderGraph( const Node *node )
+{
+	RenderGraph *renderGraph = mRenderGraph.load();
+	if( ! renderGraph || ! renderGraph->contains( node ) || ! mRenderGraph.compare_exchange_strong( renderGraph, nullptr ) )
 		return;
 
-	for( Node *node : getAutoPulledNodes() ) {
-		mAutoPullBuffer.setNumChannels( node->getNumChannels() );
-		node->pullInputs( &mAutoPullBuffer );
-		if( ! node->getProcessInPlace() )
-			dsp::mixBuffers( node->getInternalBuffer(), &mAutoPullBuffer );
+	uint64_t renderEpoch = mRenderEpoch.load();
+	if( renderEpoch & 1 ) {
+		while( mRenderEpoch.load( memory_order_acquire ) == renderEpoch )
+			this_thread::yield();
 	}
+
+	retire( shared_ptr<RenderGraph>( renderGraph ) );
 }
 
-const std::vector<Node *>& Context::getAutoPulledNodes()
+// The audio thread increments mRenderEpoch (making it odd) before it loads the published RenderGraph, and again once it has finished
+// processing. Since an object is retired after its replacement is published, the audio thread can only be using it if it was already
+// processing when it was retired, in which case it is safe to destroy once the epoch has moved on. Likewise, a non-audio thread reading
+// the RenderGraph is counted in mNumRenderGraphReaders before it loads it, so nothing is destroyed while that count is non-zero.
+void Context::retire( const shared_ptr<void> &object )
 {
-	if( mAutoPullCacheDirty ) {
-		mAutoPullCache.clear();
-		for( const NodeRef &node : mAutoPulledNodes )
-			mAutoPullCache.push_back( node.get() );
+	if( ! object )
+		return;
+
+	RetiredObject *retired = new RetiredObject( mRenderEpoch.load(), object );
+	mNumRetired++;
+
+	retired->mNext = mRetiredHead.load( memory_order_relaxed );
+	while( ! mRetiredHead.compare_exchange_weak( retired->mNext, retired, memory_order_release, memory_order_relaxed ) )
+		;
+
+	sHousekeeping.mCondition.notify_one();
+}
+
+void Context::collectRetired()
+{
+	// objects are destroyed when this goes out of scope, after mRetiredMutex is released, as their destructors may retire other objects.
+	vector<RetiredObject> destroyedObjects;
+	collectRetired( &destroyedObjects );
+}
+
+void Context::collectRetired( vector<RetiredObject> *destroyedObjects )
+{
+	lock_guard<mutex> lock( mRetiredMutex );
+
+	RetiredObject *retired = mRetiredHead.exchange( nullptr, memory_order_acquire );
+	while( retired ) {
+		RetiredObject *next = retired->mNext;
+		mRetiredObjects.push_back( *retired );
+		delete retired;
+		retired = next;
+	}
+
+	// loaded after the retired objects were taken, so any reader that loaded one of them before it was replaced is still counted.
+	if( mRetiredObjects.empty() || mNumRenderGraphReaders.load() != 0 )
+		return;
+
+	size_t numDestroyed = 0;
+	uint64_t renderEpoch = mRenderEpoch.load( memory_order_acquire );
+	for( auto retiredIt = mRetiredObjects.begin(); retiredIt != mRetiredObjects.end(); /* */ ) {
+		if( ( retiredIt->mRenderEpoch & 1 ) == 0 || retiredIt->mRenderEpoch != renderEpoch ) {
+			destroyedObjects->push_back( *retiredIt );
+			retiredIt = mRetiredObjects.erase( retiredIt );
+			numDestroyed++;
+		}
+		else
+			++retiredIt;
+	}
+
+	mNumRetired -= numDestroyed;
+}
+
+void Context::collectScheduledStops( vector<NodeRef> *nodes )
+{
+	if( ! mScheduledStopReached.exchange( false ) )
+		return;
+
+	ScopedRenderGraphReader reader( mNumRenderGraphReaders );
+	RenderGraph *renderGraph = mRenderGraph.load();
+	if( ! renderGraph )
+		return;
+
+	for( const NodeRef &node : renderGraph->getNodes() ) {
+		if( node->mReachedStopFrame )
+			nodes->push_back( node );
+	}
+}
+
+// static
+void Context::housekeepingLoop()
+{
+	vector<RetiredObject> destroyedObjects;
+	vector<NodeRef> stoppedNodes;
+
+	unique_lock<mutex> lock( sHousekeeping.mMutex );
+	while( sHousekeeping.mRunning ) {
+		sHousekeeping.mCondition.wait_for( lock, chrono::milliseconds( kHousekeepingIntervalMs ) );
+
+		// a Context can't be destroyed while it is being collected from, as its destructor first removes it under the same lock.
+		for( Context *context : sHousekeeping.mContexts ) {
+			context->collectRetired( &destroyedObjects );
+			context->collectScheduledStops( &stoppedNodes );
+		}
+
+		// the objects are destroyed and the Node's stopped without the lock, as either may create or destroy Context's.
+		lock.unlock();
+		destroyedObjects.clear();
+		for( const NodeRef &node : stoppedNodes )
+			node->finishScheduledStop();
+		stoppedNodes.clear();
+		lock.lock();
+	}
+}
+
+RenderGraph::MemoryReport Context::getMemoryReport() const
+{
+	lock_guard<mutex> lock( mMutex );
+	return mMemoryReport;
+}
+
+void Context::processRenderGraph()
+{
+	mRenderEpoch++;
+
+	RenderGraph *renderGraph = mRenderGraph.load();
+	if( renderGraph )
+		renderGraph->process( getNumProcessedFrames() );
+
+	mRenderEpoch.fetch_add( 1, memory_order_release );
+}
+
+void Context::processAutoPulledNodes()
+{
+	mRenderEpoch++;
+
+	RenderGraph *renderGraph = mRenderGraph.load();
+	if( renderGraph )
+		renderGraph->processAutoPulled( getNumProcessedFrames() );
+
+	mRenderEpoch.fetch_add( 1, memory_order_release );
+}
+
+ProfileSnapshot Context::getProfileSnapshot() const
+{
+	ProfileSnapshot result;
+
+#if defined( CINDER_AUDIO_PROFILING )
+	// the RenderGraph may be replaced and retired while its Node's are read, but it isn't destroyed until the reader is done.
+	ScopedRenderGraphReader reader( mNumRenderGraphReaders );
+	RenderGraph *renderGraph = mRenderGraph.load();
+	if( renderGraph ) {
+		for( const NodeRef &node : renderGraph->getNodes() ) {
+			ProfileSnapshot::NodeStats nodeStats;
+			nodeStats.mNode = node;
+			nodeStats.mStats = node->getProcessProfile().getStats();
+			result.mNodeStats.push_back( nodeStats );
+		}
+	}
+
+#endif
+
+	if( mOutput ) {
+		result.mBlockStats = mOutput->getRenderStats();
+		result.mBlockDeadlineSeconds = mOutput->getBlockDeadlineSeconds();
+		result.mNumDeadlineMisses = mOutput->getNumDeadlineMisses();
+	}
+
+	return result;
+}
+
+void Context::resetProfile()
+{
+#if defined( CINDER_AUDIO_PROFILING )
+	ScopedRenderGraphReader reader( mNumRenderGraphReaders );
+	RenderGraph *renderGraph = mRenderGraph.load();
+	if( renderGraph ) {
+		for( const NodeRef &node : renderGraph->getNodes() )
+			node->getProcessProfile().reset();
 	}
-	return mAutoPullCache;
+#endif
+
+	if( mOutput )
+		mOutput->resetRenderStats();
+}
+
+CpuBudgetReport Context::getCpuBudgetReport() const
+{
+	CpuBudgetReport result;
+
+	if( ! mOutput )
+		return result;
+
+	ProfileStats stats = mOutput->getRenderStats();
+	double deadlineSeconds = mOutput->getBlockDeadlineSeconds();
+
+	result.mBudget = mOutput->getCpuBudget();
+	result.mNumBlocks = stats.mNumCalls;
+	result.mNumOverBudget = mOutput->getNumOverBudget();
+	result.mNumDeadlineMisses = mOutput->getNumDeadlineMisses();
+	if( deadlineSeconds > 0 ) {
+		result.mMeanLoad = stats.mMeanSeconds / deadlineSeconds;
+		result.mPercentile99Load = stats.mPercentile99Seconds / deadlineSeconds;
+		result.mMaxLoad = stats.mMaxSeconds / deadlineSeconds;
+	}
+
+	return result;
 }
 
 namespace {
 
-void printRecursive( const NodeRef &node, size_t depth, set<NodeRef> &traversedNodes )
+// formats \a seconds in microseconds.
+string formatMicroseconds( double seconds )
+{
+	ostringstream stream;
+	stream << fixed << setprecision( 1 ) << seconds * 1e6;
+	return stream.str();
+}
+
+void printRecursive( const NodeRef &node, size_t depth, set<NodeRef> &traversedNodes, const ProfileSnapshot &profile )
 {
 	if( ! node )
 		return;
@@ -300,10 +680,18 @@ void printRecursive( const NodeRef &node, size_t depth, set<NodeRef> &traversedN
 	app::console() << ", ch: " << node->getNumChannels();
 	app::console() << ", ch mode: " << channelMode;
 	app::console() << ", " << ( node->getProcessInPlace() ? "in-place" : "sum" );
-	app::console() << " ]" << endl;
+	app::console() << " ]";
+
+	const ProfileStats *stats = profile.findStats( node.get() );
+	if( stats && stats->mNumCalls ) {
+		app::console() << "\t[ mean / 99% / max: " << formatMicroseconds( stats->mMeanSeconds ) << " / " << formatMicroseconds( stats->mPercentile99Seconds );
+		app::console() << " / " << formatMicroseconds( stats->mMaxSeconds ) << " us, calls: " << stats->mNumCalls << " ]";
+	}
+
+	app::console() << endl;
 
 	for( const auto &in : node->getInputs() )
-		printRecursive( in.second, depth + 1, traversedNodes );
+		printRecursive( in.second, depth + 1, traversedNodes, profile );
 };
 
 } // anonymous namespace
@@ -311,14 +699,25 @@ void printRecursive( const NodeRef &node, size_t depth, set<NodeRef> &traversedN
 void Context::printGraph()
 {
 	set<NodeRef> traversedNodes;
+	ProfileSnapshot profile = getProfileSnapshot();
 
 	app::console() << "-------------- Graph configuration: --------------" << endl;
-	printRecursive( getOutput(), 0, traversedNodes );
+	printRecursive( getOutput(), 0, traversedNodes, profile );
 
 	if( ! mAutoPulledNodes.empty() ) {
 		app::console() << "(auto-pulled:)" << endl;
 		for( const auto& node : mAutoPulledNodes )
-			printRecursive( node, 0, traversedNodes );
+			printRecursive( node, 0, traversedNodes, profile );
+	}
+
+	RenderGraph::MemoryReport report = getMemoryReport();
+	app::console() << "buffers: " << report.mNumRenderBuffers << " (" << report.mNumRenderBytes / 1024 << " kb), ";
+	app::console() << "without pooling: " << report.mNumNodeBuffers << " (" << report.mNumNodeBytes / 1024 << " kb)" << endl;
+
+	if( profile.mBlockStats.mNumCalls ) {
+		app::console() << "blocks: " << profile.mBlockStats.mNumCalls << ", mean / 99% / max: " << formatMicroseconds( profile.mBlockStats.mMeanSeconds ) << " / ";
+		app::console() << formatMicroseconds( profile.mBlockStats.mPercentile99Seconds ) << " / " << formatMicroseconds( profile.mBlockStats.mMaxSeconds ) << " us";
+		app::console() << " of " << formatMicroseconds( profile.mBlockDeadlineSeconds ) << " us (max load: " << int( profile.getMaxLoad() * 100 ) << "%), deadline misses: " << profile.mNumDeadlineMisses << endl;
 	}
 	app::console() << "--------------------------------------------------" << endl;
 }
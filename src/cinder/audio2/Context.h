@@ -23,17 +23,30 @@
 
 #pragma once
 
+#include "cinder/audio2/MemoryPool.h"
 #include "cinder/audio2/Node.h"
 #include "cinder/audio2/NodeInput.h"
 #include "cinder/audio2/NodeOutput.h"
+#include "cinder/audio2/RenderGraph.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
 #include <set>
+#include <vector>
 
 namespace cinder { namespace audio2 {
 
 class DeviceManager;
 
+typedef std::shared_ptr<class GraphRecorder>	GraphRecorderRef;
+
+//! \brief Owns a graph of Node's and the NodeOutput that renders it.
+//!
+//! The master() Context drives the platform's audio hardware. Any number of other Context's, such as ContextOffline or ContextNull, can be
+//! created alongside it. Each has its own graph, mutex and render thread, so they never contend with each other, while a single
+//! housekeeping thread is shared by all of them.
+//! Context's that render concurrently can share a WorkerPool with setWorkerPool().
 class Context : public std::enable_shared_from_this<Context> {
   public:
 	virtual ~Context();
@@ -50,9 +63,24 @@ class Context : public std::enable_shared_from_this<Context> {
 	//! Creates and returns a platform-specific LineIn, which captures audio from the hardware input device specified by \a device. 
 	virtual LineInRef		createLineIn( const DeviceRef &device = Device::getDefaultInput(), const Node::Format &format = Node::Format() ) = 0;
 
-	//! Interface for creating new Node's of type \a NodeT, which are thereafter owned by this Context.
+	//! Interface for creating new Node's of type \a NodeT, which are thereafter owned by this Context. The shared_ptr's control block is allocated from getMemoryPool().
 	template<typename NodeT>
 	std::shared_ptr<NodeT>		makeNode( NodeT *node );
+	//! Constructs a Node of type \a NodeT in getMemoryPool() and returns it from makeNode(), so that the Node and its control block sit in the Context's pool rather than on the heap.
+	template<typename NodeT>
+	std::shared_ptr<NodeT>		makePooledNode();
+	//! \see makePooledNode()
+	template<typename NodeT, typename A1>
+	std::shared_ptr<NodeT>		makePooledNode( A1 &&a1 );
+	//! \see makePooledNode()
+	template<typename NodeT, typename A1, typename A2>
+	std::shared_ptr<NodeT>		makePooledNode( A1 &&a1, A2 &&a2 );
+	//! \see makePooledNode()
+	template<typename NodeT, typename A1, typename A2, typename A3>
+	std::shared_ptr<NodeT>		makePooledNode( A1 &&a1, A2 &&a2, A3 &&a3 );
+
+	//! Returns the MemoryPool that this Context allocates its Node's, their control blocks and their block-sized Buffer's from.
+	MemoryPool*	getMemoryPool() const	{ return mMemoryPool; }
 
 	virtual void setOutput( const NodeOutputRef &output );
 
@@ -67,8 +95,24 @@ class Context : public std::enable_shared_from_this<Context> {
 	//! Returns whether or not this \a Context is current enabled and processing audio.
 	bool isEnabled() const		{ return mEnabled; }
 
-	//! Called by \a node when it's connections have changed, default implementation is empty.
-	virtual void connectionsDidChange( const NodeRef &node ) {} 
+	//! Enables processing independent branches of the graph in parallel, using a WorkerPool with \a numThreads threads in addition to the audio thread. If \a numThreads is 0, one less than the number of hardware threads is used. Disabled by default.
+	//! \note A branch is an input of a summing Node, where every Node in that input's sub-graph has only one output. \see RenderGraph
+	void enableParallelProcessing( bool enable = true, size_t numThreads = 0 );
+	//! Returns whether independent branches of the graph are processed in parallel.
+	bool isParallelProcessingEnabled() const	{ return (bool)mWorkerPool; }
+	//! Processes independent branches of the graph with \a workerPool, or disables parallel processing if it is null. One WorkerPool can be shared by
+	//! many Context's, each rendering on its own thread, so that they don't start more threads than there are cores. \see WorkerPool::run()
+	void setWorkerPool( const WorkerPoolRef &workerPool );
+	//! Returns the WorkerPool used to process independent branches of the graph, or null if parallel processing is disabled.
+	const WorkerPoolRef& getWorkerPool() const	{ return mWorkerPool; }
+
+	//! Starts recording every edit made to the graph with \a recorder, replacing any previous recorder, or stops recording if it is null. \see GraphRecorder
+	void setGraphRecorder( const GraphRecorderRef &recorder );
+	//! Returns the GraphRecorder that edits to the graph are recorded with, or null if they aren't being recorded.
+	GraphRecorderRef getGraphRecorder() const;
+
+	//! Called by \a node when it's connections have changed, default implementation recompiles the RenderGraph.
+	virtual void connectionsDidChange( const NodeRef &node );
 
 	//! Returns the samplerate of this Context, which is governed by the current NodeOutput.
 	size_t		getSampleRate()				{ return getOutput()->getOutputSampleRate(); }
@@ -78,48 +122,120 @@ class Context : public std::enable_shared_from_this<Context> {
 	uint64_t	getNumProcessedFrames()		{ return getOutput()->getNumProcessedFrames(); }
 	double		getNumProcessedSeconds()	{ return (double)getNumProcessedFrames() / (double)getSampleRate(); }
 
+	//! Returns the mutex that synchronizes changes to the Node graph made on non-audio threads. The audio thread never locks it, it only reads the published RenderGraph.
 	std::mutex& getMutex() const			{ return mMutex; }
 
 	void initializeNode( const NodeRef &node );
 	void uninitializeNode( const NodeRef &node );
 
-	//! Initialize all Node's related by this Context
+	//! Initialize all Node's related by this Context, then recompiles the RenderGraph.
 	void initializeAllNodes();
 	//! Uninitialize all Node's related by this Context
 	void uninitializeAllNodes();
 	//! Disconnect all Node's related by this Context
 	virtual void disconnectAllNodes();
 
-	//! Add \a node to the list of auto-pulled nodes, who will have their Node::pullInputs() method called after a LineOut implementation finishes pulling its inputs.
-	//! \note Callers on the non-audio thread must synchronize with getMutex().
+	//! Add \a node to the list of auto-pulled nodes, who will be processed after a LineOut implementation finishes pulling its inputs.
+	//! \note Synchronizes with getMutex(), so it must not already be locked by the caller.
 	void addAutoPulledNode( const NodeRef &node );
 	//! Remove \a node from the list of auto-pulled nodes.
-	//! \note Callers on the non-audio thread must synchronize with getMutex().
+	//! \note Synchronizes with getMutex(), so it must not already be locked by the caller.
 	void removeAutoPulledNode( const NodeRef &node );
 
-	//! Calls Node::pullInputs() for any Node's that have registered with addAutoPulledNode()
+	//! Processes the published RenderGraph, leaving the result in the NodeOutput's internal buffer. Never blocks.
+	//! \note Expected to be called on the audio thread by a NodeOutput implementation.
+	void processRenderGraph();
+	//! Processes any Node's that have registered with addAutoPulledNode(). Never blocks.
 	//! \note Expected to be called on the audio thread by a LineOut implementation at the end of its render loop.
 	void processAutoPulledNodes();
-
-	//! Prints the Node graph to console()
+	//! Compiles a new RenderGraph from the current Node connections and publishes it to the audio thread, which picks it up at the start of its next block.
+	//! The previous RenderGraph is retired. This is done automatically whenever connections change.
+	//! \note Synchronizes with getMutex(), so it must not already be locked by the caller.
+	void updateRenderGraph();
+	//! Defers updateRenderGraph() until a matching call to resumeRenderGraphUpdates(), so that many connection changes are published
+	//! to the audio thread at once. Calls can be nested. \see ScopedDeferredRenderGraphUpdates
+	//! \note If a Node in the published RenderGraph is uninitialized while updates are deferred, silence is rendered until they resume.
+	void deferRenderGraphUpdates();
+	//! Ends a call to deferRenderGraphUpdates(). Once no deferrals remain, the RenderGraph is updated if anything changed in the meantime.
+	void resumeRenderGraphUpdates();
+
+	//! Hands \a object to the housekeeping thread, which destroys it once the audio thread can no longer be using it. Call this after
+	//! replacing the pointer that the audio thread reads \a object from, for example when publishing a new RenderGraph. Never locks, and
+	//! \a object is never destroyed on the calling thread, so destructors that free memory or join threads stay off the audio thread.
+	//! \note Allocates a queue entry, so it must be called on a non-audio thread.
+	void retire( const std::shared_ptr<void> &object );
+	//! Destroys any retired objects that the audio thread is no longer using on the calling thread, rather than waiting for the housekeeping thread to.
+	void collectRetired();
+	//! Returns the number of retired objects that are still waiting for the audio thread.
+	size_t getNumRetired() const	{ return mNumRetired; }
+
+	//! Returns a description of the Buffer memory touched by the most recently compiled RenderGraph. \see RenderGraph::MemoryReport
+	RenderGraph::MemoryReport getMemoryReport() const;
+
+	//! Returns processing time statistics of each Node in the RenderGraph and of whole render cycles. Never locks, so it can be polled from any thread.
+	//! \note Node stats are empty unless compiled with CINDER_AUDIO_PROFILING defined, render cycles are always timed by the NodeOutput. \see ProcessProfile
+	ProfileSnapshot getProfileSnapshot() const;
+	//! Clears all processing times recorded so far. Never locks.
+	void resetProfile();
+	//! Returns how much of each block's deadline the NodeOutput spends rendering, compared to its CPU budget. Can be polled from any thread, the audio thread is never blocked.
+	//! \see NodeOutput::setCpuBudget()
+	CpuBudgetReport getCpuBudgetReport() const;
+
+	//! Prints the Node graph to console(), along with render cycle times and, if compiled with CINDER_AUDIO_PROFILING defined, Node processing times.
 	void printGraph();
 
   protected:
-	Context() : mEnabled( false ), mAutoPullRequired( false ), mAutoPullCacheDirty( false ) {}
+	Context();
 
-	const std::vector<Node *>& getAutoPulledNodes(); // called if there are any nodes besides output that need to be pulled
+	//! Called by \a node before it is uninitialized. If the published RenderGraph contains \a node, it is unpublished and this waits
+	//! for the audio thread to finish its current block, so that \a node can be reconfigured. Silence is rendered until updateRenderGraph() is called.
+	void suspendRenderGraph( const Node *node );
 
 	NodeOutputRef			mOutput;				// the 'heartbeat'
 
 	// other nodes that don't have any outputs and need to be explictly pulled
 	std::set<NodeRef>		mAutoPulledNodes;
-	std::vector<Node *>		mAutoPullCache;
-	bool					mAutoPullRequired, mAutoPullCacheDirty;
-	BufferDynamic			mAutoPullBuffer;
+
+	// flattened graph that is processed on the audio thread, recompiled and published whenever connections change
+	std::atomic<RenderGraph *>	mRenderGraph;
+	WorkerPoolRef				mWorkerPool;
+	RenderGraph::MemoryReport	mMemoryReport;
+
+	// incremented by the audio thread before and after it processes the RenderGraph, so it is odd while processing
+	std::atomic<uint64_t>		mRenderEpoch;
+	// number of non-audio threads reading the published RenderGraph, such as getProfileSnapshot(). Retired objects are kept while non-zero.
+	mutable std::atomic<size_t>	mNumRenderGraphReaders;
+
+	struct RetiredObject {
+		RetiredObject( uint64_t renderEpoch, const std::shared_ptr<void> &object ) : mRenderEpoch( renderEpoch ), mObject( object ), mNext( nullptr )	{}
+
+		uint64_t				mRenderEpoch;
+		std::shared_ptr<void>	mObject;
+		RetiredObject			*mNext;
+	};
+
+	// retire() pushes onto mRetiredHead without locking. collectRetired() takes the whole list at once and keeps the objects in
+	// mRetiredObjects until the audio thread has moved past the epoch they were retired in.
+	std::atomic<RetiredObject *>	mRetiredHead;
+	std::atomic<size_t>				mNumRetired;
+	std::vector<RetiredObject>		mRetiredObjects;
+	std::mutex						mRetiredMutex;
+
+	// set by the audio thread when a Node reaches its scheduled stop, the housekeeping thread then calls stop() on it.
+	std::atomic<bool>				mScheduledStopReached;
 
 	mutable std::mutex		mMutex;
 	bool					mEnabled;
 
+	// guarded by mMutex, see deferRenderGraphUpdates()
+	size_t					mNumDeferredUpdates;
+	bool					mRenderGraphUpdatePending;
+
+	// released rather than deleted in ~Context(), as Node's and Buffer's allocated from it may outlive the Context
+	MemoryPool				*mMemoryPool;
+	// only accessed with atomic_load() and atomic_store(), as edits made while mMutex is held also look it up
+	GraphRecorderRef		mGraphRecorder;
+
 	// TODO: if this is singleton, why hold in shared_ptr?
 	// - it's still stored in Node classes as a weak_ptr, so it needs to (for now) be created as a shared_ptr
 	static std::shared_ptr<Context>			sMasterContext;
@@ -127,22 +243,69 @@ class Context : public std::enable_shared_from_this<Context> {
 
 
   private:
+	// moves the retired objects that can be destroyed to \a destroyedObjects, so that the caller can destroy them without any lock held.
+	void collectRetired( std::vector<RetiredObject> *destroyedObjects );
+	// appends the Node's in the published RenderGraph whose scheduled stop the audio thread has reached to \a nodes.
+	void collectScheduledStops( std::vector<NodeRef> *nodes );
+	// shared by every Context, calls collectRetired() and collectScheduledStops() on each of them every kHousekeepingIntervalMs, or sooner after retire().
+	static void housekeepingLoop();
 	void disconnectRecursive( const NodeRef &node, std::set<NodeRef> &traversedNodes );
 	void initRecursisve( const NodeRef &node, std::set<NodeRef> &traversedNodes  );
 	void uninitRecursisve( const NodeRef &node, std::set<NodeRef> &traversedNodes  );
 
 	static void registerClearStatics();
+
+	friend class Node;
 };
 
 template<typename NodeT>
 std::shared_ptr<NodeT> Context::makeNode( NodeT *node )
 {
-	std::shared_ptr<NodeT> result( node );
+	std::shared_ptr<NodeT> result( node, std::default_delete<NodeT>(), MemoryPoolAllocator<NodeT>( mMemoryPool ) );
 	result->setContext( shared_from_this() );
 	return result;
 }
 
+template<typename NodeT>
+std::shared_ptr<NodeT> Context::makePooledNode()
+{
+	return makeNode( new( mMemoryPool ) NodeT() );
+}
+
+template<typename NodeT, typename A1>
+std::shared_ptr<NodeT> Context::makePooledNode( A1 &&a1 )
+{
+	return makeNode( new( mMemoryPool ) NodeT( std::forward<A1>( a1 ) ) );
+}
+
+template<typename NodeT, typename A1, typename A2>
+std::shared_ptr<NodeT> Context::makePooledNode( A1 &&a1, A2 &&a2 )
+{
+	return makeNode( new( mMemoryPool ) NodeT( std::forward<A1>( a1 ), std::forward<A2>( a2 ) ) );
+}
+
+template<typename NodeT, typename A1, typename A2, typename A3>
+std::shared_ptr<NodeT> Context::makePooledNode( A1 &&a1, A2 &&a2, A3 &&a3 )
+{
+	return makeNode( new( mMemoryPool ) NodeT( std::forward<A1>( a1 ), std::forward<A2>( a2 ), std::forward<A3>( a3 ) ) );
+}
+
 //! Returns the master \a Context that manages hardware I/O and real-time processing, which is platform specific. If none is available, returns \a null.
 inline Context* master()	{ return Context::master(); }
 
+//! RAII-style utility that defers updating \a context's RenderGraph while it is in scope. \see Context::deferRenderGraphUpdates()
+struct ScopedDeferredRenderGraphUpdates {
+	ScopedDeferredRenderGraphUpdates( Context *context )
+		: mContext( context )
+	{
+		mContext->deferRenderGraphUpdates();
+	}
+	~ScopedDeferredRenderGraphUpdates()
+	{
+		mContext->resumeRenderGraphUpdates();
+	}
+  private:
+	Context *mContext;
+};
+
 } } // namespace cinder::audio2
\ No newline at end of file
@@ -0,0 +1,185 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/audio2/ContextNull.h"
+#include "cinder/audio2/Utilities.h"
+
+#include <chrono>
+
+using namespace std;
+
+namespace cinder { namespace audio2 {
+
+// ----------------------------------------------------------------------------------------------------
+// MARK: - LineOutNull
+// ----------------------------------------------------------------------------------------------------
+
+LineOutNull::LineOutNull( const DeviceRef &device, const Format &format )
+	: LineOut( device, format ), mFreeRunEnabled( false )
+{
+}
+
+LineOutNull::~LineOutNull()
+{
+	stopRenderThread();
+}
+
+void LineOutNull::initialize()
+{
+	// the rendered block is always read from the internal buffer, so force one to be made.
+	setupProcessWithSumming();
+}
+
+void LineOutNull::uninitialize()
+{
+	stopRenderThread();
+	mEnabled = false;
+}
+
+void LineOutNull::start()
+{
+	if( mEnabled || ! mInitialized )
+		return;
+
+	mEnabled = true;
+	mRenderThreadRunning = make_shared<atomic<bool> >( true );
+	mRenderThread = thread( bind( &LineOutNull::renderLoop, this, mRenderThreadRunning ) );
+}
+
+void LineOutNull::stop()
+{
+	if( ! mEnabled || ! mInitialized )
+		return;
+
+	stopRenderThread();
+	mEnabled = false;
+}
+
+void LineOutNull::stopRenderThread()
+{
+	if( ! mRenderThread.joinable() )
+		return;
+
+	*mRenderThreadRunning = false;
+
+	// if the render thread released the last reference to the Context, this is called from it while the Context is destroyed.
+	if( mRenderThread.get_id() == this_thread::get_id() )
+		mRenderThread.detach();
+	else
+		mRenderThread.join();
+}
+
+// The running flag is owned by the thread rather than this LineOutNull, as rendering a block destroys it if the render thread
+// held the last reference to the Context. In that case the flag is cleared and the loop exits without touching any members.
+void LineOutNull::renderLoop( shared_ptr<atomic<bool> > running )
+{
+	increaseThreadPriority();
+
+	typedef chrono::steady_clock Clock;
+	Clock::time_point startTime = Clock::now();
+	uint64_t numFramesSinceStart = 0;
+
+	while( *running ) {
+		size_t sampleRate = getOutputSampleRate();
+		size_t framesPerBlock = getOutputFramesPerBlock();
+
+		renderInputs();
+
+		if( ! *running )
+			break;
+
+		if( mFreeRunEnabled ) {
+			startTime = Clock::now();
+			numFramesSinceStart = 0;
+			continue;
+		}
+
+		// deadlines are measured from the start time rather than the last block, so that rounding errors don't accumulate.
+		numFramesSinceStart += framesPerBlock;
+		Clock::duration blockDuration = chrono::duration_cast<Clock::duration>( chrono::duration<double>( double( framesPerBlock ) / double( sampleRate ) ) );
+		Clock::time_point deadline = startTime + chrono::duration_cast<Clock::duration>( chrono::duration<double>( double( numFramesSinceStart ) / double( sampleRate ) ) );
+
+		// if rendering has fallen more than a block behind, pacing restarts from now rather than rendering a burst of blocks to catch up.
+		Clock::time_point now = Clock::now();
+		if( now > deadline + blockDuration ) {
+			startTime = now;
+			numFramesSinceStart = 0;
+			continue;
+		}
+
+		this_thread::sleep_until( deadline );
+	}
+}
+
+void LineOutNull::renderInputs()
+{
+	// holding a reference keeps the Context alive while rendering
+	auto ctx = getContext();
+	if( ! ctx )
+		return;
+
+	mInternalBuffer.zero();
+	processGraph();
+
+	if( checkNotClipping() )
+		mInternalBuffer.zero();
+
+	postProcess();
+}
+
+// ----------------------------------------------------------------------------------------------------
+// MARK: - LineInNull
+// ----------------------------------------------------------------------------------------------------
+
+LineInNull::LineInNull( const DeviceRef &device, const Format &format )
+	: LineIn( device, format )
+{
+}
+
+void LineInNull::process( Buffer *buffer )
+{
+	buffer->zero();
+	setSilent();
+}
+
+// ----------------------------------------------------------------------------------------------------
+// MARK: - ContextNull
+// ----------------------------------------------------------------------------------------------------
+
+// static
+ContextNullRef ContextNull::create()
+{
+	return ContextNullRef( new ContextNull );
+}
+
+LineOutRef ContextNull::createLineOut( const DeviceRef &device, const Node::Format &format )
+{
+	return makeNode( new LineOutNull( device, format ) );
+}
+
+LineInRef ContextNull::createLineIn( const DeviceRef &device, const Node::Format &format )
+{
+	return makeNode( new LineInNull( device, format ) );
+}
+
+} } // namespace cinder::audio2
@@ -0,0 +1,92 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/audio2/Context.h"
+
+#include <thread>
+
+namespace cinder { namespace audio2 {
+
+typedef std::shared_ptr<class ContextNull>		ContextNullRef;
+typedef std::shared_ptr<class LineOutNull>		LineOutNullRef;
+
+//! \brief LineOut that isn't backed by any hardware. Instead, it renders its inputs on its own high priority thread.
+//!
+//! Blocks are paced with a monotonic clock at the Device's samplerate and frames per block, so that timing is faithful to real-time
+//! processing even on machines without an audio device. Alternatively, enableFreeRun() renders blocks as fast as possible.
+class LineOutNull : public LineOut {
+  public:
+	LineOutNull( const DeviceRef &device, const Format &format = Format() );
+	virtual ~LineOutNull();
+
+	void start() override;
+	void stop() override;
+
+	//! Sets whether blocks are rendered as fast as possible, rather than paced in real-time. Disabled by default.
+	void enableFreeRun( bool enable = true )	{ mFreeRunEnabled = enable; }
+	//! Returns whether blocks are rendered as fast as possible, rather than paced in real-time.
+	bool isFreeRunEnabled() const				{ return mFreeRunEnabled; }
+
+  protected:
+	void initialize()				override;
+	void uninitialize()				override;
+
+  private:
+	void renderLoop( std::shared_ptr<std::atomic<bool> > running );
+	void renderInputs();
+	void stopRenderThread();
+
+	std::thread							mRenderThread;
+	std::shared_ptr<std::atomic<bool> >	mRenderThreadRunning;
+	std::atomic<bool>					mFreeRunEnabled;
+};
+
+//! LineIn that isn't backed by any hardware, it always produces silence.
+class LineInNull : public LineIn {
+  public:
+	LineInNull( const DeviceRef &device, const Format &format = Format() );
+	virtual ~LineInNull() {}
+
+  protected:
+	void process( Buffer *buffer )	override;
+};
+
+//! \brief Context for machines without audio hardware, such as headless servers or CI machines. Its LineOut renders on a timer thread.
+//!
+//! This is the master Context on platforms without a native audio backend. It can also be installed explicitly:
+//! \code
+//! audio2::Context::setMaster( new audio2::ContextNull, new audio2::DeviceManagerNull );
+//! \endcode
+//! Any number of independent ContextNull's can be made with create(), each with its own graph and render thread, for example one per session in a server.
+class ContextNull : public Context {
+  public:
+	//! Returns a new ContextNull that is independent of the master Context.
+	static ContextNullRef create();
+
+	LineOutRef	createLineOut( const DeviceRef &device, const Node::Format &format = Node::Format() ) override;
+	LineInRef	createLineIn( const DeviceRef &device, const Node::Format &format = Node::Format() ) override;
+};
+
+} } // namespace cinder::audio2
@@ -0,0 +1,240 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/audio2/ContextOffline.h"
+#include "cinder/audio2/Target.h"
+#include "cinder/audio2/Exception.h"
+#include "cinder/audio2/Debug.h"
+
+#include <chrono>
+
+using namespace std;
+
+namespace cinder { namespace audio2 {
+
+// ----------------------------------------------------------------------------------------------------
+// MARK: - NodeOutputOffline
+// ----------------------------------------------------------------------------------------------------
+
+NodeOutputOffline::NodeOutputOffline( size_t sampleRate, size_t framesPerBlock, const Format &format )
+	: NodeOutput( format ), mSampleRate( sampleRate ), mFramesPerBlock( framesPerBlock )
+{
+	CI_ASSERT( mSampleRate && mFramesPerBlock );
+
+	if( mChannelMode != ChannelMode::SPECIFIED ) {
+		mChannelMode = ChannelMode::SPECIFIED;
+		setNumChannels( 2 );
+	}
+}
+
+void NodeOutputOffline::initialize()
+{
+	// the rendered block is always read from the internal buffer, so force one to be made.
+	setupProcessWithSumming();
+}
+
+void NodeOutputOffline::renderBlock()
+{
+	mInternalBuffer.zero();
+	processGraph();
+
+	if( checkNotClipping() )
+		mInternalBuffer.zero();
+
+	postProcess();
+}
+
+// ----------------------------------------------------------------------------------------------------
+// MARK: - ContextOffline
+// ----------------------------------------------------------------------------------------------------
+
+// static
+ContextOfflineRef ContextOffline::create( size_t sampleRate, size_t framesPerBlock, size_t numChannels )
+{
+	return ContextOfflineRef( new ContextOffline( sampleRate, framesPerBlock, numChannels ) );
+}
+
+ContextOffline::ContextOffline( size_t sampleRate, size_t framesPerBlock, size_t numChannels )
+	: Context(), mSampleRate( sampleRate ), mFramesPerBlock( framesPerBlock ), mNumChannels( numChannels )
+{
+}
+
+ContextOffline::~ContextOffline()
+{
+}
+
+LineOutRef ContextOffline::createLineOut( const DeviceRef &device, const Node::Format &format )
+{
+	throw AudioContextExc( "ContextOffline does not support hardware output." );
+}
+
+LineInRef ContextOffline::createLineIn( const DeviceRef &device, const Node::Format &format )
+{
+	throw AudioContextExc( "ContextOffline does not support hardware input." );
+}
+
+const NodeOutputRef& ContextOffline::getOutput()
+{
+	if( ! mOutput )
+		mOutput = makeNode( new NodeOutputOffline( mSampleRate, mFramesPerBlock, Node::Format().channels( mNumChannels ) ) );
+
+	return mOutput;
+}
+
+void ContextOffline::render( Buffer *buffer )
+{
+	NodeOutputOffline *output = getOutputOffline();
+	if( buffer->getNumChannels() != output->getNumChannels() )
+		throw AudioFormatExc( string( "Buffer has " ) + to_string( buffer->getNumChannels() ) + " channels, expected " + to_string( output->getNumChannels() ) + "." );
+
+	start();
+
+	const size_t numFrames = buffer->getNumFrames();
+	size_t writeFrame = 0;
+	while( writeFrame < numFrames ) {
+		output->renderBlock();
+
+		size_t numCopyFrames = min( mFramesPerBlock, numFrames - writeFrame );
+		buffer->copyOffset( output->mInternalBuffer, numCopyFrames, writeFrame, 0 );
+		writeFrame += numCopyFrames;
+	}
+}
+
+void ContextOffline::render( TargetFile *targetFile, size_t numFrames )
+{
+	CI_ASSERT( targetFile );
+
+	NodeOutputOffline *output = getOutputOffline();
+	start();
+
+	size_t writeFrame = 0;
+	while( writeFrame < numFrames ) {
+		output->renderBlock();
+
+		size_t numWriteFrames = min( mFramesPerBlock, numFrames - writeFrame );
+		targetFile->write( &output->mInternalBuffer, 0, numWriteFrames );
+		writeFrame += numWriteFrames;
+	}
+}
+
+NodeOutputOffline* ContextOffline::getOutputOffline()
+{
+	auto output = dynamic_cast<NodeOutputOffline *>( getOutput().get() );
+	if( ! output )
+		throw AudioContextExc( "ContextOffline can only render with a NodeOutputOffline." );
+
+	return output;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// MARK: - BatchRender
+// ----------------------------------------------------------------------------------------------------
+
+BatchRender::BatchRender( const WorkerPoolRef &workerPool )
+	: mWorkerPool( workerPool )
+{
+	// the thread that calls render() also renders jobs, so the pool has one less thread than the hardware.
+	if( ! mWorkerPool )
+		mWorkerPool = make_shared<WorkerPool>( WorkerPool::Options().realtime( false ) );
+	else if( mWorkerPool->isRealtime() )
+		throw AudioExc( "BatchRender requires a WorkerPool that isn't realtime." );
+}
+
+size_t BatchRender::addJob( const Job &job )
+{
+	mJobs.push_back( JobState( job ) );
+	return mJobs.size() - 1;
+}
+
+void BatchRender::render()
+{
+	vector<JobState *> pendingJobs;
+	for( auto &state : mJobs ) {
+		if( ! state.mRendered )
+			pendingJobs.push_back( &state );
+	}
+
+	const size_t numJobs = pendingJobs.size();
+	size_t numCompleted = 0;
+	mutex progressMutex;
+
+	auto beginTime = chrono::steady_clock::now();
+
+	mWorkerPool->run( numJobs, [&]( size_t task ) {
+		JobState *state = pendingJobs[task];
+		try {
+			renderJob( state );
+		}
+		catch( ... ) {
+			state->mException = current_exception();
+		}
+
+		lock_guard<mutex> lock( progressMutex );
+		numCompleted++;
+		if( mProgressFn )
+			mProgressFn( numCompleted, numJobs );
+	} );
+
+	mStats.mElapsedSeconds += chrono::duration<double>( chrono::steady_clock::now() - beginTime ).count();
+
+	exception_ptr firstException;
+	for( JobState *state : pendingJobs ) {
+		state->mRendered = true;
+		if( state->mException ) {
+			if( ! firstException )
+				firstException = state->mException;
+			continue;
+		}
+
+		const Job &job = state->mJob;
+		mStats.mNumJobs++;
+		mStats.mNumFrames += job.getNumFrames();
+		mStats.mRenderedSeconds += double( job.getNumFrames() ) / double( job.getSampleRate() );
+	}
+
+	if( firstException )
+		rethrow_exception( firstException );
+}
+
+// static
+void BatchRender::renderJob( JobState *state )
+{
+	const Job &job = state->mJob;
+
+	auto ctx = ContextOffline::create( job.getSampleRate(), job.getFramesPerBlock(), job.getNumChannels() );
+	job.getGraphFn()( ctx );
+
+	if( job.getTargetPath().empty() ) {
+		state->mBuffer = make_shared<Buffer>( job.getNumFrames(), job.getNumChannels() );
+		ctx->render( state->mBuffer.get() );
+	}
+	else {
+		auto targetFile = TargetFile::create( job.getTargetPath(), job.getSampleRate(), job.getNumChannels(), job.getTargetExtension() );
+		if( ! targetFile )
+			throw AudioFileExc( "Could not create TargetFile for " + job.getTargetPath().string() + "." );
+
+		ctx->render( targetFile.get(), job.getNumFrames() );
+	}
+}
+
+} } // namespace cinder::audio2
@@ -0,0 +1,210 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/audio2/Context.h"
+
+#include "cinder/Cinder.h"
+
+#include <exception>
+#include <functional>
+
+namespace cinder { namespace audio2 {
+
+class TargetFile;
+
+typedef std::shared_ptr<class ContextOffline>		ContextOfflineRef;
+typedef std::shared_ptr<class NodeOutputOffline>	NodeOutputOfflineRef;
+
+//! NodeOutput that is not attached to any hardware Device. Instead of being driven by an audio callback, its owning ContextOffline pulls it one block at a time.
+class NodeOutputOffline : public NodeOutput {
+  public:
+	NodeOutputOffline( size_t sampleRate, size_t framesPerBlock, const Format &format = Format() );
+	virtual ~NodeOutputOffline() {}
+
+	size_t getOutputSampleRate() override			{ return mSampleRate; }
+	size_t getOutputFramesPerBlock() override		{ return mFramesPerBlock; }
+
+  protected:
+	void initialize() override;
+
+  private:
+	//! Pulls one block of audio through the graph, after which it is available in the internal buffer.
+	void renderBlock();
+
+	size_t mSampleRate, mFramesPerBlock;
+
+	friend class ContextOffline;
+};
+
+//! \brief Context that renders its graph as fast as possible on the calling thread, rather than in real-time with an audio device.
+//!
+//! Useful for rendering to files or Buffers without a sound card, for example in batch jobs or tests. Audio is only processed during calls to render().
+//! \code
+//! auto ctx = audio2::ContextOffline::create( 44100 );
+//! auto sine = ctx->makeNode( new audio2::GenSine( 440, audio2::Node::Format().autoEnable() ) );
+//! sine >> ctx->getOutput();
+//!
+//! audio2::Buffer buffer( 44100, ctx->getOutput()->getNumChannels() );
+//! ctx->render( &buffer );
+//! \endcode
+class ContextOffline : public Context {
+  public:
+	//! Returns a new ContextOffline that processes \a framesPerBlock frames at a time and reports a samplerate of \a sampleRate. Its output has \a numChannels channels.
+	static ContextOfflineRef create( size_t sampleRate = 44100, size_t framesPerBlock = 512, size_t numChannels = 2 );
+
+	virtual ~ContextOffline();
+
+	//! Not supported, throws AudioContextExc.
+	LineOutRef	createLineOut( const DeviceRef &device, const Node::Format &format = Node::Format() ) override;
+	//! Not supported, throws AudioContextExc.
+	LineInRef	createLineIn( const DeviceRef &device, const Node::Format &format = Node::Format() ) override;
+
+	//! Returns the NodeOutputOffline that is pulled during render().
+	const NodeOutputRef& getOutput() override;
+
+	//! Renders \a buffer->getNumFrames() frames into \a buffer, whose channel count must match the output's. The Context is started if it isn't already enabled.
+	void render( Buffer *buffer );
+	//! Renders \a numFrames frames and writes them to \a targetFile, one block at a time. The Context is started if it isn't already enabled.
+	void render( TargetFile *targetFile, size_t numFrames );
+
+  protected:
+	ContextOffline( size_t sampleRate, size_t framesPerBlock, size_t numChannels );
+
+  private:
+	NodeOutputOffline* getOutputOffline();
+
+	size_t mSampleRate, mFramesPerBlock, mNumChannels;
+};
+
+//! Aggregate timing of the jobs rendered by a BatchRender, see BatchRender::getStats().
+struct BatchRenderStats {
+	BatchRenderStats() : mNumJobs( 0 ), mNumFrames( 0 ), mRenderedSeconds( 0 ), mElapsedSeconds( 0 )	{}
+
+	size_t		mNumJobs;			//!< Number of jobs rendered.
+	uint64_t	mNumFrames;			//!< Total number of frames rendered, across all jobs.
+	double		mRenderedSeconds;	//!< Total duration of the rendered audio, across all jobs.
+	double		mElapsedSeconds;	//!< Wall clock time spent in BatchRender::render().
+
+	//! Returns how many times faster than real-time the jobs were rendered, in aggregate.
+	double getRealtimeMultiple() const	{ return mElapsedSeconds > 0 ? mRenderedSeconds / mElapsedSeconds : 0; }
+};
+
+//! \brief Renders many independent graphs offline, in parallel on a WorkerPool.
+//!
+//! Each Job describes a graph with a function that builds it in a new ContextOffline, which is then rendered to a Buffer or a file.
+//! Useful for asset pipelines that render many short graphs, such as variations of a sound effect.
+//! \code
+//! audio2::BatchRender batch;
+//! for( size_t i = 0; i < 100; i++ ) {
+//! 	batch.addJob( audio2::BatchRender::Job( [i]( const audio2::ContextOfflineRef &ctx ) {
+//! 		ctx->makeNode( new audio2::GenSine( 220.0f + i * 10, audio2::Node::Format().autoEnable() ) ) >> ctx->getOutput();
+//! 	}, 44100 ) );
+//! }
+//!
+//! batch.render();
+//! audio2::BufferRef first = batch.getBuffer( 0 );
+//! \endcode
+class BatchRender {
+  public:
+	//! Called with the new ContextOffline a Job renders with, which should build the graph connected to its output.
+	typedef std::function<void ( const ContextOfflineRef &ctx )>			GraphFn;
+	//! Called after each job completes with the number of jobs completed so far in this render() call, and the number that it renders.
+	typedef std::function<void ( size_t numCompleted, size_t numJobs )>	ProgressFn;
+
+	//! Description of one graph and where to render it.
+	class Job {
+	  public:
+		//! Creates a Job that builds its graph with \a graphFn and renders \a numFrames frames.
+		Job( const GraphFn &graphFn, size_t numFrames )
+			: mGraphFn( graphFn ), mNumFrames( numFrames ), mSampleRate( 44100 ), mFramesPerBlock( 512 ), mNumChannels( 2 )
+		{}
+
+		//! Sets the samplerate the graph is rendered at. Default is 44100.
+		Job& sampleRate( size_t sampleRate )		{ mSampleRate = sampleRate; return *this; }
+		//! Sets the number of frames rendered in each block. Default is 512.
+		Job& framesPerBlock( size_t frames )		{ mFramesPerBlock = frames; return *this; }
+		//! Sets the number of channels of the output. Default is 2.
+		Job& channels( size_t numChannels )			{ mNumChannels = numChannels; return *this; }
+		//! Renders to the file at \a path rather than a Buffer. The file is created when the Job is rendered. \see TargetFile::create()
+		Job& target( const fs::path &path, const std::string &extension = "" )	{ mTargetPath = path; mTargetExtension = extension; return *this; }
+
+		const GraphFn&		getGraphFn() const			{ return mGraphFn; }
+		size_t				getNumFrames() const		{ return mNumFrames; }
+		size_t				getSampleRate() const		{ return mSampleRate; }
+		size_t				getFramesPerBlock() const	{ return mFramesPerBlock; }
+		size_t				getNumChannels() const		{ return mNumChannels; }
+		const fs::path&		getTargetPath() const		{ return mTargetPath; }
+		const std::string&	getTargetExtension() const	{ return mTargetExtension; }
+
+	  private:
+		GraphFn		mGraphFn;
+		size_t		mNumFrames, mSampleRate, mFramesPerBlock, mNumChannels;
+		fs::path	mTargetPath;
+		std::string	mTargetExtension;
+	};
+
+	//! Creates a BatchRender that renders on \a workerPool. If it is null, a non-realtime WorkerPool using all hardware threads is created.
+	//! A batch can take minutes, so \a workerPool must not be realtime (see WorkerPool::Options::realtime()), otherwise AudioExc is thrown.
+	//! This also rules out sharing the realtime pool of a running Context, whose parallel processing would fall back to serial for as
+	//! long as render() holds the pool.
+	//! \note If \a workerPool is busy when render() is called, the jobs render on the calling thread.
+	BatchRender( const WorkerPoolRef &workerPool = WorkerPoolRef() );
+
+	//! Adds \a job to the batch, returning its index.
+	size_t addJob( const Job &job );
+	//! Returns the number of jobs that have been added.
+	size_t getNumJobs() const	{ return mJobs.size(); }
+
+	//! Sets a function that is called after each job completes. It is called from the thread that rendered the job, but never concurrently.
+	void setProgressFn( const ProgressFn &progressFn )	{ mProgressFn = progressFn; }
+
+	//! Renders all jobs that haven't been rendered yet in parallel, returning once they have completed.
+	//! If any job throws, the remaining jobs are still rendered and then the first exception is rethrown.
+	void render();
+
+	//! Returns the Buffer that job \a index was rendered into, or null if it renders to a file or hasn't been rendered.
+	const BufferRef& getBuffer( size_t index ) const	{ return mJobs.at( index ).mBuffer; }
+	//! Returns the aggregate timing of all jobs rendered so far.
+	const BatchRenderStats& getStats() const			{ return mStats; }
+
+  private:
+	struct JobState {
+		JobState( const Job &job ) : mJob( job ), mRendered( false )	{}
+
+		Job					mJob;
+		BufferRef			mBuffer;
+		bool				mRendered;
+		std::exception_ptr	mException;
+	};
+
+	static void renderJob( JobState *state );
+
+	std::vector<JobState>	mJobs;
+	WorkerPoolRef			mWorkerPool;
+	ProgressFn				mProgressFn;
+	BatchRenderStats		mStats;
+};
+
+} } // namespace cinder::audio2
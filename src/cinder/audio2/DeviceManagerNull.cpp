@@ -0,0 +1,97 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/audio2/DeviceManagerNull.h"
+#include "cinder/audio2/CinderAssert.h"
+
+using namespace std;
+
+namespace cinder { namespace audio2 {
+
+namespace {
+
+const string kNullDeviceKey = "null";
+const string kNullDeviceName = "Null Device";
+const size_t kNumChannels = 2;
+
+} // anonymous namespace
+
+DeviceManagerNull::DeviceManagerNull()
+	: mSampleRate( 44100 ), mFramesPerBlock( 512 )
+{
+	addDevice( kNullDeviceKey );
+}
+
+DeviceRef DeviceManagerNull::getDefaultOutput()
+{
+	return mDevices.front();
+}
+
+DeviceRef DeviceManagerNull::getDefaultInput()
+{
+	return mDevices.front();
+}
+
+const vector<DeviceRef>& DeviceManagerNull::getDevices()
+{
+	return mDevices;
+}
+
+string DeviceManagerNull::getName( const DeviceRef &device )
+{
+	return kNullDeviceName;
+}
+
+size_t DeviceManagerNull::getNumInputChannels( const DeviceRef &device )
+{
+	return kNumChannels;
+}
+
+size_t DeviceManagerNull::getNumOutputChannels( const DeviceRef &device )
+{
+	return kNumChannels;
+}
+
+size_t DeviceManagerNull::getSampleRate( const DeviceRef &device )
+{
+	return mSampleRate;
+}
+
+size_t DeviceManagerNull::getFramesPerBlock( const DeviceRef &device )
+{
+	return mFramesPerBlock;
+}
+
+void DeviceManagerNull::setSampleRate( const DeviceRef &device, size_t sampleRate )
+{
+	CI_ASSERT( sampleRate );
+	mSampleRate = sampleRate;
+}
+
+void DeviceManagerNull::setFramesPerBlock( const DeviceRef &device, size_t framesPerBlock )
+{
+	CI_ASSERT( framesPerBlock );
+	mFramesPerBlock = framesPerBlock;
+}
+
+} } // namespace cinder::audio2
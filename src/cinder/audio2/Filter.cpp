@@ -98,6 +98,27 @@ void FilterBiquad::updateBiquadParams()
 		default:
 			break;
 	}
+
+	updateTailFrames( normalizedFrequency );
+}
+
+// The filter rings at its slowest decaying pole, which for a resonance of Q above 0.5 decays at a rate of w0 / 2Q per sample, where
+// w0 = pi * normalizedFrequency. Below 0.5 the poles are real and the slower one decays at w0 ( 1 / 2Q - sqrt( 1 / 4Q^2 - 1 ) ).
+void FilterBiquad::updateTailFrames( double normalizedFrequency )
+{
+	if( mMode == Mode::CUSTOM ) {
+		mTailFrames = TAIL_INFINITE;
+		return;
+	}
+
+	// the shelving filters don't use Q and are designed with a fixed slope.
+	double q = ( mMode == Mode::LOWSHELF || mMode == Mode::HIGHSHELF ) ? math<double>::sqrt( 0.5 ) : math<double>::max( mQ, 0.001 );
+	double w0 = M_PI * math<double>::clamp( normalizedFrequency, 0.0001, 1 );
+	double decayRate = ( q > 0.5 ) ? w0 / ( 2 * q ) : w0 * ( 1 / ( 2 * q ) - math<double>::sqrt( 1 / ( 4 * q * q ) - 1 ) );
+
+	// number of time constants to decay by 120 dB, ln( 10^6 )
+	const double kDecayTimeConstants = 13.8155;
+	mTailFrames = size_t( kDecayTimeConstants / decayRate ) + 1;
 }
 
 
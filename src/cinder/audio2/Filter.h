@@ -43,7 +43,7 @@ class FilterBiquad : public NodeEffect {
   public:
 	enum Mode { LOWPASS, HIGHPASS, BANDPASS, LOWSHELF, HIGHSHELF, PEAKING, ALLPASS, NOTCH, CUSTOM };
 
-	FilterBiquad( Mode mode = LOWPASS, const Format &format = Format() ) : NodeEffect( format ), mMode( mode ), mCoeffsDirty( true ), mFreq( 200.0f ), mQ( 1.0f ), mGain( 0.0f ) {}
+	FilterBiquad( Mode mode = LOWPASS, const Format &format = Format() ) : NodeEffect( format ), mMode( mode ), mCoeffsDirty( true ), mFreq( 200.0f ), mQ( 1.0f ), mGain( 0.0f ), mTailFrames( TAIL_INFINITE ) {}
 	virtual ~FilterBiquad() {}
 
 	void setMode( Mode mode )	{ mMode = mode; mCoeffsDirty = true; }
@@ -58,12 +58,16 @@ class FilterBiquad : public NodeEffect {
 	void setGain( float gain )	{ mGain = gain; mCoeffsDirty = true; }
 	float getGain() const		{ return mGain; }
 
+	//! Returns the number of frames it takes for the filter's ringing to decay by 120 dB, which is estimated from the current mode, frequency and Q.
+	size_t getTailFrames() const override	{ return mTailFrames; }
+
   protected:
 	void initialize()				override;
 	void uninitialize()				override;
 	void process( Buffer *buffer )	override;
 
 	void updateBiquadParams();
+	void updateTailFrames( double normalizedFrequency );
 
 	std::vector<dsp::Biquad> mBiquads;
 	std::atomic<bool> mCoeffsDirty;
@@ -72,6 +76,7 @@ class FilterBiquad : public NodeEffect {
 
 	Mode mMode;
 	float mFreq, mQ, mGain;
+	size_t mTailFrames;
 };
 
 class FilterLowPass : public FilterBiquad {
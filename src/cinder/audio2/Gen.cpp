@@ -242,7 +242,7 @@ void GenOscillator::setWaveform( WaveformType type )
 	if( mWaveformType == type )
 		return;
 
-	// TODO: to prevent the entire graph from blocking, use our own lock and tryLock / fail when blocked in process()
+	// TODO: the audio thread may be reading the table while it is refilled, fill a new one and publish it instead.
 	lock_guard<mutex> lock( getContext()->getMutex() );
 
 	mWaveformType = type;
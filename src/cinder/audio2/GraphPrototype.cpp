@@ -0,0 +1,160 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/audio2/GraphPrototype.h"
+#include "cinder/audio2/Context.h"
+#include "cinder/audio2/GraphRecorder.h"
+#include "cinder/audio2/Exception.h"
+#include "cinder/audio2/Debug.h"
+
+#include <algorithm>
+#include <string>
+
+using namespace std;
+
+namespace cinder { namespace audio2 {
+
+GraphPrototype::GraphPrototype()
+	: mOutputNode( 0 ), mOutputNodeSet( false ), mResolved( false ), mResolvedOutputChannels( 0 )
+{
+}
+
+size_t GraphPrototype::addNode( const NodeFn &nodeFn )
+{
+	mNodeFns.push_back( nodeFn );
+	mResolved = false;
+
+	if( ! mOutputNodeSet )
+		mOutputNode = mNodeFns.size() - 1;
+
+	return mNodeFns.size() - 1;
+}
+
+void GraphPrototype::connect( size_t input, size_t output, size_t outputBus, size_t inputBus )
+{
+	if( input >= mNodeFns.size() || output >= mNodeFns.size() )
+		throw AudioExc( "GraphPrototype has no Node at index " + to_string( max( input, output ) ) + "." );
+
+	Connection connection = { input, output, outputBus, inputBus };
+	mConnections.push_back( connection );
+	mResolved = false;
+}
+
+void GraphPrototype::setOutputNode( size_t index )
+{
+	CI_ASSERT( index < mNodeFns.size() );
+
+	mOutputNode = index;
+	mOutputNodeSet = true;
+	mResolved = false;
+}
+
+vector<NodeRef> GraphPrototype::instantiate( const ContextRef &context, const NodeRef &output )
+{
+	vector<NodeRef> result = makeNodes( context );
+	if( result.empty() )
+		return result;
+
+	ScopedDeferredRenderGraphUpdates deferredUpdates( context.get() );
+
+	size_t outputChannels = output ? output->getNumChannels() : 0;
+	if( mResolved && outputChannels == mResolvedOutputChannels ) {
+		connectResolved( result, context );
+		if( output )
+			result[mOutputNode]->addConnection( output );
+	}
+	else
+		connectAndResolve( result, output );
+
+	return result;
+}
+
+vector<NodeRef> GraphPrototype::makeNodes( const ContextRef &context ) const
+{
+	vector<NodeRef> result;
+	result.reserve( mNodeFns.size() );
+
+	for( const auto &nodeFn : mNodeFns )
+		result.push_back( context->makeNode( nodeFn() ) );
+
+	return result;
+}
+
+void GraphPrototype::connectAndResolve( const vector<NodeRef> &nodes, const NodeRef &output )
+{
+	for( const auto &connection : mConnections )
+		nodes[connection.mInput]->connect( nodes[connection.mOutput], connection.mOutputBus, connection.mInputBus );
+
+	if( output )
+		nodes[mOutputNode]->addConnection( output );
+
+	// Node's that aren't anyone's input, such as the output Node when there is no output, still need to be initialized.
+	for( const auto &node : nodes )
+		node->initializeImpl();
+
+	// auto-pulled Node's change how they are pulled when connected, so they always go through connect().
+	bool resolvable = true;
+	mNodeConfigs.resize( nodes.size() );
+	for( size_t i = 0; i < nodes.size(); i++ ) {
+		mNodeConfigs[i].mNumChannels = nodes[i]->getNumChannels();
+		mNodeConfigs[i].mProcessInPlace = nodes[i]->getProcessInPlace();
+
+		if( dynamic_cast<NodeAutoPullable *>( nodes[i].get() ) )
+			resolvable = false;
+	}
+
+	mResolved = resolvable;
+	mResolvedOutputChannels = output ? output->getNumChannels() : 0;
+}
+
+void GraphPrototype::connectResolved( const vector<NodeRef> &nodes, const ContextRef &context )
+{
+	// the connections are made without Node::connect(), so they are recorded here.
+	for( const auto &connection : mConnections ) {
+		ScopedGraphEdit edit( context, GraphEdit::connect( nodes[connection.mInput].get(), nodes[connection.mOutput].get(), connection.mOutputBus, connection.mInputBus ) );
+	}
+
+	lock_guard<mutex> lock( context->getMutex() );
+
+	for( size_t i = 0; i < nodes.size(); i++ ) {
+		if( nodes[i]->getNumChannels() != mNodeConfigs[i].mNumChannels )
+			nodes[i]->setNumChannels( mNodeConfigs[i].mNumChannels );
+	}
+
+	for( const auto &connection : mConnections ) {
+		const NodeRef &input = nodes[connection.mInput];
+		const NodeRef &output = nodes[connection.mOutput];
+
+		input->mOutputs[connection.mOutputBus] = output;
+		output->mInputs[connection.mInputBus] = input;
+	}
+
+	for( size_t i = 0; i < nodes.size(); i++ ) {
+		if( ! mNodeConfigs[i].mProcessInPlace )
+			nodes[i]->setupProcessWithSumming();
+
+		nodes[i]->initializeImpl();
+	}
+}
+
+} } // namespace cinder::audio2
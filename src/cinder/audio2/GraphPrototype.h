@@ -0,0 +1,98 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/audio2/Node.h"
+
+#include <functional>
+#include <vector>
+
+namespace cinder { namespace audio2 {
+
+typedef std::shared_ptr<class GraphPrototype>	GraphPrototypeRef;
+
+//! \brief Description of a sub-graph of Node's that can be instantiated many times, for example one per voice.
+//!
+//! Node's are added as functions that construct them, along with the connections between them. The first instantiate() builds the
+//! sub-graph with the usual connect() calls and records how it was configured: the channel count of each Node and whether it processes
+//! in-place. Later instantiations restore that configuration directly, sizing each Node's buffers once and connecting them under a single
+//! lock of the Context's mutex, and the new Node's are published to the audio thread with one RenderGraph update.
+//! \code
+//! auto voice = make_shared<audio2::GraphPrototype>();
+//! size_t gen = voice->addNode( [] { return new audio2::GenPulse( 110, audio2::Node::Format().autoEnable() ); } );
+//! size_t filter = voice->addNode( [] { return new audio2::FilterLowPass; } );
+//! voice->connect( gen, filter );
+//!
+//! for( size_t i = 0; i < 200; i++ )
+//! 	voices.push_back( voice->instantiate( ctx, mixer ) );
+//! \endcode
+class GraphPrototype {
+  public:
+	//! Returns a new Node for the prototype, which becomes owned by the Context it is instantiated in.
+	typedef std::function<Node* ()>	NodeFn;
+
+	GraphPrototype();
+
+	//! Adds a Node constructed by \a nodeFn, returning its index.
+	size_t addNode( const NodeFn &nodeFn );
+	//! Connects the Node at index \a input to the Node at index \a output, with the same meaning of \a outputBus and \a inputBus as Node::connect().
+	void connect( size_t input, size_t output, size_t outputBus = 0, size_t inputBus = 0 );
+	//! Sets the index of the Node that instantiate() connects to its output. Default is the last Node added.
+	void setOutputNode( size_t index );
+
+	//! Returns the number of Node's in the prototype.
+	size_t getNumNodes() const		{ return mNodeFns.size(); }
+	//! Returns whether the configuration of the sub-graph has been recorded, so that instantiate() can skip configuring connections.
+	bool isResolved() const			{ return mResolved; }
+
+	//! Creates the Node's in \a context, connects them and connects the output Node to the first available input of \a output, if it isn't null.
+	//! Returns the new Node's, in the order they were added. The RenderGraph is updated once, after all connections have been made.
+	std::vector<NodeRef> instantiate( const ContextRef &context, const NodeRef &output = NodeRef() );
+
+  private:
+	struct Connection {
+		size_t mInput, mOutput, mOutputBus, mInputBus;
+	};
+
+	struct NodeConfig {
+		size_t	mNumChannels;
+		bool	mProcessInPlace;
+	};
+
+	std::vector<NodeRef> makeNodes( const ContextRef &context ) const;
+	void connectAndResolve( const std::vector<NodeRef> &nodes, const NodeRef &output );
+	void connectResolved( const std::vector<NodeRef> &nodes, const ContextRef &context );
+
+	std::vector<NodeFn>		mNodeFns;
+	std::vector<Connection>	mConnections;
+	size_t					mOutputNode;
+	bool					mOutputNodeSet;
+
+	// configuration recorded by the first instantiate(), which is only reused for outputs with the same channel count.
+	bool					mResolved;
+	std::vector<NodeConfig>	mNodeConfigs;
+	size_t					mResolvedOutputChannels;
+};
+
+} } // namespace cinder::audio2
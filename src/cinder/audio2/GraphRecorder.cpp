@@ -0,0 +1,601 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/audio2/GraphRecorder.h"
+#include "cinder/audio2/ContextOffline.h"
+#include "cinder/audio2/Node.h"
+#include "cinder/audio2/Exception.h"
+#include "cinder/audio2/CinderAssert.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <iterator>
+
+using namespace std;
+
+namespace cinder { namespace audio2 {
+
+namespace {
+
+const char		kLogMagic[4]	= { 'A', '2', 'G', 'R' };
+const uint32_t	kLogVersion		= 2;
+
+typedef void (*RampFnPtr)( float *, size_t, float, float, const std::pair<float, float>& );
+
+GraphEdit::RampType getRampType( const RampFn &rampFn )
+{
+	const RampFnPtr *fn = rampFn.target<RampFnPtr>();
+	if( fn ) {
+		if( *fn == rampLinear )
+			return GraphEdit::RAMP_LINEAR;
+		if( *fn == rampInQuad )
+			return GraphEdit::RAMP_IN_QUAD;
+		if( *fn == rampOutQuad )
+			return GraphEdit::RAMP_OUT_QUAD;
+	}
+
+	return GraphEdit::RAMP_CUSTOM;
+}
+
+RampFn getRampFn( GraphEdit::RampType rampType )
+{
+	switch( rampType ) {
+		case GraphEdit::RAMP_IN_QUAD:	return rampInQuad;
+		case GraphEdit::RAMP_OUT_QUAD:	return rampOutQuad;
+		default:						return rampLinear;
+	}
+}
+
+// reads the values appended by GraphRecorder, throwing if the log ends early.
+class LogReader {
+  public:
+	LogReader( const vector<uint8_t> &data ) : mData( data ), mPos( 0 )	{}
+
+	bool isDone() const		{ return mPos == mData.size(); }
+
+	template <typename T>
+	T read()
+	{
+		T result;
+		readBytes( &result, sizeof( T ) );
+		return result;
+	}
+
+	string readString()
+	{
+		uint32_t length = read<uint32_t>();
+		string result( length, 0 );
+		if( length )
+			readBytes( &result[0], length );
+
+		return result;
+	}
+
+  private:
+	void readBytes( void *dest, size_t size )
+	{
+		if( mData.size() - mPos < size )
+			throw AudioExc( "GraphRecorder log is truncated." );
+
+		memcpy( dest, &mData[mPos], size );
+		mPos += size;
+	}
+
+	const vector<uint8_t>	&mData;
+	size_t					mPos;
+};
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------------------------------
+// MARK: - GraphEdit
+// ----------------------------------------------------------------------------------------------------
+
+GraphEdit::GraphEdit( Type type, Node *node )
+	: mType( type ), mNode( node ), mOtherNode( nullptr ), mParamIndex( 0 ), mOutputBus( 0 ), mInputBus( 0 ), mEnabled( false ), mWhen( 0 ),
+		mValueBegin( 0 ), mValueEnd( 0 ), mRampSeconds( 0 ), mDelay( 0 ), mRampType( RAMP_LINEAR )
+{
+}
+
+// static
+GraphEdit GraphEdit::connect( Node *input, Node *output, size_t outputBus, size_t inputBus )
+{
+	GraphEdit result( CONNECT, input );
+	result.mOtherNode = output;
+	result.mOutputBus = outputBus;
+	result.mInputBus = inputBus;
+	return result;
+}
+
+// static
+GraphEdit GraphEdit::disconnect( Node *node, size_t outputBus )
+{
+	GraphEdit result( DISCONNECT, node );
+	result.mOutputBus = outputBus;
+	return result;
+}
+
+// static
+GraphEdit GraphEdit::setEnabled( Node *node, bool enabled )
+{
+	GraphEdit result( SET_ENABLED, node );
+	result.mEnabled = enabled;
+	return result;
+}
+
+// static
+GraphEdit GraphEdit::startAt( Node *node, double when )
+{
+	GraphEdit result( START_AT, node );
+	result.mWhen = when;
+	return result;
+}
+
+// static
+GraphEdit GraphEdit::stopAt( Node *node, double when )
+{
+	GraphEdit result( STOP_AT, node );
+	result.mWhen = when;
+	return result;
+}
+
+// static
+GraphEdit GraphEdit::paramEdit( Type type, Node *parentNode, const Param *param )
+{
+	// every Param registers with its parent Node when it is constructed, so it is always found.
+	const vector<Param *> &params = parentNode->getParams();
+	size_t index = find( params.begin(), params.end(), param ) - params.begin();
+	CI_ASSERT_MSG( index < params.size(), "Param is not registered with its parent Node" );
+
+	GraphEdit result( type, parentNode );
+	result.mParamIndex = index;
+	return result;
+}
+
+// static
+GraphEdit GraphEdit::paramSetValue( Node *parentNode, const Param *param, float value )
+{
+	GraphEdit result = paramEdit( PARAM_SET_VALUE, parentNode, param );
+	result.mValueEnd = value;
+	return result;
+}
+
+// static
+GraphEdit GraphEdit::paramApplyRamp( Node *parentNode, const Param *param, float valueBegin, float valueEnd, float rampSeconds, const Param::Options &options )
+{
+	GraphEdit result = paramEdit( PARAM_APPLY_RAMP, parentNode, param );
+	result.mValueBegin = valueBegin;
+	result.mValueEnd = valueEnd;
+	result.mRampSeconds = rampSeconds;
+	result.mDelay = options.getDelay();
+	result.mRampType = getRampType( options.getRampFn() );
+	return result;
+}
+
+// static
+GraphEdit GraphEdit::paramAppendRamp( Node *parentNode, const Param *param, float valueEnd, float rampSeconds, const Param::Options &options )
+{
+	GraphEdit result = paramEdit( PARAM_APPEND_RAMP, parentNode, param );
+	result.mValueEnd = valueEnd;
+	result.mRampSeconds = rampSeconds;
+	result.mDelay = options.getDelay();
+	result.mRampType = getRampType( options.getRampFn() );
+	return result;
+}
+
+// static
+GraphEdit GraphEdit::paramSetProcessor( Node *parentNode, const Param *param, Node *processor )
+{
+	GraphEdit result = paramEdit( PARAM_SET_PROCESSOR, parentNode, param );
+	result.mOtherNode = processor;
+	return result;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// MARK: - GraphRecorder
+// ----------------------------------------------------------------------------------------------------
+
+GraphRecorder::GraphRecorder()
+	: mNumEdits( 0 ), mStartFrame( 0 ), mOutput( nullptr ), mNextNodeId( 1 )
+{
+}
+
+void GraphRecorder::begin( size_t sampleRate, size_t framesPerBlock, size_t numChannels, const Node *output, uint64_t startFrame )
+{
+	lock_guard<mutex> lock( mMutex );
+
+	mData.clear();
+	mNumEdits = 0;
+	mStartFrame = startFrame;
+	mOutput = output;
+	mNodeIds.clear();
+	mNextNodeId = 1;
+
+	mData.insert( mData.end(), kLogMagic, kLogMagic + sizeof( kLogMagic ) );
+	append( kLogVersion );
+	append( uint32_t( sampleRate ) );
+	append( uint32_t( framesPerBlock ) );
+	append( uint32_t( numChannels ) );
+}
+
+// Each entry is the frame it was recorded on, the type and the id of the Node it edits, followed by fields that depend on the type.
+void GraphRecorder::record( const GraphEdit &edit, uint64_t frame )
+{
+	lock_guard<mutex> lock( mMutex );
+
+	if( mData.empty() )
+		return; // begin() hasn't been called
+
+	frame = frame > mStartFrame ? frame - mStartFrame : 0;
+
+	uint32_t nodeId = getNodeId( edit.mNode, frame );
+	uint32_t otherNodeId = edit.mOtherNode ? getNodeId( edit.mOtherNode, frame ) : 0;
+
+	append( frame );
+	append( uint8_t( edit.mType ) );
+	append( nodeId );
+
+	switch( edit.mType ) {
+		case GraphEdit::CONNECT:
+			append( otherNodeId );
+			append( uint32_t( edit.mOutputBus ) );
+			append( uint32_t( edit.mInputBus ) );
+			break;
+		case GraphEdit::DISCONNECT:
+			append( uint32_t( edit.mOutputBus ) );
+			break;
+		case GraphEdit::SET_ENABLED:
+			append( uint8_t( edit.mEnabled ) );
+			break;
+		case GraphEdit::START_AT:
+		case GraphEdit::STOP_AT:
+			append( edit.mWhen );
+			break;
+		case GraphEdit::PARAM_SET_VALUE:
+			append( uint32_t( edit.mParamIndex ) );
+			append( edit.mValueEnd );
+			break;
+		case GraphEdit::PARAM_APPLY_RAMP:
+		case GraphEdit::PARAM_APPEND_RAMP:
+			append( uint32_t( edit.mParamIndex ) );
+			append( edit.mValueBegin );
+			append( edit.mValueEnd );
+			append( edit.mRampSeconds );
+			append( edit.mDelay );
+			append( uint8_t( edit.mRampType ) );
+			break;
+		case GraphEdit::PARAM_SET_PROCESSOR:
+			append( uint32_t( edit.mParamIndex ) );
+			append( otherNodeId );
+			break;
+		default:
+			break;
+	}
+
+	mNumEdits++;
+}
+
+size_t GraphRecorder::getNumEdits() const
+{
+	lock_guard<mutex> lock( mMutex );
+	return mNumEdits;
+}
+
+vector<uint8_t> GraphRecorder::getData() const
+{
+	lock_guard<mutex> lock( mMutex );
+	return mData;
+}
+
+void GraphRecorder::write( const fs::path &path ) const
+{
+	vector<uint8_t> data = getData();
+
+	ofstream stream( path.string().c_str(), ios::binary );
+	if( data.size() )
+		stream.write( reinterpret_cast<const char *>( &data[0] ), data.size() );
+
+	if( ! stream )
+		throw AudioExc( "could not write GraphRecorder log to " + path.string() );
+}
+
+uint32_t GraphRecorder::getNodeId( Node *node, uint64_t frame )
+{
+	if( node == mOutput )
+		return 0;
+
+	auto idIt = mNodeIds.find( node );
+	if( idIt != mNodeIds.end() && ! idIt->second.first.expired() )
+		return idIt->second.second;
+
+	uint32_t id = mNextNodeId++;
+	mNodeIds[node] = make_pair( weak_ptr<Node>( node->shared_from_this() ), id );
+
+	append( frame );
+	append( uint8_t( GraphEdit::NODE ) );
+	append( id );
+	appendString( node->getName() );
+
+	return id;
+}
+
+size_t GraphRecorder::enterEdit()
+{
+	lock_guard<mutex> lock( mMutex );
+	return mEditDepths[this_thread::get_id()]++;
+}
+
+void GraphRecorder::exitEdit()
+{
+	lock_guard<mutex> lock( mMutex );
+
+	auto depthIt = mEditDepths.find( this_thread::get_id() );
+	CI_ASSERT( depthIt != mEditDepths.end() );
+	if( --depthIt->second == 0 )
+		mEditDepths.erase( depthIt );
+}
+
+template <typename T>
+void GraphRecorder::append( const T &value )
+{
+	const uint8_t *bytes = reinterpret_cast<const uint8_t *>( &value );
+	mData.insert( mData.end(), bytes, bytes + sizeof( T ) );
+}
+
+void GraphRecorder::appendString( const string &str )
+{
+	append( uint32_t( str.size() ) );
+	mData.insert( mData.end(), str.begin(), str.end() );
+}
+
+// ----------------------------------------------------------------------------------------------------
+// MARK: - ScopedGraphEdit
+// ----------------------------------------------------------------------------------------------------
+
+ScopedGraphEdit::ScopedGraphEdit( const ContextRef &context, const GraphEdit &edit )
+	: mEdit( edit ), mFrame( 0 ), mOutermost( false )
+{
+	if( context )
+		mRecorder = context->getGraphRecorder();
+
+	if( mRecorder ) {
+		// the edited Node's are kept alive until the edit is recorded, as disconnecting may release their last owner.
+		mNode = mEdit.mNode ? mEdit.mNode->shared_from_this() : nullptr;
+		mOtherNode = mEdit.mOtherNode ? mEdit.mOtherNode->shared_from_this() : nullptr;
+		mFrame = context->getNumProcessedFrames();
+		mOutermost = ( mRecorder->enterEdit() == 0 );
+	}
+}
+
+ScopedGraphEdit::~ScopedGraphEdit()
+{
+	if( ! mRecorder )
+		return;
+
+	mRecorder->exitEdit();
+	if( mOutermost && ! uncaught_exception() )
+		mRecorder->record( mEdit, mFrame );
+}
+
+// ----------------------------------------------------------------------------------------------------
+// MARK: - GraphReplayer
+// ----------------------------------------------------------------------------------------------------
+
+GraphReplayer::GraphReplayer( const vector<uint8_t> &data )
+	: mSampleRate( 0 ), mFramesPerBlock( 0 ), mNumChannels( 0 ), mNumEdits( 0 )
+{
+	parse( data );
+}
+
+GraphReplayer::GraphReplayer( const fs::path &path )
+	: mSampleRate( 0 ), mFramesPerBlock( 0 ), mNumChannels( 0 ), mNumEdits( 0 )
+{
+	ifstream stream( path.string().c_str(), ios::binary );
+	if( ! stream )
+		throw AudioExc( "could not read GraphRecorder log from " + path.string() );
+
+	vector<uint8_t> data( ( istreambuf_iterator<char>( stream ) ), istreambuf_iterator<char>() );
+	parse( data );
+}
+
+void GraphReplayer::parse( const vector<uint8_t> &data )
+{
+	LogReader reader( data );
+
+	char magic[4];
+	for( size_t i = 0; i < sizeof( magic ); i++ )
+		magic[i] = reader.read<char>();
+
+	if( ! equal( magic, magic + sizeof( magic ), kLogMagic ) )
+		throw AudioExc( "not a GraphRecorder log." );
+	if( reader.read<uint32_t>() != kLogVersion )
+		throw AudioExc( "unsupported GraphRecorder log version." );
+
+	mSampleRate = reader.read<uint32_t>();
+	mFramesPerBlock = reader.read<uint32_t>();
+	mNumChannels = reader.read<uint32_t>();
+
+	while( ! reader.isDone() ) {
+		uint64_t frame = reader.read<uint64_t>();
+		uint8_t type = reader.read<uint8_t>();
+		if( type >= GraphEdit::NUM_TYPES )
+			throw AudioExc( "unknown edit type in GraphRecorder log." );
+
+		Entry entry( GraphEdit( GraphEdit::Type( type ), nullptr ), frame );
+		GraphEdit &edit = entry.mEdit;
+		entry.mNodeId = reader.read<uint32_t>();
+
+		switch( edit.mType ) {
+			case GraphEdit::NODE:
+				entry.mName = reader.readString();
+				break;
+			case GraphEdit::CONNECT:
+				entry.mOtherNodeId = reader.read<uint32_t>();
+				edit.mOutputBus = reader.read<uint32_t>();
+				edit.mInputBus = reader.read<uint32_t>();
+				break;
+			case GraphEdit::DISCONNECT:
+				edit.mOutputBus = reader.read<uint32_t>();
+				break;
+			case GraphEdit::SET_ENABLED:
+				edit.mEnabled = reader.read<uint8_t>() != 0;
+				break;
+			case GraphEdit::START_AT:
+			case GraphEdit::STOP_AT:
+				edit.mWhen = reader.read<double>();
+				break;
+			case GraphEdit::PARAM_SET_VALUE:
+				edit.mParamIndex = reader.read<uint32_t>();
+				edit.mValueEnd = reader.read<float>();
+				break;
+			case GraphEdit::PARAM_APPLY_RAMP:
+			case GraphEdit::PARAM_APPEND_RAMP:
+				edit.mParamIndex = reader.read<uint32_t>();
+				edit.mValueBegin = reader.read<float>();
+				edit.mValueEnd = reader.read<float>();
+				edit.mRampSeconds = reader.read<float>();
+				edit.mDelay = reader.read<float>();
+				edit.mRampType = GraphEdit::RampType( reader.read<uint8_t>() );
+				break;
+			case GraphEdit::PARAM_SET_PROCESSOR:
+				edit.mParamIndex = reader.read<uint32_t>();
+				entry.mOtherNodeId = reader.read<uint32_t>();
+				break;
+			default:
+				break;
+		}
+
+		if( edit.mType != GraphEdit::NODE )
+			mNumEdits++;
+
+		mEntries.push_back( entry );
+	}
+}
+
+ContextOfflineRef GraphReplayer::createContext() const
+{
+	return ContextOffline::create( mSampleRate, mFramesPerBlock, mNumChannels );
+}
+
+GraphReplayStats GraphReplayer::replay( const ContextOfflineRef &context, size_t numTailFrames, BufferDynamic *outputBuffer )
+{
+	size_t framesPerBlock = context->getFramesPerBlock();
+	size_t numChannels = context->getOutput()->getNumChannels();
+	uint64_t numFrames = getNumFrames() + numTailFrames;
+	uint64_t numRenderedFrames = ( ( numFrames + framesPerBlock - 1 ) / framesPerBlock ) * framesPerBlock;
+
+	mNodes.assign( 1, context->getOutput() );
+
+	Buffer block( framesPerBlock, numChannels );
+	if( outputBuffer )
+		outputBuffer->setSize( (size_t)numRenderedFrames, numChannels );
+
+	GraphReplayStats stats;
+	auto beginTime = chrono::steady_clock::now();
+
+	auto entryIt = mEntries.begin();
+	for( uint64_t frame = 0; ; frame += framesPerBlock ) {
+		for( ; entryIt != mEntries.end() && entryIt->mFrame <= frame; ++entryIt ) {
+			apply( *entryIt, context );
+			if( entryIt->mEdit.mType != GraphEdit::NODE )
+				stats.mNumEdits++;
+		}
+
+		if( frame >= numRenderedFrames )
+			break;
+
+		context->render( &block );
+		if( outputBuffer )
+			outputBuffer->copyOffset( block, framesPerBlock, (size_t)frame, 0 );
+	}
+
+	stats.mElapsedSeconds = chrono::duration<double>( chrono::steady_clock::now() - beginTime ).count();
+	stats.mNumFrames = numRenderedFrames;
+	stats.mRenderedSeconds = (double)numRenderedFrames / (double)context->getSampleRate();
+
+	return stats;
+}
+
+void GraphReplayer::apply( const Entry &entry, const ContextOfflineRef &context )
+{
+	const GraphEdit &edit = entry.mEdit;
+
+	switch( edit.mType ) {
+		case GraphEdit::NODE: {
+			auto fnIt = mNodeFns.find( entry.mName );
+			if( fnIt == mNodeFns.end() )
+				throw AudioExc( "GraphReplayer has no NodeFn for Node named " + entry.mName );
+
+			NodeRef node = context->makeNode( fnIt->second() );
+			if( node->getName() != entry.mName )
+				throw AudioExc( "NodeFn for " + entry.mName + " returned a Node named " + node->getName() );
+
+			if( mNodes.size() <= entry.mNodeId )
+				mNodes.resize( entry.mNodeId + 1 );
+
+			mNodes[entry.mNodeId] = node;
+			break;
+		}
+		case GraphEdit::CONNECT:				getNode( entry.mNodeId )->connect( getNode( entry.mOtherNodeId ), edit.mOutputBus, edit.mInputBus );	break;
+		case GraphEdit::DISCONNECT:				getNode( entry.mNodeId )->disconnect( edit.mOutputBus );	break;
+		case GraphEdit::DISCONNECT_ALL:			getNode( entry.mNodeId )->disconnectAll();					break;
+		case GraphEdit::DISCONNECT_ALL_OUTPUTS:	getNode( entry.mNodeId )->disconnectAllOutputs();			break;
+		case GraphEdit::DISCONNECT_ALL_INPUTS:	getNode( entry.mNodeId )->disconnectAllInputs();			break;
+		case GraphEdit::SET_ENABLED:			getNode( entry.mNodeId )->setEnabled( edit.mEnabled );		break;
+		case GraphEdit::START_AT:				getNode( entry.mNodeId )->start( edit.mWhen );				break;
+		case GraphEdit::STOP_AT:				getNode( entry.mNodeId )->stop( edit.mWhen );				break;
+		case GraphEdit::PARAM_SET_VALUE:		getParam( entry )->setValue( edit.mValueEnd );				break;
+		case GraphEdit::PARAM_APPLY_RAMP:
+			getParam( entry )->applyRamp( edit.mValueBegin, edit.mValueEnd, edit.mRampSeconds, Param::Options().delay( edit.mDelay ).rampFn( getRampFn( edit.mRampType ) ) );
+			break;
+		case GraphEdit::PARAM_APPEND_RAMP:
+			getParam( entry )->appendRamp( edit.mValueEnd, edit.mRampSeconds, Param::Options().delay( edit.mDelay ).rampFn( getRampFn( edit.mRampType ) ) );
+			break;
+		case GraphEdit::PARAM_SET_PROCESSOR:	getParam( entry )->setProcessor( getNode( entry.mOtherNodeId ) );	break;
+		default:
+			break;
+	}
+}
+
+const NodeRef& GraphReplayer::getNode( uint32_t id ) const
+{
+	if( id >= mNodes.size() || ! mNodes[id] )
+		throw AudioExc( "GraphRecorder log refers to Node " + to_string( id ) + " before naming it." );
+
+	return mNodes[id];
+}
+
+Param* GraphReplayer::getParam( const Entry &entry ) const
+{
+	// the Node was created by name, so it is of the same type as the recorded Node and has constructed its Param's in the same order.
+	const NodeRef &node = getNode( entry.mNodeId );
+	const vector<Param *> &params = node->getParams();
+	if( entry.mEdit.mParamIndex >= params.size() )
+		throw AudioExc( "GraphRecorder log refers to a Param that " + node->getName() + " doesn't have." );
+
+	return params[entry.mEdit.mParamIndex];
+}
+
+} } // namespace cinder::audio2
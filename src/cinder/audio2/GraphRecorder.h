@@ -0,0 +1,258 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/audio2/Param.h"
+#include "cinder/audio2/Utilities.h"
+
+#include "cinder/Cinder.h"
+
+#include <boost/noncopyable.hpp>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <typeinfo>
+#include <vector>
+
+namespace cinder { namespace audio2 {
+
+typedef std::shared_ptr<class ContextOffline>	ContextOfflineRef;
+typedef std::shared_ptr<class GraphRecorder>	GraphRecorderRef;
+
+//! Describes one edit to a Context's graph, as recorded by a GraphRecorder.
+struct GraphEdit {
+	enum Type {
+		NODE,						//!< Precedes the first edit of each Node in the log, naming its type.
+		CONNECT,					//!< Node::connect()
+		DISCONNECT,					//!< Node::disconnect()
+		DISCONNECT_ALL,				//!< Node::disconnectAll()
+		DISCONNECT_ALL_OUTPUTS,		//!< Node::disconnectAllOutputs()
+		DISCONNECT_ALL_INPUTS,		//!< Node::disconnectAllInputs()
+		SET_ENABLED,				//!< Node::setEnabled()
+		START_AT,					//!< Node::start( double when )
+		STOP_AT,					//!< Node::stop( double when )
+		PARAM_SET_VALUE,			//!< Param::setValue()
+		PARAM_APPLY_RAMP,			//!< Param::applyRamp()
+		PARAM_APPEND_RAMP,			//!< Param::appendRamp()
+		PARAM_SET_PROCESSOR,		//!< Param::setProcessor()
+		NUM_TYPES
+	};
+
+	//! The ramp functions that are recorded by name. Any other RampFn is recorded as RAMP_CUSTOM and replayed as rampLinear().
+	enum RampType { RAMP_LINEAR, RAMP_IN_QUAD, RAMP_OUT_QUAD, RAMP_CUSTOM };
+
+	static GraphEdit connect( Node *input, Node *output, size_t outputBus, size_t inputBus );
+	static GraphEdit disconnect( Node *node, size_t outputBus );
+	static GraphEdit disconnectAll( Node *node )			{ return GraphEdit( DISCONNECT_ALL, node ); }
+	static GraphEdit disconnectAllOutputs( Node *node )		{ return GraphEdit( DISCONNECT_ALL_OUTPUTS, node ); }
+	static GraphEdit disconnectAllInputs( Node *node )		{ return GraphEdit( DISCONNECT_ALL_INPUTS, node ); }
+	static GraphEdit setEnabled( Node *node, bool enabled );
+	static GraphEdit startAt( Node *node, double when );
+	static GraphEdit stopAt( Node *node, double when );
+	//! The Param is identified by its parent Node and its index in Node::getParams(), so a replayed Param must belong to a Node of the same type.
+	static GraphEdit paramSetValue( Node *parentNode, const Param *param, float value );
+	static GraphEdit paramApplyRamp( Node *parentNode, const Param *param, float valueBegin, float valueEnd, float rampSeconds, const Param::Options &options );
+	static GraphEdit paramAppendRamp( Node *parentNode, const Param *param, float valueEnd, float rampSeconds, const Param::Options &options );
+	static GraphEdit paramSetProcessor( Node *parentNode, const Param *param, Node *processor );
+
+	Type		mType;
+	Node		*mNode;				//!< The Node edited, or the Param's parent Node.
+	Node		*mOtherNode;		//!< The output of CONNECT, or the processor of PARAM_SET_PROCESSOR.
+	size_t		mParamIndex;		//!< Index of the Param in its parent Node's getParams().
+	size_t		mOutputBus, mInputBus;
+	bool		mEnabled;
+	double		mWhen;				//!< Seconds on the Context's frame clock, for START_AT and STOP_AT.
+	float		mValueBegin, mValueEnd, mRampSeconds, mDelay;
+	RampType	mRampType;
+
+  private:
+	GraphEdit( Type type, Node *node );
+	static GraphEdit paramEdit( Type type, Node *parentNode, const Param *param );
+
+	friend class GraphReplayer;
+};
+
+//! \brief Records the edits made to a Context's graph into a compact binary log, which a GraphReplayer can re-run against a ContextOffline.
+//!
+//! Recording is opt-in with Context::setGraphRecorder(). Each edit is stamped with the number of frames the Context had processed when
+//! it was made, so the replay is deterministic. Only the outermost call of a nested edit is recorded, for example disconnectAll() and not
+//! the disconnect() calls it makes, and edits that throw aren't recorded. Node::start() and Node::stop() are virtual and called internally
+//! whenever a Node is auto-enabled, so they aren't recorded themselves. Use Node::setEnabled(), which is recorded and calls them, in code
+//! that should be replayable.
+//! \code
+//! auto recorder = make_shared<audio2::GraphRecorder>();
+//! ctx->setGraphRecorder( recorder );
+//! // ... after the dropout
+//! recorder->write( "session.a2graph" );
+//! \endcode
+class GraphRecorder : public boost::noncopyable {
+  public:
+	GraphRecorder();
+
+	//! Called by Context::setGraphRecorder(), discards any previous log and starts a new one for a Context with the given format, whose frame clock is at \a startFrame.
+	void begin( size_t sampleRate, size_t framesPerBlock, size_t numChannels, const Node *output, uint64_t startFrame );
+	//! Appends \a edit to the log, stamped with \a frame on the recorded Context's frame clock. Typically called by ScopedGraphEdit.
+	void record( const GraphEdit &edit, uint64_t frame );
+
+	//! Returns the number of edits recorded, not counting the NODE entries that name each Node.
+	size_t					getNumEdits() const;
+	//! Returns a copy of the binary log.
+	std::vector<uint8_t>	getData() const;
+	//! Writes the binary log to \a path. \throws AudioExc if the file can't be written.
+	void					write( const fs::path &path ) const;
+
+  private:
+	uint32_t	getNodeId( Node *node, uint64_t frame );
+	size_t		enterEdit();
+	void		exitEdit();
+
+	template <typename T>
+	void append( const T &value );
+	void appendString( const std::string &str );
+
+	mutable std::mutex		mMutex;
+	std::vector<uint8_t>	mData;
+	size_t					mNumEdits;
+	uint64_t				mStartFrame;
+	const Node				*mOutput;
+
+	// Node's are numbered in the order they are first recorded, the Context's output is always 0. The weak_ptr detects a new Node at the address of a destroyed one.
+	std::map<const Node *, std::pair<std::weak_ptr<Node>, uint32_t> >	mNodeIds;
+	uint32_t															mNextNodeId;
+	// depth of nested ScopedGraphEdit's on each thread
+	std::map<std::thread::id, size_t>									mEditDepths;
+
+	friend class ScopedGraphEdit;
+};
+
+//! RAII-style utility that records \a edit with \a context's GraphRecorder, if it has one, when it goes out of scope without an exception.
+//! Edits made while it is in scope on the same thread are not recorded.
+class ScopedGraphEdit : public boost::noncopyable {
+  public:
+	ScopedGraphEdit( const ContextRef &context, const GraphEdit &edit );
+	~ScopedGraphEdit();
+
+  private:
+	GraphRecorderRef	mRecorder;
+	GraphEdit			mEdit;
+	NodeRef				mNode, mOtherNode;
+	uint64_t			mFrame;
+	bool				mOutermost;
+};
+
+//! Timing of a GraphReplayer::replay().
+struct GraphReplayStats {
+	GraphReplayStats() : mNumEdits( 0 ), mNumFrames( 0 ), mRenderedSeconds( 0 ), mElapsedSeconds( 0 )	{}
+
+	size_t		mNumEdits;			//!< Number of edits applied.
+	uint64_t	mNumFrames;			//!< Number of frames rendered.
+	double		mRenderedSeconds;	//!< Duration of the rendered audio.
+	double		mElapsedSeconds;	//!< Wall clock time spent replaying, including applying the edits.
+
+	//! Returns how many times faster than real-time the log was replayed.
+	double getRealtimeMultiple() const	{ return mElapsedSeconds > 0 ? mRenderedSeconds / mElapsedSeconds : 0; }
+};
+
+//! \brief Re-runs a log recorded by a GraphRecorder against a ContextOffline, for repeatable profiling of a recorded session.
+//!
+//! The Node's in the log are recreated by name (see Node::getName()) with the functions provided with setNodeFn(), which should
+//! construct them the same way they were constructed while recording. Each edit is applied before rendering the block that starts
+//! at or after its frame, so replaying with the recorded block size applies the edits on the same frames as they were recorded.
+//! \code
+//! audio2::GraphReplayer replayer( "session.a2graph" );
+//! replayer.setNodeType<audio2::Gain>();
+//! replayer.setNodeFn( "GenSine", [] { return new audio2::GenSine( 440.0f, audio2::Node::Format().autoEnable() ); } );
+//!
+//! auto ctx = replayer.createContext();
+//! ctx->getOutput()->setCpuBudget( 0.5 );
+//! replayer.replay( ctx );
+//! auto report = ctx->getCpuBudgetReport();
+//! \endcode
+class GraphReplayer {
+  public:
+	//! Returns a new Node, which is then owned by the replaying Context.
+	typedef std::function<Node* ()>		NodeFn;
+
+	//! Parses the log in \a data. \throws AudioExc if it isn't a valid log.
+	GraphReplayer( const std::vector<uint8_t> &data );
+	//! Parses the log in the file at \a path. \throws AudioExc if it can't be read or isn't a valid log.
+	GraphReplayer( const fs::path &path );
+
+	//! Recreates Node's named \a name with \a nodeFn.
+	void setNodeFn( const std::string &name, const NodeFn &nodeFn )		{ mNodeFns[name] = nodeFn; }
+	//! Recreates Node's of type \a NodeT with its default constructor.
+	template <typename NodeT>
+	void setNodeType();
+
+	//! Returns a ContextOffline with the recorded samplerate, block size and number of output channels.
+	ContextOfflineRef	createContext() const;
+
+	//! Applies the recorded edits to \a context, rendering until the last edit has been applied and then \a numTailFrames more.
+	//! If \a outputBuffer is provided, it is resized to hold and receives everything rendered.
+	//! \throws AudioExc if a Node in the log has no NodeFn, or a Param in the log can't be found.
+	GraphReplayStats	replay( const ContextOfflineRef &context, size_t numTailFrames = 0, BufferDynamic *outputBuffer = nullptr );
+
+	size_t		getSampleRate() const		{ return mSampleRate; }
+	size_t		getFramesPerBlock() const	{ return mFramesPerBlock; }
+	size_t		getNumChannels() const		{ return mNumChannels; }
+	//! Returns the number of edits in the log, not counting the NODE entries.
+	size_t		getNumEdits() const			{ return mNumEdits; }
+	//! Returns the frame of the last edit, relative to the start of the recording.
+	uint64_t	getNumFrames() const		{ return mEntries.empty() ? 0 : mEntries.back().mFrame; }
+
+	//! Returns the Node's created by the last replay(), indexed by their id in the log. Index 0 is the Context's output.
+	const std::vector<NodeRef>&	getNodes() const	{ return mNodes; }
+
+  private:
+	struct Entry {
+		Entry( const GraphEdit &edit, uint64_t frame ) : mEdit( edit ), mFrame( frame ), mNodeId( 0 ), mOtherNodeId( 0 )	{}
+
+		GraphEdit	mEdit;
+		uint64_t	mFrame;
+		uint32_t	mNodeId, mOtherNodeId;
+		std::string	mName;
+	};
+
+	void			parse( const std::vector<uint8_t> &data );
+	void			apply( const Entry &entry, const ContextOfflineRef &context );
+	const NodeRef&	getNode( uint32_t id ) const;
+	Param*			getParam( const Entry &entry ) const;
+
+	std::vector<Entry>				mEntries;
+	std::map<std::string, NodeFn>	mNodeFns;
+	std::vector<NodeRef>			mNodes;
+	size_t							mSampleRate, mFramesPerBlock, mNumChannels, mNumEdits;
+};
+
+template <typename NodeT>
+void GraphReplayer::setNodeType()
+{
+	setNodeFn( demangledTypeName( typeid( NodeT ).name() ), [] { return new NodeT; } );
+}
+
+} } // namespace cinder::audio2
@@ -0,0 +1,200 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/audio2/MemoryPool.h"
+#include "cinder/audio2/CinderAssert.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstdint>
+
+using namespace std;
+
+namespace cinder { namespace audio2 {
+
+MemoryPool::MemoryPool()
+	: mReleased( false )
+{
+	static_assert( sizeof( BlockHeader ) <= kHeaderSize, "BlockHeader must fit in kHeaderSize" );
+
+	fill( mFreeBlocks, mFreeBlocks + kNumSizeClasses, nullptr );
+}
+
+MemoryPool::~MemoryPool()
+{
+	for( void *slab : mSlabs )
+		free( slab );
+}
+
+// static
+void* MemoryPool::allocate( MemoryPool *pool, size_t bytes )
+{
+	size_t blockSize = kHeaderSize + max<size_t>( bytes, 1 );
+
+	BlockHeader *header;
+	if( pool )
+		header = pool->allocateBlock( blockSize );
+	else {
+		void *allocation;
+		header = reinterpret_cast<BlockHeader *>( mallocAligned( blockSize, &allocation ) );
+		header->mPool = nullptr;
+		header->mSizeClass = blockSize;
+		header->mAllocation = allocation;
+	}
+
+	return reinterpret_cast<char *>( header ) + kHeaderSize;
+}
+
+// static
+void MemoryPool::deallocate( void *ptr )
+{
+	if( ! ptr )
+		return;
+
+	BlockHeader *header = reinterpret_cast<BlockHeader *>( static_cast<char *>( ptr ) - kHeaderSize );
+	if( header->mPool )
+		header->mPool->deallocateBlock( header );
+	else
+		free( header->mAllocation );
+}
+
+void MemoryPool::release()
+{
+	bool destroy;
+	{
+		lock_guard<mutex> lock( mMutex );
+		CI_ASSERT( ! mReleased );
+
+		mReleased = true;
+		destroy = ( mStats.mNumAllocations == 0 );
+	}
+
+	if( destroy )
+		delete this;
+}
+
+MemoryPool::Stats MemoryPool::getStats() const
+{
+	lock_guard<mutex> lock( mMutex );
+	return mStats;
+}
+
+// static
+// Returns \a bytes from the heap aligned to kAlignment. The start of the allocation, which is what must be freed, is returned in \a allocation.
+char* MemoryPool::mallocAligned( size_t bytes, void **allocation )
+{
+	*allocation = malloc( bytes + kAlignment - 1 );
+	if( ! *allocation )
+		throw bad_alloc();
+
+	uintptr_t address = reinterpret_cast<uintptr_t>( *allocation );
+	return reinterpret_cast<char *>( ( address + kAlignment - 1 ) & ~uintptr_t( kAlignment - 1 ) );
+}
+
+// static
+size_t MemoryPool::getSizeClass( size_t blockSize )
+{
+	size_t sizeClass = 0;
+	while( sizeClass < kNumSizeClasses && getBlockSize( sizeClass ) < blockSize )
+		sizeClass++;
+
+	return sizeClass < kNumSizeClasses ? sizeClass : blockSize;
+}
+
+MemoryPool::BlockHeader* MemoryPool::allocateBlock( size_t blockSize )
+{
+	size_t sizeClass = getSizeClass( blockSize );
+
+	lock_guard<mutex> lock( mMutex );
+
+	BlockHeader *header;
+	if( sizeClass >= kNumSizeClasses ) {
+		void *allocation;
+		header = reinterpret_cast<BlockHeader *>( mallocAligned( blockSize, &allocation ) );
+		header->mAllocation = allocation;
+	}
+	else {
+		blockSize = getBlockSize( sizeClass );
+
+		// carve a new slab into free blocks of this class, at least kMinSlabSize or eight blocks. The block sizes are multiples of
+		// kAlignment, so every block of an aligned slab is aligned.
+		if( ! mFreeBlocks[sizeClass] ) {
+			size_t slabSize = max( kMinSlabSize, blockSize * 8 );
+			void *allocation;
+			char *slab = mallocAligned( slabSize, &allocation );
+
+			mSlabs.push_back( allocation );
+			mStats.mNumSlabs++;
+			mStats.mNumSlabBytes += slabSize;
+
+			for( size_t offset = slabSize - blockSize; ; offset -= blockSize ) {
+				FreeBlock *block = reinterpret_cast<FreeBlock *>( slab + offset );
+				block->mNext = mFreeBlocks[sizeClass];
+				mFreeBlocks[sizeClass] = block;
+
+				if( offset == 0 )
+					break;
+			}
+		}
+
+		FreeBlock *block = mFreeBlocks[sizeClass];
+		mFreeBlocks[sizeClass] = block->mNext;
+		header = reinterpret_cast<BlockHeader *>( block );
+	}
+
+	header->mPool = this;
+	header->mSizeClass = sizeClass;
+
+	mStats.mNumAllocations++;
+	mStats.mNumAllocatedBytes += blockSize;
+
+	return header;
+}
+
+void MemoryPool::deallocateBlock( BlockHeader *header )
+{
+	bool destroy;
+	{
+		lock_guard<mutex> lock( mMutex );
+
+		size_t sizeClass = header->mSizeClass;
+		if( sizeClass >= kNumSizeClasses ) {
+			mStats.mNumAllocatedBytes -= sizeClass;
+			free( header->mAllocation );
+		}
+		else {
+			FreeBlock *block = reinterpret_cast<FreeBlock *>( header );
+			block->mNext = mFreeBlocks[sizeClass];
+			mFreeBlocks[sizeClass] = block;
+			mStats.mNumAllocatedBytes -= getBlockSize( sizeClass );
+		}
+
+		mStats.mNumAllocations--;
+		destroy = ( mReleased && mStats.mNumAllocations == 0 );
+	}
+
+	if( destroy )
+		delete this;
+}
+
+} } // namespace cinder::audio2
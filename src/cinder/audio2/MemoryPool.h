@@ -0,0 +1,149 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <boost/noncopyable.hpp>
+
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace cinder { namespace audio2 {
+
+//! \brief Thread-safe slab allocator that a Context allocates its Node's, their shared_ptr control blocks and their Buffer's from.
+//!
+//! Allocations are rounded up to a power of two size class and carved out of large slabs, which are only returned to the heap when the
+//! pool is destroyed. Freed blocks are reused by later allocations of the same class, so Node's and Buffer's that come and go quickly don't
+//! touch the heap, and those made around the same time sit next to each other in memory. Allocations larger than the largest class
+//! come straight from the heap.
+//!
+//! All memory is aligned to a cache line, which is also a multiple of the SIMD register widths, so Buffer's can be processed with aligned
+//! loads and stores, and Node's processed on different threads don't share cache lines.
+//!
+//! Every block records the pool it came from, so deallocate() doesn't need a pool. The owner calls release() rather than deleting the
+//! pool, which then lives on until the last of its blocks has been deallocated, since Node's and Buffer's can outlive their Context.
+class MemoryPool : public boost::noncopyable {
+  public:
+	//! Counts of the memory managed by a MemoryPool, see getStats().
+	struct Stats {
+		Stats() : mNumAllocations( 0 ), mNumAllocatedBytes( 0 ), mNumSlabs( 0 ), mNumSlabBytes( 0 )	{}
+
+		size_t mNumAllocations;		//!< Number of blocks currently allocated.
+		size_t mNumAllocatedBytes;	//!< Size in bytes of the blocks currently allocated, including their headers and rounding up to their size class.
+		size_t mNumSlabs;			//!< Number of slabs that blocks are carved out of.
+		size_t mNumSlabBytes;		//!< Size in bytes of all slabs.
+	};
+
+	MemoryPool();
+
+	//! Returns \a bytes of memory from \a pool, or from the heap if \a pool is null. The memory is aligned to getAlignment() and must be freed with deallocate().
+	//! \throws std::bad_alloc if the memory can't be allocated.
+	//! \note Locks the pool's mutex, so it must not be called on the audio thread.
+	static void*	allocate( MemoryPool *pool, size_t bytes );
+	//! Frees memory returned by allocate(), returning it to the pool it came from. Does nothing if \a ptr is null. Can be called from any non-audio thread.
+	static void		deallocate( void *ptr );
+	//! Returns the alignment of the memory returned by allocate().
+	static size_t	getAlignment()		{ return kAlignment; }
+
+	//! Gives up ownership of the pool. It is destroyed right away if all of its blocks have been deallocated, otherwise once the last one is.
+	void release();
+	//! Returns counts of the memory managed by the pool.
+	Stats getStats() const;
+
+  private:
+	~MemoryPool();
+
+	static const size_t kAlignment		= 64; // a cache line
+	static const size_t kHeaderSize		= 64; // a multiple of kAlignment that fits a BlockHeader
+	static const size_t kMinBlockSize	= 128;
+	static const size_t kNumSizeClasses	= 10; // kMinBlockSize up to 64 kb
+	static const size_t kMinSlabSize	= 64 * 1024;
+
+	struct BlockHeader {
+		MemoryPool	*mPool;
+		size_t		mSizeClass;		// the block size if allocated directly from the heap, which is always larger than kNumSizeClasses
+		void		*mAllocation;	// the heap allocation that the block was aligned within, if allocated directly from the heap
+	};
+
+	struct FreeBlock {
+		FreeBlock *mNext;
+	};
+
+	static char*	mallocAligned( size_t bytes, void **allocation );
+	static size_t	getSizeClass( size_t blockSize );
+	static size_t	getBlockSize( size_t sizeClass )	{ return kMinBlockSize << sizeClass; }
+
+	BlockHeader*	allocateBlock( size_t blockSize );
+	void			deallocateBlock( BlockHeader *header );
+
+	mutable std::mutex	mMutex;
+	FreeBlock			*mFreeBlocks[kNumSizeClasses];
+	std::vector<void *>	mSlabs;
+	Stats				mStats;
+	bool				mReleased;
+};
+
+//! Standard allocator that allocates from a MemoryPool, or from the heap if the pool is null. Used for the shared_ptr control blocks of Node's.
+template <typename T>
+class MemoryPoolAllocator {
+  public:
+	typedef T			value_type;
+	typedef T*			pointer;
+	typedef const T*	const_pointer;
+	typedef T&			reference;
+	typedef const T&	const_reference;
+	typedef size_t		size_type;
+	typedef ptrdiff_t	difference_type;
+
+	template <typename U>
+	struct rebind { typedef MemoryPoolAllocator<U> other; };
+
+	MemoryPoolAllocator( MemoryPool *pool = nullptr ) : mPool( pool )	{}
+	template <typename U>
+	MemoryPoolAllocator( const MemoryPoolAllocator<U> &other ) : mPool( other.getPool() )	{}
+
+	pointer		allocate( size_type n, const void *hint = nullptr )	{ return static_cast<pointer>( MemoryPool::allocate( mPool, n * sizeof( T ) ) ); }
+	void		deallocate( pointer p, size_type n )				{ MemoryPool::deallocate( p ); }
+
+	void		construct( pointer p, const T &value )	{ new( p ) T( value ); }
+	void		destroy( pointer p )					{ p->~T(); }
+	size_type	max_size() const						{ return std::numeric_limits<size_type>::max() / sizeof( T ); }
+
+	pointer			address( reference x ) const		{ return &x; }
+	const_pointer	address( const_reference x ) const	{ return &x; }
+
+	MemoryPool*	getPool() const		{ return mPool; }
+
+  private:
+	MemoryPool	*mPool;
+};
+
+template <typename T, typename U>
+inline bool operator==( const MemoryPoolAllocator<T> &a, const MemoryPoolAllocator<U> &b )	{ return a.getPool() == b.getPool(); }
+template <typename T, typename U>
+inline bool operator!=( const MemoryPoolAllocator<T> &a, const MemoryPoolAllocator<U> &b )	{ return a.getPool() != b.getPool(); }
+
+} } // namespace cinder::audio2
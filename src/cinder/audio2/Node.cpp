@@ -24,6 +24,7 @@
 
 #include "cinder/audio2/Node.h"
 #include "cinder/audio2/Context.h"
+#include "cinder/audio2/GraphRecorder.h"
 #include "cinder/audio2/NodeEffect.h"
 #include "cinder/audio2/dsp/Dsp.h"
 #include "cinder/audio2/dsp/Converter.h"
@@ -45,7 +46,8 @@ namespace cinder { namespace audio2 {
 
 Node::Node( const Format &format )
 	: mInitialized( false ), mEnabled( false ),	mChannelMode( format.getChannelMode() ),
-		mNumChannels( 1 ), mAutoEnabled( false ), mProcessInPlace( true ), mLastProcessedFrame( numeric_limits<uint64_t>::max() )
+		mNumChannels( 1 ), mAutoEnabled( false ), mProcessInPlace( true ), mLastProcessedFrame( numeric_limits<uint64_t>::max() ),
+		mSilent( false ), mNumSilentInputFrames( 0 ), mScheduledStartFrame( 0 ), mScheduledStopFrame( 0 ), mReachedStopFrame( 0 )
 {
 	if( format.getChannels() ) {
 		mNumChannels = format.getChannels();
@@ -62,6 +64,8 @@ Node::~Node()
 
 void Node::connect( const NodeRef &output, size_t outputBus, size_t inputBus )
 {
+	ScopedGraphEdit edit( getContext(), GraphEdit::connect( this, output.get(), outputBus, inputBus ) );
+
 	// make a reference to ourselves so that we aren't deallocated in the case of the last owner
 	// disconnecting us, which we may need later anyway
 	NodeRef thisRef = shared_from_this();
@@ -95,6 +99,8 @@ void Node::addConnection( const NodeRef &output )
 
 void Node::disconnect( size_t outputBus )
 {
+	ScopedGraphEdit edit( getContext(), GraphEdit::disconnect( this, outputBus ) );
+
 	auto outIt = mOutputs.find( outputBus );
 	if( outIt == mOutputs.end() )
 		return;
@@ -111,12 +117,16 @@ void Node::disconnect( size_t outputBus )
 
 void Node::disconnectAll()
 {
+	ScopedGraphEdit edit( getContext(), GraphEdit::disconnectAll( this ) );
+
 	disconnectAllInputs();
 	disconnectAllOutputs();
 }
 
 void Node::disconnectAllOutputs()
 {
+	ScopedGraphEdit edit( getContext(), GraphEdit::disconnectAllOutputs( this ) );
+
 	NodeRef thisRef = shared_from_this();
 
 	for( size_t &outBus : getOccupiedOutputBusses() )
@@ -125,6 +135,8 @@ void Node::disconnectAllOutputs()
 
 void Node::disconnectAllInputs()
 {
+	ScopedGraphEdit edit( getContext(), GraphEdit::disconnectAllInputs( this ) );
+
 	NodeRef thisRef = shared_from_this();
 
 	for( auto &in : mInputs )
@@ -184,8 +196,68 @@ vector<size_t> Node::getOccupiedOutputBusses() const
 	return result;
 }
 
+void Node::start( double when )
+{
+	ScopedGraphEdit edit( getContext(), GraphEdit::startAt( this, when ) );
+
+	// serialized with finishScheduledStop(), which the housekeeping thread calls once a scheduled stop has been reached.
+	lock_guard<mutex> lock( getContext()->getMutex() );
+
+	uint64_t frame = getScheduledFrame( when );
+
+	// a stop before the new start would disable the Node before it is heard.
+	uint64_t stopFrame = mScheduledStopFrame;
+	if( stopFrame && stopFrame <= frame )
+		mScheduledStopFrame = 0;
+
+	// set before start() enables the Node, so that the audio thread never processes it early.
+	mScheduledStartFrame = frame;
+	start();
+}
+
+void Node::stop( double when )
+{
+	ScopedGraphEdit edit( getContext(), GraphEdit::stopAt( this, when ) );
+
+	lock_guard<mutex> lock( getContext()->getMutex() );
+
+	uint64_t frame = getScheduledFrame( when );
+
+	// the Node isn't processed until a pending start, so a stop at or before it is discarded, just as start() discards an earlier stop.
+	uint64_t startFrame = mScheduledStartFrame;
+	if( startFrame && frame <= startFrame )
+		return;
+
+	if( frame <= getContext()->getNumProcessedFrames() ) {
+		mScheduledStopFrame = 0;
+		stop();
+	}
+	else
+		mScheduledStopFrame = frame;
+}
+
+void Node::finishScheduledStop()
+{
+	auto ctx = getContext();
+	if( ! ctx )
+		return;
+
+	lock_guard<mutex> lock( ctx->getMutex() );
+
+	// start() or stop() may have rescheduled or cancelled the stop since the audio thread reached it.
+	uint64_t reachedFrame = mReachedStopFrame.exchange( 0 );
+	if( ! reachedFrame || reachedFrame != mScheduledStopFrame )
+		return;
+
+	// disabled before the stop frame is cleared, so that the audio thread doesn't process a whole block in between.
+	stop();
+	mScheduledStopFrame = 0;
+}
+
 void Node::setEnabled( bool enabled )
 {
+	ScopedGraphEdit edit( getContext(), GraphEdit::setEnabled( this, enabled ) );
+
 	if( enabled )
 		start();
 	else
@@ -210,6 +282,11 @@ void Node::initializeImpl()
 	initialize();
 	mInitialized = true;
 
+	// resized for the current channel count while the Context's mutex is held and the audio thread can't be processing this Node,
+	// so that processScheduled() never has to.
+	if( mScheduledBuffer.getAllocatedSize() )
+		mScheduledBuffer.setSize( getFramesPerBlock(), mNumChannels );
+
 	if( mAutoEnabled )
 		start();
 }
@@ -220,6 +297,11 @@ void Node::uninitializeImpl()
 	if( ! mInitialized )
 		return;
 
+	// make sure the audio thread isn't processing this Node while it is being reconfigured.
+	auto ctx = getContext();
+	if( ctx )
+		ctx->suspendRenderGraph( this );
+
 	if( mAutoEnabled )
 		stop();
 
@@ -329,11 +411,12 @@ void Node::pullInputs( Buffer *inPlaceBuffer )
 {
 	CI_ASSERT( getContext() );
 
+	uint64_t numProcessedFrames = getContext()->getNumProcessedFrames();
 	if( mProcessInPlace ) {
 		if( mInputs.empty() ) {
 			// Fastest route: no inputs and process in-place. If disabled, get rid of any previously processsed samples.
 			if( mEnabled )
-				process( inPlaceBuffer );
+				callProcess( inPlaceBuffer, numProcessedFrames, false );
 			else
 				inPlaceBuffer->zero();
 		}
@@ -346,12 +429,11 @@ void Node::pullInputs( Buffer *inPlaceBuffer )
 				dsp::mixBuffers( input->getInternalBuffer(), inPlaceBuffer );
 
 			if( mEnabled )
-				process( inPlaceBuffer );
+				callProcess( inPlaceBuffer, numProcessedFrames, true );
 		}
 	}
 	else {
 		// Pull and sum all enabled inputs. Only do this once per processing block, which is checked by the current number of processed frames.
-		uint64_t numProcessedFrames = getContext()->getNumProcessedFrames();
 		if( mLastProcessedFrame != numProcessedFrames ) {
 			mLastProcessedFrame = numProcessedFrames;
 
@@ -368,7 +450,7 @@ void Node::pullInputs( Buffer *inPlaceBuffer )
 
 			// Process the summed results if enabled.
 			if( mEnabled )
-				process( &mSummingBuffer );
+				callProcess( &mSummingBuffer, numProcessedFrames, true );
 
 			// copy summed buffer back to internal so downstream can get it.
 			dsp::mixBuffers( &mSummingBuffer, &mInternalBuffer );
@@ -376,6 +458,95 @@ void Node::pullInputs( Buffer *inPlaceBuffer )
 	}
 }
 
+// Returns the frame on the Context's clock for \a when seconds, making sure there is room to process part of a block. Never returns 0, which means nothing is scheduled.
+uint64_t Node::getScheduledFrame( double when )
+{
+	auto ctx = getContext();
+	CI_ASSERT( ctx );
+
+	// allocated before anything is first scheduled, so the audio thread can't be using it yet. From then on initializeImpl() resizes it.
+	if( ! mScheduledBuffer.getAllocatedSize() )
+		mScheduledBuffer.setSize( ctx->getFramesPerBlock(), mNumChannels );
+
+	return max<uint64_t>( 1, uint64_t( max( 0.0, when ) * double( ctx->getSampleRate() ) + 0.5 ) );
+}
+
+void Node::processScheduled( Buffer *buffer, uint64_t blockFrame, bool passThrough )
+{
+	const size_t numFrames = buffer->getNumFrames();
+	const uint64_t blockEnd = blockFrame + numFrames;
+	uint64_t startFrame = mScheduledStartFrame;
+	uint64_t stopFrame = mScheduledStopFrame;
+
+	size_t begin = 0;
+	size_t end = numFrames;
+	if( startFrame ) {
+		if( startFrame >= blockEnd )
+			begin = numFrames;
+		else {
+			if( startFrame > blockFrame )
+				begin = size_t( startFrame - blockFrame );
+
+			mScheduledStartFrame.compare_exchange_strong( startFrame, 0 );
+		}
+	}
+	if( stopFrame && stopFrame < blockEnd ) {
+		end = stopFrame > blockFrame ? size_t( stopFrame - blockFrame ) : 0;
+
+		// nothing past the stop frame is processed, until the housekeeping thread has called stop().
+		mReachedStopFrame = stopFrame;
+		auto ctx = getContext();
+		if( ctx )
+			ctx->mScheduledStopReached = true;
+	}
+
+	if( begin == 0 && end == numFrames ) {
+		callProcess( buffer );
+		return;
+	}
+
+	// nothing is processed this block. When passing through, the Buffer is only silent if the input was, which the caller accounts for.
+	if( begin >= end ) {
+		if( ! passThrough )
+			buffer->zero();
+
+		setSilent();
+		return;
+	}
+
+	const size_t numProcessFrames = end - begin;
+
+	// a mono view of the frames is contiguous, so it can be processed in place. Otherwise they're copied, so that process() gets aligned channels like those of a whole block.
+	BufferView scheduledView( buffer, begin, numProcessFrames );
+	if( scheduledView.isContiguous() ) {
+		if( ! passThrough )
+			buffer->zero();
+
+		callProcess( &scheduledView );
+		return;
+	}
+
+	// only shrinks to the frames processed, the buffer is already allocated for a whole block of this Node's channels.
+	if( mScheduledBuffer.getAllocatedSize() < numProcessFrames * buffer->getNumChannels() ) {
+		CI_ASSERT_MSG( 0, "mScheduledBuffer is too small, it should have been resized by initializeImpl()" );
+		buffer->zero();
+		setSilent();
+		return;
+	}
+
+	mScheduledBuffer.setSize( numProcessFrames, buffer->getNumChannels() );
+	if( passThrough )
+		mScheduledBuffer.copyOffset( *buffer, numProcessFrames, 0, begin );
+	else {
+		mScheduledBuffer.zero();
+		buffer->zero( 0, begin );
+		buffer->zero( end, numFrames - end );
+	}
+
+	callProcess( &mScheduledBuffer );
+	buffer->copyOffset( mScheduledBuffer, numProcessFrames, begin, 0 );
+}
+
 void Node::setupProcessWithSumming()
 {
 	CI_ASSERT( getContext() );
@@ -383,8 +554,18 @@ void Node::setupProcessWithSumming()
 	mProcessInPlace = false;
 	size_t framesPerBlock = getFramesPerBlock();
 
-	mInternalBuffer.setSize( framesPerBlock, mNumChannels );
-	mSummingBuffer.setSize( framesPerBlock, mNumChannels );
+	// the audio thread may be processing these buffers, so they are only touched when their size actually changes. They are
+	// moved to the Context's MemoryPool before they are first allocated.
+	MemoryPool *memoryPool = getContext()->getMemoryPool();
+	if( ! mInternalBuffer.getAllocatedSize() )
+		mInternalBuffer.setMemoryPool( memoryPool );
+	if( ! mSummingBuffer.getAllocatedSize() )
+		mSummingBuffer.setMemoryPool( memoryPool );
+
+	if( mInternalBuffer.getNumFrames() != framesPerBlock || mInternalBuffer.getNumChannels() != mNumChannels )
+		mInternalBuffer.setSize( framesPerBlock, mNumChannels );
+	if( mSummingBuffer.getNumFrames() != framesPerBlock || mSummingBuffer.getNumChannels() != mNumChannels )
+		mSummingBuffer.setSize( framesPerBlock, mNumChannels );
 }
 
 bool Node::checkCycle( const NodeRef &sourceNode, const NodeRef &destNode ) const
@@ -24,7 +24,9 @@
 #pragma once
 
 #include "cinder/audio2/Buffer.h"
+#include "cinder/audio2/MemoryPool.h"
 #include "cinder/audio2/Exception.h"
+#include "cinder/audio2/Profiler.h"
 
 #include <boost/noncopyable.hpp>
 #include <boost/logic/tribool.hpp>
@@ -38,6 +40,8 @@ namespace cinder { namespace audio2 {
 typedef std::shared_ptr<class Context>			ContextRef;
 typedef std::shared_ptr<class Node>				NodeRef;
 
+class Param;
+
 //! \brief Fundamental building block for creating an audio processing graph.
 //!
 //!	Node's allow for flexible combinations of synthesis, analysis, effects, file reading/writing, etc, and are designed so that
@@ -85,10 +89,24 @@ class Node : public std::enable_shared_from_this<Node>, public boost::noncopyabl
 
 	virtual ~Node();
 
+	//! Node's are allocated with MemoryPool::allocate(), from the heap unless placement new is used to allocate them from a MemoryPool. \see Context::makePooledNode()
+	static void*	operator new( size_t size )							{ return MemoryPool::allocate( nullptr, size ); }
+	static void*	operator new( size_t size, MemoryPool *memoryPool )	{ return MemoryPool::allocate( memoryPool, size ); }
+	static void		operator delete( void *ptr )						{ MemoryPool::deallocate( ptr ); }
+	static void		operator delete( void *ptr, MemoryPool *memoryPool )	{ MemoryPool::deallocate( ptr ); }
+
 	//! Enables this Node for processing. Same as setEnabled( true ).
 	virtual void start()		{ mEnabled = true; }
 	//! Disables this Node for processing. Same as setEnabled( false ).
 	virtual void stop()			{ mEnabled = false; }
+	//! Schedules this Node to start at \a when seconds on the Context's frame clock (see Context::getNumProcessedSeconds()). start() is called
+	//! right away, but the Node isn't processed until \a when, and if that falls within a block only the frames from that point on are processed.
+	//! A scheduled stop at or before \a when is cancelled.
+	void start( double when );
+	//! Schedules this Node to stop at \a when seconds on the Context's frame clock, processing only the frames before that point in the block it falls in.
+	//! The audio thread processes the Node no further and the housekeeping thread then calls stop(). If \a when has already passed, stop() is called right away.
+	//! A stop at or before a pending scheduled start is discarded, so start( when ) and stop( when ) give the same result in either order.
+	void stop( double when );
 	//! Sets whether this Node is enabled for processing or not.
 	void setEnabled( bool b = true );
 	//! Returns whether this Node is enabled for processing or not.
@@ -139,6 +157,8 @@ class Node : public std::enable_shared_from_this<Node>, public boost::noncopyabl
 	const InputsContainerT&		getInputs() const		{ return mInputs; }
 	OutputsContainerT&			getOutputs()			{ return mOutputs; }
 	const OutputsContainerT&	getOutputs() const		{ return mOutputs; }
+	//! Returns the Param's that have this Node as their parent, in the order they were constructed.
+	const std::vector<Param *>&	getParams() const		{ return mParams; }
 
 	//! Returns a vector of the currently occupied input busses.
 	std::vector<size_t> getOccupiedInputBusses() const;
@@ -154,6 +174,17 @@ class Node : public std::enable_shared_from_this<Node>, public boost::noncopyabl
 	//! Returns whether this Node will process audio with an in-place Buffer.
 	bool getProcessInPlace() const				{ return mProcessInPlace; }
 
+	//! Returned by getTailFrames() when a Node must be processed even though its inputs are silent.
+	static const size_t TAIL_INFINITE = size_t( -1 );
+	//! Returns the number of frames this Node continues to produce output for after its inputs become silent, for example the length of a delay line.
+	//! Once its inputs have been silent for longer than this, the Node isn't processed until they aren't. Default returns TAIL_INFINITE.
+	virtual size_t getTailFrames() const		{ return TAIL_INFINITE; }
+
+#if defined( CINDER_AUDIO_PROFILING )
+	//! Returns the durations of this Node's process() calls. \see Context::getProfileSnapshot()
+	ProcessProfile& getProcessProfile()			{ return mProcessProfile; }
+#endif
+
 	//! Returns a string representing the name of this Node type. TODO: use typeid + abi de-mangling to ease the burden on sub-classes
 	virtual std::string getName();
 
@@ -184,12 +215,20 @@ class Node : public std::enable_shared_from_this<Node>, public boost::noncopyabl
 	virtual void initialize()	{}
 	//! Called once the contents of initialize are no longer relevant, i.e. connections have changed. \note Not guaranteed to be called at Node destruction.
 	virtual void uninitialize()	{}
-	//! Override to perform audio processing on \t buffer.
+	//! Override to perform audio processing on \t buffer. \note Unless \a buffer->isContiguous() returns true, its channels must be accessed with getChannel().
 	virtual void process( Buffer *buffer )	{}
 	//! Default implementation returns true if numChannels matches our format.
 	virtual bool supportsInputNumChannels( size_t numChannels ) const	{ return mNumChannels == numChannels; }
 	//! Default implementation returns false, return true if it makes sense for the Node to be processed in a cycle (eg. Delay).
 	virtual bool supportsCycles() const									{ return false; }
+	//! Called from process() by Node's that have filled \a buffer with silence for the current block, which allows downstream Node's to skip it.
+	void setSilent()													{ mSilent = true; }
+	//! Calls process( \a buffer ), timing it if CINDER_AUDIO_PROFILING is defined. Pulling implementations should process through this.
+	void callProcess( Buffer *buffer );
+	//! Calls process( \a buffer ) for the block beginning at \a blockFrame. If a scheduled start or stop falls within the block, only the frames
+	//! between them are processed and the rest are passed through if \a passThrough is true, otherwise they are zeroed.
+	//! \note process() is then called with fewer frames than getFramesPerBlock().
+	void callProcess( Buffer *buffer, uint64_t blockFrame, bool passThrough );
 
 	//! Stores \a input at bus \a inputBus, replacing any Node currently existing there. Stores this Node at input's output bus \a outputBus. Returns whether a new connection was made or not.
 	//! \note Must be called on a non-audio thread and synchronized with the Context's mutex.
@@ -225,18 +264,58 @@ class Node : public std::enable_shared_from_this<Node>, public boost::noncopyabl
 	size_t					mNumChannels;
 	ChannelMode				mChannelMode;
 	uint64_t				mLastProcessedFrame;
+	bool					mSilent;
+	uint64_t				mNumSilentInputFrames;
 
 	BufferDynamic			mInternalBuffer, mSummingBuffer;
 
   private:
+#if defined( CINDER_AUDIO_PROFILING )
+	ProcessProfile			mProcessProfile;
+#endif
+
+	void processScheduled( Buffer *buffer, uint64_t blockFrame, bool passThrough );
+	uint64_t getScheduledFrame( double when );
+	void finishScheduledStop();
+
+	// frames at which the audio thread starts or stops processing this Node, 0 if none is scheduled. mScheduledBuffer holds the
+	// part of a block that is processed, it is allocated the first time something is scheduled and resized by initializeImpl().
+	std::atomic<uint64_t>	mScheduledStartFrame, mScheduledStopFrame;
+	BufferDynamic			mScheduledBuffer;
+	// set by the audio thread to the mScheduledStopFrame it has reached, so that the housekeeping thread calls stop().
+	std::atomic<uint64_t>	mReachedStopFrame;
 
 	void setContext( const ContextRef &context )	{ mContext = context; }
 
 	std::weak_ptr<Context>	mContext;
+	// maintained by Param's constructor and destructor.
+	std::vector<Param *>	mParams;
+
 	friend class Context;
+	friend class GraphPrototype;
 	friend class Param;
+	friend class RenderGraph;
 };
 
+inline void Node::callProcess( Buffer *buffer )
+{
+#if defined( CINDER_AUDIO_PROFILING )
+	ProfileClock::time_point begin = ProfileClock::now();
+	process( buffer );
+	mProcessProfile.record( begin );
+#else
+	process( buffer );
+#endif
+}
+
+inline void Node::callProcess( Buffer *buffer, uint64_t blockFrame, bool passThrough )
+{
+	if( mScheduledStartFrame.load( std::memory_order_relaxed ) || mScheduledStopFrame.load( std::memory_order_relaxed ) )
+		processScheduled( buffer, blockFrame, passThrough );
+	else
+		callProcess( buffer );
+}
+
 //! Enable connection syntax: \code input >> output; \endcode. Connects on the first available input and output bus.  \return the connected \a output
 inline const NodeRef& operator>>( const NodeRef &input, const NodeRef &output )
 {
@@ -65,8 +65,21 @@ void Gain::process( Buffer *buffer )
 			dsp::mul( channel, mParam.getValueArray(), channel, buffer->getNumFrames() );
 		}
 	}
-	else
-		dsp::mul( buffer->getData(), mParam.getValue(), buffer->getData(), buffer->getSize() );
+	else {
+		float value = mParam.getValue();
+		if( value == 0 ) {
+			buffer->zero();
+			setSilent();
+		}
+		else if( buffer->isContiguous() )
+			dsp::mul( buffer->getData(), value, buffer->getData(), buffer->getSize() );
+		else {
+			for( size_t ch = 0; ch < mNumChannels; ch++ ) {
+				float *channel = buffer->getChannel( ch );
+				dsp::mul( channel, value, channel, buffer->getNumFrames() );
+			}
+		}
+	}
 }
 
 // ----------------------------------------------------------------------------------------------------
@@ -95,8 +108,15 @@ void Add::process( Buffer *buffer )
 			dsp::add( channel, mParam.getValueArray(), channel, buffer->getNumFrames() );
 		}
 	}
-	else
+	else if( buffer->isContiguous() )
 		dsp::add( buffer->getData(), mParam.getValue(), buffer->getData(), buffer->getSize() );
+	else {
+		const float value = mParam.getValue();
+		for( size_t ch = 0; ch < mNumChannels; ch++ ) {
+			float *channel = buffer->getChannel( ch );
+			dsp::add( channel, value, channel, buffer->getNumFrames() );
+		}
+	}
 }
 
 // ----------------------------------------------------------------------------------------------------
@@ -159,7 +179,7 @@ void Pan2d::pullInputs( Buffer *destBuffer )
 		}
 
 		if( mEnabled )
-			process( &mSummingBuffer );
+			callProcess( &mSummingBuffer );
 
 		// at this point, audio will be in both stereo channels
 
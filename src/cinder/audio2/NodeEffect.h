@@ -59,6 +59,9 @@ class Gain : public NodeEffect {
 	void setMax( float max )		{ mMax = max; }
 	float getMax() const			{ return mMax; }
 
+	//! Returns 0, the output is silent as soon as the input is.
+	size_t getTailFrames() const override	{ return 0; }
+
   protected:
 	void process( Buffer *buffer ) override;
 
@@ -98,6 +101,9 @@ class Pan2d : public NodeEffect {
 	void enableMonoInputMode( bool enable = true )	{ mMonoInputMode = enable; }
 	bool isMonoInputModeEnabled() const				{ return mMonoInputMode; }
 
+	//! Returns 0, the output is silent as soon as the input is.
+	size_t getTailFrames() const override			{ return 0; }
+
 protected:
 	void process( Buffer *buffer ) override;
 
@@ -118,6 +124,9 @@ class Delay : public NodeEffect {
 	void	setDelaySeconds( float seconds );
 	float	getDelaySeconds() const				{ return mDelaySeconds; }
 
+	//! Returns the length of the delay line, which keeps producing output until silence has been written to all of it.
+	size_t	getTailFrames() const override		{ return mDelayBuffer.getNumFrames(); }
+
   protected:
 	void initialize()				override;
 	void process( Buffer *buffer )	override;
@@ -36,7 +36,8 @@ namespace cinder { namespace audio2 {
 // ----------------------------------------------------------------------------------------------------
 
 NodeOutput::NodeOutput( const Format &format )
-	: Node( format ), mNumProcessedFrames( 0 ), mClipDetectionEnabled( true ), mClipThreshold( 2 ), mLastClip( 0 )
+	: Node( format ), mNumProcessedFrames( 0 ), mClipDetectionEnabled( true ), mClipThreshold( 2 ), mLastClip( 0 ), mNumDeadlineMisses( 0 ), mLastDeadlineMiss( 0 ),
+		mNumOverBudget( 0 ), mCpuBudget( 1 )
 {
 }
 
@@ -45,12 +46,44 @@ void NodeOutput::connect( const NodeRef &output, size_t outputBus, size_t inputB
 	CI_ASSERT_MSG( 0, "NodeOutput does not support outputs" );
 }
 
+void NodeOutput::processGraph()
+{
+	mRenderBeginTime = ProfileClock::now();
+
+	auto ctx = getContext();
+	if( ctx->getOutput().get() == this )
+		ctx->processRenderGraph();
+	else
+		pullInputs( &mInternalBuffer );
+}
+
 void NodeOutput::postProcess()
 {
 	getContext()->processAutoPulledNodes();
+
+	uint64_t renderNanos = (uint64_t)chrono::duration_cast<chrono::nanoseconds>( ProfileClock::now() - mRenderBeginTime ).count();
+	mRenderProfile.record( renderNanos );
+
+	double renderSeconds = double( renderNanos ) * 1e-9;
+	double deadlineSeconds = getBlockDeadlineSeconds();
+	if( renderSeconds > deadlineSeconds ) {
+		mNumDeadlineMisses++;
+		mLastDeadlineMiss = getNumProcessedFrames();
+	}
+	if( renderSeconds > deadlineSeconds * mCpuBudget.load( memory_order_relaxed ) )
+		mNumOverBudget++;
+
 	incrementFrameCount();
 }
 
+void NodeOutput::resetRenderStats()
+{
+	mRenderProfile.reset();
+	mNumDeadlineMisses = 0;
+	mLastDeadlineMiss = 0;
+	mNumOverBudget = 0;
+}
+
 uint64_t NodeOutput::getLastClip()
 {
 	uint64_t result = mLastClip;
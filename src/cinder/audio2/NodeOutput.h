@@ -25,6 +25,7 @@
 
 #include "cinder/audio2/Node.h"
 #include "cinder/audio2/Device.h"
+#include "cinder/audio2/Profiler.h"
 
 namespace cinder { namespace audio2 {
 
@@ -49,9 +50,31 @@ class NodeOutput : public Node {
 	//! Returns the total number of frames that have already been processed in the dsp loop.
 	uint64_t getNumProcessedFrames() const		{ return mNumProcessedFrames; }
 
+	//! Returns statistics of how long each render cycle took, from processGraph() to the end of postProcess(). Can be polled from any thread without locking.
+	ProfileStats getRenderStats() const					{ return mRenderProfile.getStats(); }
+	//! Returns the histogram of render cycle durations that getRenderStats() is computed from, for monitoring that needs the full distribution.
+	const ProcessProfile& getRenderProfile() const		{ return mRenderProfile; }
+	//! Returns the number of render cycles that took longer than getBlockDeadlineSeconds().
+	uint64_t getNumDeadlineMisses() const				{ return mNumDeadlineMisses; }
+	//! Returns the frame of the block whose render cycle last missed its deadline, or 0 if none since the last time this method was called.
+	uint64_t getLastDeadlineMiss()						{ return mLastDeadlineMiss.exchange( 0 ); }
+	//! Returns the duration of one block in seconds, which is the time each render cycle has to complete in.
+	double getBlockDeadlineSeconds()					{ return double( getOutputFramesPerBlock() ) / double( getOutputSampleRate() ); }
+	//! Clears the render cycle statistics, deadline misses and blocks over budget.
+	void resetRenderStats();
+
+	//! Sets the fraction of each block's deadline that rendering is expected to fit in, for example 1 / N when N Context's share one core. Default is 1.
+	void setCpuBudget( double fraction )				{ mCpuBudget = fraction; }
+	//! Returns the fraction of each block's deadline that rendering is expected to fit in.
+	double getCpuBudget() const							{ return mCpuBudget; }
+	//! Returns the number of render cycles that took longer than getCpuBudget() times getBlockDeadlineSeconds().
+	uint64_t getNumOverBudget() const					{ return mNumOverBudget; }
+
   protected:
 	NodeOutput( const Format &format = Format() );
 
+	//! Implementations should call this to process the Context's RenderGraph into the internal buffer, once per rendering block. Falls back to pullInputs() if this is not the Context's output.
+	void processGraph();
 	//! Implementations should call this to detect if the internal audio buffer is clipping. Always returns false if clip detection is disabled.
 	bool checkNotClipping();
 	//! Implementations should call this at the end of each rendering block.
@@ -61,6 +84,11 @@ class NodeOutput : public Node {
 	bool						mClipDetectionEnabled;
 	float						mClipThreshold;
 
+	ProcessProfile				mRenderProfile;
+	ProfileClock::time_point	mRenderBeginTime;
+	std::atomic<uint64_t>		mNumDeadlineMisses, mLastDeadlineMiss, mNumOverBudget;
+	std::atomic<double>			mCpuBudget;
+
   private:
 	// NodeOutput does not have outputs, overridden to assert this method isn't called
 	void connect( const NodeRef &output, size_t outputBus, size_t inputBus ) override;
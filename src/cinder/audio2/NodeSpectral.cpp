@@ -0,0 +1,191 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/audio2/NodeSpectral.h"
+#include "cinder/audio2/Context.h"
+#include "cinder/audio2/dsp/Dsp.h"
+#include "cinder/audio2/Utilities.h"
+#include "cinder/audio2/Debug.h"
+
+#include "cinder/CinderMath.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+using namespace ci;
+
+namespace cinder { namespace audio2 {
+
+NodeSpectral::NodeSpectral( const Format &format )
+	: NodeEffect( format ), mFftSize( format.getFftSize() ), mHopSize( format.getHopSize() ), mWindowType( format.getWindowType() ),
+		mFramePos( 0 ), mRenderProcessors( nullptr )
+{
+	if( mFftSize < 2 )
+		mFftSize = 2;
+	if( ! isPowerOf2( mFftSize ) )
+		mFftSize = nextPowerOf2( static_cast<uint32_t>( mFftSize ) );
+
+	// the hop must divide the FFT size so that every output frame is covered by the same windows.
+	size_t overlap = mHopSize ? max<size_t>( 1, ( mFftSize + mHopSize / 2 ) / mHopSize ) : 4;
+	if( ! isPowerOf2( overlap ) )
+		overlap = nextPowerOf2( static_cast<uint32_t>( overlap ) );
+
+	mHopSize = max<size_t>( 1, mFftSize / overlap );
+}
+
+NodeSpectral::~NodeSpectral()
+{
+}
+
+void NodeSpectral::initialize()
+{
+	mFft.reset( new dsp::Fft( mFftSize ) );
+	mSpectral = BufferSpectral( mFftSize );
+	mFrameBuffer = Buffer( mFftSize );
+
+	mWindow = dsp::getWindow( mWindowType, mFftSize );
+	const float *window = mWindow->getData();
+
+	// Each output frame is the sum of the squared windows of every STFT frame that overlapped it, which only depends on its
+	// position within the hop. Dividing by that sum reconstructs the input for any window.
+	mWindowNormalizer = Buffer( mHopSize );
+	for( size_t i = 0; i < mHopSize; i++ ) {
+		float sum = 0;
+		for( size_t j = i; j < mFftSize; j += mHopSize )
+			sum += window[j] * window[j];
+
+		mWindowNormalizer[i] = sum > 1e-6f ? 1.0f / sum : 0.0f;
+	}
+
+	mInputFifo = Buffer( mFftSize, mNumChannels );
+	mOverlapAddBuffer = Buffer( mFftSize, mNumChannels );
+	mOutputFifo = Buffer( mHopSize, mNumChannels );
+	mFramePos = mFftSize - mHopSize;
+}
+
+void NodeSpectral::process( Buffer *buffer )
+{
+	const size_t numFrames = buffer->getNumFrames();
+	const size_t keepFrames = mFftSize - mHopSize;
+
+	size_t readPos = 0;
+	while( readPos < numFrames ) {
+		size_t count = min( numFrames - readPos, mFftSize - mFramePos );
+
+		// the input is collected before it is overwritten in place by the output.
+		for( size_t ch = 0; ch < mNumChannels; ch++ ) {
+			float *channel = buffer->getChannel( ch ) + readPos;
+			memcpy( mInputFifo.getChannel( ch ) + mFramePos, channel, count * sizeof( float ) );
+			memcpy( channel, mOutputFifo.getChannel( ch ) + mFramePos - keepFrames, count * sizeof( float ) );
+		}
+
+		readPos += count;
+		mFramePos += count;
+
+		if( mFramePos == mFftSize ) {
+			processFrame();
+			mFramePos = keepFrames;
+		}
+	}
+}
+
+void NodeSpectral::processFrame()
+{
+	const ProcessorList *processors = mRenderProcessors;
+	const size_t keepFrames = mFftSize - mHopSize;
+
+	for( size_t ch = 0; ch < mNumChannels; ch++ ) {
+		float *input = mInputFifo.getChannel( ch );
+		float *overlapAdd = mOverlapAddBuffer.getChannel( ch );
+		float *frame = mFrameBuffer.getData();
+
+		dsp::mul( input, mWindow->getData(), frame, mFftSize );
+		mFft->forward( &mFrameBuffer, &mSpectral );
+
+		if( processors ) {
+			for( const SpectralProcessorRef &processor : *processors )
+				processor->process( &mSpectral, ch );
+		}
+
+		mFft->inverse( &mSpectral, &mFrameBuffer );
+		dsp::mul( frame, mWindow->getData(), frame, mFftSize );
+		dsp::add( overlapAdd, frame, overlapAdd, mFftSize );
+
+		// the first hop of the overlap-add buffer has received all of its frames, so it is output next.
+		dsp::mul( overlapAdd, mWindowNormalizer.getData(), mOutputFifo.getChannel( ch ), mHopSize );
+
+		memmove( overlapAdd, overlapAdd + mHopSize, keepFrames * sizeof( float ) );
+		memset( overlapAdd + keepFrames, 0, mHopSize * sizeof( float ) );
+		memmove( input, input + mHopSize, keepFrames * sizeof( float ) );
+	}
+}
+
+void NodeSpectral::addProcessor( const SpectralProcessorRef &processor )
+{
+	lock_guard<mutex> lock( getContext()->getMutex() );
+
+	auto processors = mProcessors ? make_shared<ProcessorList>( *mProcessors ) : make_shared<ProcessorList>();
+	processors->push_back( processor );
+	publishProcessors( processors );
+}
+
+void NodeSpectral::removeProcessor( const SpectralProcessorRef &processor )
+{
+	lock_guard<mutex> lock( getContext()->getMutex() );
+
+	if( ! mProcessors )
+		return;
+
+	auto processors = make_shared<ProcessorList>( *mProcessors );
+	processors->erase( remove( processors->begin(), processors->end(), processor ), processors->end() );
+	if( processors->empty() )
+		processors.reset();
+
+	publishProcessors( processors );
+}
+
+void NodeSpectral::clearProcessors()
+{
+	lock_guard<mutex> lock( getContext()->getMutex() );
+	publishProcessors( nullptr );
+}
+
+vector<SpectralProcessorRef> NodeSpectral::getProcessors() const
+{
+	lock_guard<mutex> lock( getContext()->getMutex() );
+	return mProcessors ? *mProcessors : vector<SpectralProcessorRef>();
+}
+
+void NodeSpectral::publishProcessors( const shared_ptr<ProcessorList> &processors )
+{
+	shared_ptr<ProcessorList> retiredProcessors = mProcessors;
+
+	mProcessors = processors;
+	mRenderProcessors = processors.get();
+
+	// the audio thread may still be running the previous chain
+	getContext()->retire( retiredProcessors );
+}
+
+} } // namespace cinder::audio2
@@ -0,0 +1,136 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/audio2/NodeEffect.h"
+#include "cinder/audio2/dsp/Fft.h"
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+namespace cinder { namespace audio2 {
+
+typedef std::shared_ptr<class NodeSpectral>				NodeSpectralRef;
+typedef std::shared_ptr<class SpectralProcessor>		SpectralProcessorRef;
+
+//! \brief Interface for effects that operate in the frequency domain, run by a NodeSpectral.
+//!
+//! Each STFT frame is passed through every SpectralProcessor in a NodeSpectral's chain before it is transformed back, so the whole chain shares one forward and one inverse FFT.
+class SpectralProcessor {
+  public:
+	virtual ~SpectralProcessor() {}
+
+	//! Called on the audio thread for each channel of each STFT frame. \a spectral holds getFftSize() / 2 bins, which can be modified in place.
+	//! \note As with dsp::Fft, the real part of the Nyquist bin is stored in the imaginary part of bin 0.
+	virtual void process( BufferSpectral *spectral, size_t channel ) = 0;
+};
+
+//! Callback used by SpectralCallbackProcessor. First parameter is the spectral frame to modify in place, second is the channel.
+typedef std::function<void( BufferSpectral *, size_t )> SpectralProcessorFn;
+
+//! SpectralProcessor that processes each frame with a std::function callback. \see SpectralProcessorFn
+class SpectralCallbackProcessor : public SpectralProcessor {
+  public:
+	SpectralCallbackProcessor( const SpectralProcessorFn &fn ) : mFn( fn )	{}
+
+	void process( BufferSpectral *spectral, size_t channel ) override	{ mFn( spectral, channel ); }
+
+  private:
+	SpectralProcessorFn mFn;
+};
+
+//! \brief NodeEffect that runs a chain of SpectralProcessor's on a windowed, overlap-add short-time Fourier transform of its input.
+//!
+//! Every hop size frames, the most recent FFT size frames of input are windowed and transformed with a dsp::Fft. The frame is passed
+//! through each SpectralProcessor, transformed back and windowed again, then overlap-added to the output. The output is normalized
+//! for the window and hop, so with no processors the input is reconstructed, delayed by getLatencyFrames().
+class NodeSpectral : public NodeEffect {
+  public:
+	struct Format : public Node::Format {
+		Format() : mFftSize( 1024 ), mHopSize( 0 ), mWindowType( dsp::WindowType::HANN ) {}
+
+		//! Sets the FFT size, rounded up to the nearest power of 2. Default is 1024.
+		Format&		fftSize( size_t size )				{ mFftSize = size; return *this; }
+		//! Sets the number of frames between the start of consecutive STFT frames, rounded so that it divides the FFT size. Default is a quarter of the FFT size.
+		Format&		hopSize( size_t size )				{ mHopSize = size; return *this; }
+		//! Sets the window applied before the forward and after the inverse transform. Default is WindowType::HANN.
+		Format&		windowType( dsp::WindowType type )	{ mWindowType = type; return *this; }
+		//! \see Node::Format::channels()
+		Format&		channels( size_t ch )				{ Node::Format::channels( ch ); return *this; }
+
+		size_t			getFftSize() const				{ return mFftSize; }
+		size_t			getHopSize() const				{ return mHopSize; }
+		dsp::WindowType	getWindowType() const			{ return mWindowType; }
+
+	  protected:
+		size_t			mFftSize, mHopSize;
+		dsp::WindowType	mWindowType;
+	};
+
+	NodeSpectral( const Format &format = Format() );
+	virtual ~NodeSpectral();
+
+	//! Appends \a processor to the end of the chain. The audio thread picks up the new chain at its next STFT frame.
+	void addProcessor( const SpectralProcessorRef &processor );
+	//! Removes \a processor from the chain.
+	void removeProcessor( const SpectralProcessorRef &processor );
+	//! Removes all processors from the chain.
+	void clearProcessors();
+	//! Returns the chain of SpectralProcessor's, in the order they are run.
+	std::vector<SpectralProcessorRef> getProcessors() const;
+
+	size_t			getFftSize() const			{ return mFftSize; }
+	size_t			getHopSize() const			{ return mHopSize; }
+	dsp::WindowType	getWindowType() const		{ return mWindowType; }
+	//! Returns the number of frames the output is delayed by, which is the FFT size. A hop of output is complete once the STFT frame that starts with it has been processed.
+	size_t			getLatencyFrames() const	{ return mFftSize; }
+
+  protected:
+	void initialize() override;
+	void process( Buffer *buffer ) override;
+
+  private:
+	typedef std::vector<SpectralProcessorRef>	ProcessorList;
+
+	void processFrame();
+	void publishProcessors( const std::shared_ptr<ProcessorList> &processors );
+
+	size_t					mFftSize, mHopSize;
+	dsp::WindowType			mWindowType;
+	std::unique_ptr<dsp::Fft>	mFft;
+
+	// mInputFifo collects input until a frame is due, mOutputFifo holds the previous frame's finished output. mFramePos is the
+	// write position in mInputFifo, it restarts at the FFT size minus the hop size once a frame has been processed.
+	Buffer					mInputFifo, mOutputFifo, mOverlapAddBuffer;
+	Buffer					mWindowNormalizer, mFrameBuffer;
+	std::shared_ptr<const Buffer>	mWindow;		// shared with other Node's that use the same window type and FFT size
+	BufferSpectral			mSpectral;
+	size_t					mFramePos;
+
+	std::shared_ptr<ProcessorList>	mProcessors;
+	std::atomic<ProcessorList *>	mRenderProcessors; // mProcessors as seen by the audio thread
+};
+
+} } // namespace cinder::audio2
@@ -0,0 +1,199 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/audio2/NodeSubgraph.h"
+#include "cinder/audio2/NodeInput.h"
+#include "cinder/audio2/Debug.h"
+
+using namespace std;
+
+namespace cinder { namespace audio2 {
+
+namespace {
+
+size_t greatestCommonDivisor( size_t a, size_t b )
+{
+	while( b ) {
+		size_t r = a % b;
+		a = b;
+		b = r;
+	}
+	return a;
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------------------------------
+// MARK: - NodeSubgraph::InputNode
+// ----------------------------------------------------------------------------------------------------
+
+// Reads one sub-graph block from the NodeSubgraph's input RingBuffer's, which are filled before each block is rendered.
+class NodeSubgraph::InputNode : public NodeInput {
+  public:
+	InputNode( NodeSubgraph *subgraph, size_t numChannels )
+		: NodeInput( Format().channels( numChannels ).autoEnable() ), mSubgraph( subgraph )
+	{}
+
+  protected:
+	void process( Buffer *buffer ) override
+	{
+		for( size_t ch = 0; ch < buffer->getNumChannels(); ch++ )
+			mSubgraph->mInputRingBuffers[ch].read( buffer->getChannel( ch ), buffer->getNumFrames() );
+	}
+
+  private:
+	NodeSubgraph *mSubgraph;
+};
+
+// ----------------------------------------------------------------------------------------------------
+// MARK: - NodeSubgraph
+// ----------------------------------------------------------------------------------------------------
+
+NodeSubgraph::NodeSubgraph( const Format &format )
+	: NodeEffect( format ), mOversample( max<size_t>( 1, format.getOversample() ) ), mSubgraphFramesPerBlock( format.getFramesPerBlock() ), mLatencyFrames( 0 )
+{
+	if( mChannelMode != ChannelMode::SPECIFIED ) {
+		mChannelMode = ChannelMode::SPECIFIED;
+		setNumChannels( 2 );
+	}
+}
+
+NodeSubgraph::~NodeSubgraph()
+{
+}
+
+const ContextOfflineRef& NodeSubgraph::getSubgraphContext()
+{
+	if( ! mSubgraphContext ) {
+		if( ! mSubgraphFramesPerBlock )
+			mSubgraphFramesPerBlock = getFramesPerBlock() * mOversample;
+
+		// each sub-graph block must downsample to a whole number of frames.
+		mSubgraphFramesPerBlock = ( ( mSubgraphFramesPerBlock + mOversample - 1 ) / mOversample ) * mOversample;
+
+		mSubgraphContext = ContextOffline::create( getSampleRate() * mOversample, mSubgraphFramesPerBlock, mNumChannels );
+		mSubgraphInput = mSubgraphContext->makeNode( new InputNode( this, mNumChannels ) );
+
+		// the output is only an intermediate result here, it isn't sent to a device.
+		mSubgraphContext->getOutput()->enableClipDetection( false );
+	}
+
+	return mSubgraphContext;
+}
+
+const NodeRef& NodeSubgraph::getSubgraphInput()
+{
+	getSubgraphContext();
+	return mSubgraphInput;
+}
+
+void NodeSubgraph::initialize()
+{
+	const size_t sampleRate = getSampleRate();
+	const size_t framesPerBlock = getFramesPerBlock();
+
+	// the Context's samplerate has changed, the sub-graph can't follow it so it is replaced with an empty one.
+	if( mSubgraphContext && mSubgraphContext->getSampleRate() != sampleRate * mOversample ) {
+		CI_LOG_W( "samplerate is now " << sampleRate << ", recreating the sub-graph Context (was " << mSubgraphContext->getSampleRate() << ")." );
+		mSubgraphInput.reset();
+		mSubgraphContext.reset();
+	}
+
+	const auto &subgraphContext = getSubgraphContext();
+
+	if( mOversample > 1 ) {
+		mUpConverter = dsp::Converter::create( sampleRate, sampleRate * mOversample, mNumChannels, mNumChannels, framesPerBlock );
+		mDownConverter = dsp::Converter::create( sampleRate * mOversample, sampleRate, mNumChannels, mNumChannels, mSubgraphFramesPerBlock );
+		mUpConvertBuffer.setSize( mUpConverter->getDestMaxFramesPerBlock(), mNumChannels );
+		mDownConvertBuffer = Buffer( mDownConverter->getDestMaxFramesPerBlock(), mNumChannels );
+	}
+	else {
+		mUpConverter.reset();
+		mDownConverter.reset();
+	}
+
+	// A sub-graph block is only rendered once enough input has been buffered for it, so reading a block of output can come up short
+	// by at most this many frames. The output is primed with that much silence, after which it can always be read in full.
+	const size_t inputFramesPerBlock = framesPerBlock * mOversample;
+	const size_t primeFrames = mSubgraphFramesPerBlock - greatestCommonDivisor( inputFramesPerBlock, mSubgraphFramesPerBlock );
+	mLatencyFrames = ( primeFrames + mOversample - 1 ) / mOversample;
+
+	mSubgraphBuffer = Buffer( mSubgraphFramesPerBlock, mNumChannels );
+
+	const size_t ringBufferFrames = 2 * ( mSubgraphFramesPerBlock + inputFramesPerBlock );
+	mInputRingBuffers.clear();
+	mOutputRingBuffers.clear();
+	for( size_t ch = 0; ch < mNumChannels; ch++ ) {
+		mInputRingBuffers.emplace_back( ringBufferFrames );
+		mOutputRingBuffers.emplace_back( ringBufferFrames );
+		mOutputRingBuffers.back().write( mSubgraphBuffer.getChannel( ch ), mLatencyFrames );
+	}
+
+	// started here rather than by the first render, which would initialize the sub-graph's output on the audio thread.
+	subgraphContext->start();
+}
+
+void NodeSubgraph::process( Buffer *buffer )
+{
+	const size_t numFrames = buffer->getNumFrames();
+
+	const Buffer *inputBuffer = buffer;
+	size_t numInputFrames = numFrames;
+	if( mUpConverter ) {
+		numInputFrames = mUpConverter->convert( buffer, &mUpConvertBuffer ).second;
+		inputBuffer = &mUpConvertBuffer;
+	}
+
+	for( size_t ch = 0; ch < mNumChannels; ch++ )
+		mInputRingBuffers[ch].write( inputBuffer->getChannel( ch ), numInputFrames );
+
+	while( mInputRingBuffers[0].getAvailableRead() >= mSubgraphFramesPerBlock )
+		renderSubgraphBlock();
+
+	// the resamplers don't output anything until they have filled up, until then the output is silent.
+	if( mOutputRingBuffers[0].getAvailableRead() < numFrames ) {
+		buffer->zero();
+		setSilent();
+		return;
+	}
+
+	for( size_t ch = 0; ch < mNumChannels; ch++ )
+		mOutputRingBuffers[ch].read( buffer->getChannel( ch ), numFrames );
+}
+
+void NodeSubgraph::renderSubgraphBlock()
+{
+	mSubgraphContext->render( &mSubgraphBuffer );
+
+	const Buffer *outputBuffer = &mSubgraphBuffer;
+	size_t numOutputFrames = mSubgraphFramesPerBlock;
+	if( mDownConverter ) {
+		numOutputFrames = mDownConverter->convert( &mSubgraphBuffer, &mDownConvertBuffer ).second;
+		outputBuffer = &mDownConvertBuffer;
+	}
+
+	for( size_t ch = 0; ch < mNumChannels; ch++ )
+		mOutputRingBuffers[ch].write( outputBuffer->getChannel( ch ), numOutputFrames );
+}
+
+} } // namespace cinder::audio2
@@ -0,0 +1,103 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/audio2/NodeEffect.h"
+#include "cinder/audio2/ContextOffline.h"
+#include "cinder/audio2/dsp/Converter.h"
+#include "cinder/audio2/dsp/RingBuffer.h"
+
+#include <vector>
+
+namespace cinder { namespace audio2 {
+
+typedef std::shared_ptr<class NodeSubgraph>		NodeSubgraphRef;
+
+//! \brief NodeEffect that processes a graph of child Node's at a different block size and / or an oversampled samplerate.
+//!
+//! The child Node's belong to a ContextOffline owned by the NodeSubgraph, which renders one of its blocks each time enough input has been
+//! buffered. When oversampling, the input is upsampled and the output downsampled with dsp::Converter's. Both directions are buffered in dsp::RingBuffer's.
+//! \code
+//! auto subgraph = ctx->makeNode( new audio2::NodeSubgraph( audio2::NodeSubgraph::Format().oversample( 4 ) ) );
+//! auto subCtx = subgraph->getSubgraphContext();
+//! subgraph->getSubgraphInput() >> subCtx->makeNode( new MyDistortion ) >> subCtx->getOutput();
+//! input >> subgraph >> ctx->getOutput();
+//! \endcode
+//! \note Buffering whole sub-graph blocks delays the output by getLatencyFrames(). When oversampling, the resamplers add their own delay on top of that.
+class NodeSubgraph : public NodeEffect {
+  public:
+	struct Format : public Node::Format {
+		Format() : mFramesPerBlock( 0 ), mOversample( 1 ) {}
+
+		//! Sets the number of frames the sub-graph processes per block, at its own samplerate. Default is the Context's frames-per-block times the oversampling factor.
+		Format& framesPerBlock( size_t frames )		{ mFramesPerBlock = frames; return *this; }
+		//! Sets how many times higher the sub-graph's samplerate is than the Context's. Default is 1.
+		Format& oversample( size_t factor )			{ mOversample = factor; return *this; }
+		//! \see Node::Format::channels()
+		Format& channels( size_t ch )				{ Node::Format::channels( ch ); return *this; }
+
+		size_t getFramesPerBlock() const			{ return mFramesPerBlock; }
+		size_t getOversample() const				{ return mOversample; }
+
+	  protected:
+		size_t mFramesPerBlock, mOversample;
+	};
+
+	//! Constructs a NodeSubgraph. \note Channel mode is always ChannelMode::SPECIFIED, with 2 channels unless Format::channels() is set.
+	NodeSubgraph( const Format &format = Format() );
+	virtual ~NodeSubgraph();
+
+	//! Returns the ContextOffline that the sub-graph's Node's must be made with. Whatever is connected to its output is this Node's output.
+	//! \note It is created on the first call, so this Node must already have been made with Context::makeNode(). If the Context's samplerate
+	//! later changes, initialize() replaces it with a new, empty ContextOffline at the new samplerate and the sub-graph must be rebuilt.
+	const ContextOfflineRef&	getSubgraphContext();
+	//! Returns the Node that delivers this Node's input to the sub-graph.
+	const NodeRef&				getSubgraphInput();
+
+	//! Returns how many times higher the sub-graph's samplerate is than the Context's.
+	size_t	getOversample() const				{ return mOversample; }
+	//! Returns the number of frames the sub-graph processes per block, at its own samplerate. Valid once getSubgraphContext() has been called.
+	size_t	getSubgraphFramesPerBlock() const	{ return mSubgraphFramesPerBlock; }
+	//! Returns the number of frames, at the Context's samplerate, that buffering whole sub-graph blocks delays the output by. Valid once initialized.
+	size_t	getLatencyFrames() const			{ return mLatencyFrames; }
+
+  protected:
+	void initialize() override;
+	void process( Buffer *buffer ) override;
+
+  private:
+	class InputNode;
+
+	void renderSubgraphBlock();
+
+	size_t								mOversample, mSubgraphFramesPerBlock, mLatencyFrames;
+	ContextOfflineRef					mSubgraphContext;
+	NodeRef								mSubgraphInput;
+	std::unique_ptr<dsp::Converter>		mUpConverter, mDownConverter;
+	std::vector<dsp::RingBuffer>		mInputRingBuffers, mOutputRingBuffers;
+	BufferDynamic						mUpConvertBuffer;
+	Buffer								mSubgraphBuffer, mDownConvertBuffer;
+};
+
+} } // namespace cinder::audio2
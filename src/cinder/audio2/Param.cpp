@@ -23,11 +23,14 @@
 
 #include "cinder/audio2/Param.h"
 #include "cinder/audio2/Context.h"
+#include "cinder/audio2/GraphRecorder.h"
 #include "cinder/audio2/dsp/Dsp.h"
 #include "cinder/audio2/Debug.h"
 
 #include "cinder/CinderMath.h"
 
+#include <algorithm>
+
 using namespace std;
 
 namespace cinder { namespace audio2 {
@@ -66,12 +69,23 @@ Ramp::Ramp( float timeBegin, float timeEnd, float valueBegin, float valueEnd, co
 }
 
 Param::Param( Node *parentNode, float initialValue )
-	: mParentNode( parentNode ), mValue( initialValue )
+	: mParentNode( parentNode ), mValue( initialValue ), mRenderRamps( nullptr ), mRenderProcessor( nullptr )
 {
+	if( mParentNode )
+		mParentNode->mParams.push_back( this );
+}
+
+Param::~Param()
+{
+	if( mParentNode ) {
+		vector<Param *> &params = mParentNode->mParams;
+		params.erase( remove( params.begin(), params.end(), this ), params.end() );
+	}
 }
 
 void Param::setValue( float value )
 {
+	ScopedGraphEdit edit( getContext(), GraphEdit::paramSetValue( mParentNode, this, value ) );
 	lock_guard<mutex> lock( getContext()->getMutex() );
 
 	resetImpl();
@@ -88,14 +102,15 @@ RampRef Param::applyRamp( float valueBegin, float valueEnd, float rampSeconds, c
 	initInternalBuffer();
 
 	auto ctx = getContext();
+	ScopedGraphEdit edit( ctx, GraphEdit::paramApplyRamp( mParentNode, this, valueBegin, valueEnd, rampSeconds, options ) );
 	float timeBegin = (float)ctx->getNumProcessedSeconds() + options.getDelay();
 	float timeEnd = timeBegin + rampSeconds;
 
 	RampRef ramp( new Ramp( timeBegin, timeEnd, valueBegin, valueEnd, options.getRampFn() ) );
 
 	lock_guard<mutex> lock( ctx->getMutex() );
-	resetImpl();
-	mRamps.push_back( ramp );
+	cancelRampsImpl();
+	publishImpl( make_shared<RampList>( 1, ramp ), nullptr );
 
 	return ramp;
 }
@@ -105,6 +120,7 @@ RampRef Param::appendRamp( float valueEnd, float rampSeconds, const Options &opt
 	initInternalBuffer();
 
 	auto ctx = getContext();
+	ScopedGraphEdit edit( ctx, GraphEdit::paramAppendRamp( mParentNode, this, valueEnd, rampSeconds, options ) );
 	auto endTimeAndValue = findEndTimeAndValue();
 
 	float timeBegin = endTimeAndValue.first + options.getDelay();
@@ -113,7 +129,18 @@ RampRef Param::appendRamp( float valueEnd, float rampSeconds, const Options &opt
 	RampRef ramp( new Ramp( timeBegin, timeEnd, endTimeAndValue.second, valueEnd, options.getRampFn() ) );
 
 	lock_guard<mutex> lock( ctx->getMutex() );
-	mRamps.push_back( ramp );
+
+	// copy the Ramp's that are still scheduled, leaving out those the audio thread has finished with.
+	auto ramps = make_shared<RampList>();
+	if( mRamps ) {
+		for( const RampRef &scheduledRamp : *mRamps ) {
+			if( ! scheduledRamp->mIsComplete && ! scheduledRamp->mIsCanceled )
+				ramps->push_back( scheduledRamp );
+		}
+	}
+	ramps->push_back( ramp );
+
+	publishImpl( ramps, mProcessor );
 
 	return ramp;
 }
@@ -125,17 +152,17 @@ void Param::setProcessor( const NodeRef &node )
 
 	initInternalBuffer();
 
+	ScopedGraphEdit edit( getContext(), GraphEdit::paramSetProcessor( mParentNode, this, node.get() ) );
 	lock_guard<mutex> lock( getContext()->getMutex() );
 
-	resetImpl();
-
-	// force node to be mono and initialize it
+	// force node to be mono and initialize it, before the audio thread can see it
 	node->setNumChannels( 1 );
 	node->initializeImpl();
 
-	mProcessor = node;
+	cancelRampsImpl();
+	publishImpl( nullptr, node );
 
-	CI_LOG_V( "set processing Node to: " << mProcessor->getName() );
+	CI_LOG_V( "set processing Node to: " << node->getName() );
 }
 
 void Param::reset()
@@ -148,7 +175,16 @@ void Param::reset()
 size_t Param::getNumRamps() const
 {
 	lock_guard<mutex> lock( getContext()->getMutex() );
-	return mRamps.size();
+
+	size_t result = 0;
+	if( mRamps ) {
+		for( const RampRef &ramp : *mRamps ) {
+			if( ! ramp->mIsComplete && ! ramp->mIsCanceled )
+				result++;
+		}
+	}
+
+	return result;
 }
 
 float Param::findDuration() const
@@ -156,12 +192,11 @@ float Param::findDuration() const
 	auto ctx = getContext();
 	lock_guard<mutex> lock( ctx->getMutex() );
 
-	if( mRamps.empty() )
+	RampRef ramp = findLastRampImpl();
+	if( ! ramp )
 		return 0;
-	else {
-		const RampRef &ramp = mRamps.back();
+	else
 		return ramp->mTimeEnd - (float)ctx->getNumProcessedSeconds();
-	}
 }
 
 pair<float, float> Param::findEndTimeAndValue() const
@@ -169,12 +204,11 @@ pair<float, float> Param::findEndTimeAndValue() const
 	auto ctx = getContext();
 	lock_guard<mutex> lock( ctx->getMutex() );
 
-	if( mRamps.empty() )
+	RampRef ramp = findLastRampImpl();
+	if( ! ramp )
 		return make_pair( (float)ctx->getNumProcessedSeconds(), mValue.load() );
-	else {
-		const RampRef &ramp = mRamps.back();
+	else
 		return make_pair( ramp->mTimeEnd, ramp->mValueEnd );
-	}
 }
 
 const float* Param::getValueArray() const
@@ -186,9 +220,13 @@ const float* Param::getValueArray() const
 
 bool Param::eval()
 {
-	if( mProcessor ) {
-		mProcessor->pullInputs( &mInternalBuffer );
-		mValue = mInternalBuffer[mInternalBuffer.getNumFrames() - 1]; // TODO: why not add last() ?
+	Node *processor = mRenderProcessor;
+	if( processor ) {
+		float value = mValue;
+		processor->pullInputs( &mInternalBuffer );
+
+		// if the value was set on another thread while processing, it takes precedence.
+		mValue.compare_exchange_strong( value, mInternalBuffer[mInternalBuffer.getNumFrames() - 1] ); // TODO: why not add last() ?
 		return true;
 	}
 	else {
@@ -199,57 +237,64 @@ bool Param::eval()
 
 bool Param::eval( float timeBegin, float *array, size_t arrayLength, size_t sampleRate )
 {
+	const float initialValue = mValue;
+	float value = initialValue;
 	size_t samplesWritten = 0;
 	const float samplePeriod = 1.0f / (float)sampleRate;
 
-	for( auto rampIt = mRamps.begin(); rampIt != mRamps.end(); /* */ ) {
-		RampRef &ramp = *rampIt;
+	// The published Ramp's can't be modified here, so instead of removing them when they are finished they are marked as complete.
+	// They are left out the next time Ramp's are published.
+	const RampList *ramps = mRenderRamps;
+	if( ramps ) {
+		for( const RampRef &ramp : *ramps ) {
+			if( ramp->mIsComplete || ramp->mIsCanceled )
+				continue;
 
-		// first remove dead ramps
-		if( ramp->mTimeEnd < timeBegin || ramp->mIsCanceled ) {
-			rampIt = mRamps.erase( rampIt );
-			continue;
-		}
+			// first skip dead ramps
+			if( ramp->mTimeEnd < timeBegin ) {
+				ramp->mIsComplete = true;
+				continue;
+			}
 
-		const float timeEnd = timeBegin + arrayLength * samplePeriod;
+			const float timeEnd = timeBegin + arrayLength * samplePeriod;
 
-		if( ramp->mTimeBegin < timeEnd && ramp->mTimeEnd > timeBegin ) {
-			size_t startIndex = timeBegin >= ramp->mTimeBegin ? 0 : size_t( ( ramp->mTimeBegin - timeBegin ) * sampleRate );
-			size_t endIndex = timeEnd < ramp->mTimeEnd ? arrayLength : size_t( ( ramp->mTimeEnd - timeBegin ) * sampleRate );
+			if( ramp->mTimeBegin < timeEnd && ramp->mTimeEnd > timeBegin ) {
+				size_t startIndex = timeBegin >= ramp->mTimeBegin ? 0 : size_t( ( ramp->mTimeBegin - timeBegin ) * sampleRate );
+				size_t endIndex = timeEnd < ramp->mTimeEnd ? arrayLength : size_t( ( ramp->mTimeEnd - timeBegin ) * sampleRate );
 
-			CI_ASSERT( startIndex <= arrayLength && endIndex <= arrayLength );
+				CI_ASSERT( startIndex <= arrayLength && endIndex <= arrayLength );
 
-			if( startIndex > 0 && samplesWritten == 0 )
-				dsp::fill( mValue, array, startIndex );
+				if( startIndex > 0 && samplesWritten == 0 )
+					dsp::fill( value, array, startIndex );
 
-			size_t count = size_t( endIndex - startIndex );
-			float timeBeginNormalized = float( timeBegin - ramp->mTimeBegin + startIndex * samplePeriod ) / ramp->mDuration;
-			float timeEndNormalized = float( timeBegin - ramp->mTimeBegin + endIndex * samplePeriod ) / ramp->mDuration;
-			float timeIncr = ( timeEndNormalized - timeBeginNormalized ) / (float)count;
+				size_t count = size_t( endIndex - startIndex );
+				float timeBeginNormalized = float( timeBegin - ramp->mTimeBegin + startIndex * samplePeriod ) / ramp->mDuration;
+				float timeEndNormalized = float( timeBegin - ramp->mTimeBegin + endIndex * samplePeriod ) / ramp->mDuration;
+				float timeIncr = ( timeEndNormalized - timeBeginNormalized ) / (float)count;
 
-			ramp->mRampFn( array + startIndex, count, timeBeginNormalized, timeIncr, make_pair( ramp->mValueBegin, ramp->mValueEnd ) );
-			samplesWritten += count;
+				ramp->mRampFn( array + startIndex, count, timeBeginNormalized, timeIncr, make_pair( ramp->mValueBegin, ramp->mValueEnd ) );
+				samplesWritten += count;
 
-			// if this ramp ended with the current processing block, update mValue then remove ramp
-			if( endIndex < arrayLength ) {
-				ramp->mIsComplete = true;
-				mValue = ramp->mValueEnd;
-				rampIt = mRamps.erase( rampIt );
+				// if this ramp ended with the current processing block, update value then mark the ramp as complete
+				if( endIndex < arrayLength ) {
+					ramp->mIsComplete = true;
+					value = ramp->mValueEnd;
+				}
+				else if( samplesWritten == arrayLength ) {
+					value = array[arrayLength - 1];
+					break;
+				}
 			}
-			else if( samplesWritten == arrayLength ) {
-				mValue = array[arrayLength - 1];
-				break;
-			}
-			else
-				++rampIt;
 		}
-		else
-			++rampIt;
 	}
 
-	// if after all ramps we still haven't written enough samples, fill with the final mValue, which was updated above to be the last ramp's mValueEnd.
+	// if after all ramps we still haven't written enough samples, fill with the final value, which was updated above to be the last ramp's mValueEnd.
 	if( samplesWritten < arrayLength )
-		dsp::fill( mValue, array + (size_t)samplesWritten, size_t( arrayLength - samplesWritten ) );
+		dsp::fill( value, array + (size_t)samplesWritten, size_t( arrayLength - samplesWritten ) );
+
+	// if the value was set on another thread while evaluating, it takes precedence.
+	float expectedValue = initialValue;
+	mValue.compare_exchange_strong( expectedValue, value );
 
 	return samplesWritten != 0;
 }
@@ -260,14 +305,45 @@ bool Param::eval( float timeBegin, float *array, size_t arrayLength, size_t samp
 
 void Param::resetImpl()
 {
-	if( ! mRamps.empty() ) {
-		for( auto &ramp : mRamps )
+	cancelRampsImpl();
+	publishImpl( nullptr, nullptr );
+}
+
+void Param::cancelRampsImpl()
+{
+	if( mRamps ) {
+		for( auto &ramp : *mRamps )
 			ramp->cancel();
+	}
+}
+
+void Param::publishImpl( const shared_ptr<RampList> &ramps, const NodeRef &processor )
+{
+	shared_ptr<RampList> retiredRamps = mRamps;
+	NodeRef retiredProcessor = mProcessor;
+
+	mRamps = ramps;
+	mProcessor = processor;
+	mRenderRamps = ramps.get();
+	mRenderProcessor = processor.get();
 
-		mRamps.clear();
+	// the audio thread may still be evaluating the previous ones
+	auto ctx = getContext();
+	ctx->retire( retiredRamps );
+	if( retiredProcessor != processor )
+		ctx->retire( retiredProcessor );
+}
+
+RampRef Param::findLastRampImpl() const
+{
+	if( mRamps ) {
+		for( auto rampIt = mRamps->rbegin(); rampIt != mRamps->rend(); ++rampIt ) {
+			if( ! (*rampIt)->mIsComplete && ! (*rampIt)->mIsCanceled )
+				return *rampIt;
+		}
 	}
 
-	mProcessor.reset();
+	return RampRef();
 }
 
 void Param::initInternalBuffer()
@@ -25,7 +25,7 @@
 
 #include "cinder/audio2/Buffer.h"
 
-#include <list>
+#include <vector>
 #include <atomic>
 #include <functional>
 
@@ -93,6 +93,7 @@ class Param {
 
 	//! Constructs a Param with a pointer (weak reference) to the owning parent Node and an optional \a initialValue (default = 0).
 	Param( Node *parentNode, float initialValue = 0 );
+	~Param();
 
 	//! Sets the value of the Param, blowing away any scheduled Event's or processing Node. \note Must be called from a non-audio thread.
 	void	setValue( float value );
@@ -133,17 +134,26 @@ class Param {
 	std::pair<float, float> findEndTimeAndValue() const;
 
   protected:
+	typedef std::vector<RampRef>	RampList;
 
 	// non-locking protected methods
 	void		initInternalBuffer();
 	void		resetImpl();
+	void		cancelRampsImpl();
+	void		publishImpl( const std::shared_ptr<RampList> &ramps, const NodeRef &processor );
+	RampRef		findLastRampImpl() const;
 	ContextRef	getContext() const;
 
-	std::list<RampRef>	mRamps;
+	std::shared_ptr<RampList>	mRamps;
 	std::atomic<float>	mValue;
 	Node*				mParentNode;
 	NodeRef				mProcessor;
 	BufferDynamic		mInternalBuffer;
+
+	// mRamps and mProcessor as seen by the audio thread. They are never modified once published, instead they are replaced and the
+	// previous ones are retired by the Context, so that editing a Param never blocks the audio thread.
+	std::atomic<RampList *>		mRenderRamps;
+	std::atomic<Node *>			mRenderProcessor;
 };
 
 } } // namespace cinder::audio2
\ No newline at end of file
@@ -0,0 +1,132 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/audio2/Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+namespace cinder { namespace audio2 {
+
+// ----------------------------------------------------------------------------------------------------
+// MARK: - ProcessProfile
+// ----------------------------------------------------------------------------------------------------
+
+ProcessProfile::ProcessProfile()
+{
+	reset();
+}
+
+void ProcessProfile::record( uint64_t nanoseconds )
+{
+	mNumCalls.fetch_add( 1, memory_order_relaxed );
+	mTotalNanos.fetch_add( nanoseconds, memory_order_relaxed );
+	mBuckets[getBucketIndex( nanoseconds )].fetch_add( 1, memory_order_relaxed );
+
+	// there is only one recording thread, so min and max don't need a compare-exchange loop.
+	if( nanoseconds < mMinNanos.load( memory_order_relaxed ) )
+		mMinNanos.store( nanoseconds, memory_order_relaxed );
+	if( nanoseconds > mMaxNanos.load( memory_order_relaxed ) )
+		mMaxNanos.store( nanoseconds, memory_order_relaxed );
+}
+
+ProfileStats ProcessProfile::getStats() const
+{
+	ProfileStats result;
+	result.mNumCalls = mNumCalls.load( memory_order_relaxed );
+	if( ! result.mNumCalls )
+		return result;
+
+	result.mMinSeconds = double( mMinNanos.load( memory_order_relaxed ) ) * 1e-9;
+	result.mMaxSeconds = double( mMaxNanos.load( memory_order_relaxed ) ) * 1e-9;
+	result.mMeanSeconds = double( mTotalNanos.load( memory_order_relaxed ) ) * 1e-9 / double( result.mNumCalls );
+	result.mMedianSeconds = getPercentile( 0.5, result.mNumCalls, result.mMaxSeconds );
+	result.mPercentile99Seconds = getPercentile( 0.99, result.mNumCalls, result.mMaxSeconds );
+
+	return result;
+}
+
+void ProcessProfile::reset()
+{
+	mNumCalls = 0;
+	mTotalNanos = 0;
+	mMinNanos = numeric_limits<uint64_t>::max();
+	mMaxNanos = 0;
+	for( size_t i = 0; i < kNumBuckets; i++ )
+		mBuckets[i] = 0;
+}
+
+// static
+size_t ProcessProfile::getBucketIndex( uint64_t nanoseconds )
+{
+	if( nanoseconds == 0 )
+		return 0;
+
+	// nanoseconds = mantissa * 2^exponent, with mantissa in [0.5:1), which is split into four buckets.
+	int exponent;
+	double mantissa = frexp( double( nanoseconds ), &exponent );
+	size_t bucket = size_t( exponent - 1 ) * 4 + size_t( ( mantissa - 0.5 ) * 8.0 );
+
+	return min( bucket, kNumBuckets - 1 );
+}
+
+// static
+double ProcessProfile::getBucketUpperBound( size_t bucket )
+{
+	int exponent = int( bucket / 4 ) + 1;
+	double mantissa = 0.5 + double( bucket % 4 + 1 ) / 8.0;
+
+	return ldexp( mantissa, exponent ) * 1e-9;
+}
+
+double ProcessProfile::getPercentile( double fraction, uint64_t numCalls, double maxSeconds ) const
+{
+	const uint64_t target = uint64_t( ceil( fraction * double( numCalls ) ) );
+	uint64_t count = 0;
+	for( size_t i = 0; i < kNumBuckets; i++ ) {
+		count += mBuckets[i].load( memory_order_relaxed );
+		if( count >= target )
+			return min( getBucketUpperBound( i ), maxSeconds );
+	}
+
+	return maxSeconds;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// MARK: - ProfileSnapshot
+// ----------------------------------------------------------------------------------------------------
+
+const ProfileStats* ProfileSnapshot::findStats( const Node *node ) const
+{
+	for( const auto &nodeStats : mNodeStats ) {
+		if( nodeStats.mNode.get() == node )
+			return &nodeStats.mStats;
+	}
+
+	return nullptr;
+}
+
+} } // namespace cinder::audio2
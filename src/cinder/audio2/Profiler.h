@@ -0,0 +1,134 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+//! Define CINDER_AUDIO_PROFILING to time every Node::process() call and every rendered block, see Context::getProfileSnapshot().
+//! It is off by default, in which case nothing is recorded and no timing code is compiled into the audio thread.
+//#define CINDER_AUDIO_PROFILING
+
+namespace cinder { namespace audio2 {
+
+typedef std::shared_ptr<class Node>		NodeRef;
+
+//! Clock used to time processing, which is monotonic.
+typedef std::chrono::steady_clock	ProfileClock;
+
+//! Statistics of the durations recorded by a ProcessProfile, in seconds.
+struct ProfileStats {
+	ProfileStats() : mNumCalls( 0 ), mMinSeconds( 0 ), mMeanSeconds( 0 ), mMaxSeconds( 0 ), mMedianSeconds( 0 ), mPercentile99Seconds( 0 )	{}
+
+	uint64_t	mNumCalls;				//!< Number of durations recorded.
+	double		mMinSeconds;			//!< Shortest duration.
+	double		mMeanSeconds;			//!< Mean duration.
+	double		mMaxSeconds;			//!< Longest duration.
+	double		mMedianSeconds;			//!< Median duration, accurate to within a quarter octave.
+	double		mPercentile99Seconds;	//!< 99th percentile duration, accurate to within a quarter octave.
+};
+
+//! \brief Accumulates durations recorded on the audio thread, which can be read from any thread without locking.
+//!
+//! Recording is wait-free: counters are relaxed atomics and percentiles come from a histogram with four buckets per octave.
+//! Only one thread may record at a time, which holds for a Node since it is processed by one thread per block.
+class ProcessProfile {
+  public:
+	ProcessProfile();
+
+	//! Records one call that took \a nanoseconds.
+	void record( uint64_t nanoseconds );
+	//! Records one call that started at \a begin and ended now.
+	void record( ProfileClock::time_point begin )	{ record( (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>( ProfileClock::now() - begin ).count() ); }
+
+	//! Returns statistics of the calls recorded since construction or the last reset().
+	ProfileStats getStats() const;
+	//! Clears all recorded calls. Calls recorded concurrently may be partially cleared.
+	void reset();
+
+	//! Returns the number of histogram buckets.
+	static size_t	getNumBuckets()						{ return kNumBuckets; }
+	//! Returns the number of calls recorded in histogram \a bucket.
+	uint64_t		getBucketCount( size_t bucket ) const	{ return mBuckets[bucket].load( std::memory_order_relaxed ); }
+	//! Returns the longest duration in seconds that falls into histogram \a bucket. Buckets are a quarter octave wide.
+	static double	getBucketUpperBound( size_t bucket );
+
+  private:
+	static const size_t kNumBuckets = 160; // four per octave, up to 2^40 nanoseconds
+
+	static size_t	getBucketIndex( uint64_t nanoseconds );
+	double			getPercentile( double fraction, uint64_t numCalls, double maxSeconds ) const;
+
+	std::atomic<uint64_t>	mNumCalls, mTotalNanos, mMinNanos, mMaxNanos;
+	std::atomic<uint32_t>	mBuckets[kNumBuckets];
+};
+
+//! Processing time statistics of a Context, see Context::getProfileSnapshot().
+struct ProfileSnapshot {
+	ProfileSnapshot() : mBlockDeadlineSeconds( 0 ), mNumDeadlineMisses( 0 )	{}
+
+	struct NodeStats {
+		NodeRef			mNode;
+		ProfileStats	mStats;		//!< Durations of mNode's process() calls.
+	};
+
+	std::vector<NodeStats>	mNodeStats;				//!< Stats of each Node in the Context's RenderGraph.
+	ProfileStats			mBlockStats;			//!< Durations of the NodeOutput's render cycles. \see NodeOutput::getRenderStats()
+	double					mBlockDeadlineSeconds;	//!< Duration of one block at the Context's samplerate, the time available to render it.
+	uint64_t				mNumDeadlineMisses;		//!< Number of render cycles that took longer than mBlockDeadlineSeconds.
+
+	//! Returns the stats of \a node, or nullptr if it wasn't profiled.
+	const ProfileStats* findStats( const Node *node ) const;
+
+	//! Returns the mean fraction of the block deadline spent rendering.
+	double getMeanLoad() const	{ return mBlockDeadlineSeconds > 0 ? mBlockStats.mMeanSeconds / mBlockDeadlineSeconds : 0; }
+	//! Returns the largest fraction of the block deadline spent rendering a block.
+	double getMaxLoad() const	{ return mBlockDeadlineSeconds > 0 ? mBlockStats.mMaxSeconds / mBlockDeadlineSeconds : 0; }
+};
+
+//! \brief How much of its CPU budget a Context spends rendering, see Context::getCpuBudgetReport().
+//!
+//! Loads are fractions of the block deadline, so a Context that renders each block in a quarter of the block's duration has a load of 0.25.
+//! When many Context's render concurrently, giving each a budget of its share of the available cores shows which of them use more than their share.
+struct CpuBudgetReport {
+	CpuBudgetReport() : mBudget( 0 ), mMeanLoad( 0 ), mPercentile99Load( 0 ), mMaxLoad( 0 ), mNumBlocks( 0 ), mNumOverBudget( 0 ), mNumDeadlineMisses( 0 )	{}
+
+	double		mBudget;				//!< Fraction of each block's deadline the Context is expected to render in. \see NodeOutput::setCpuBudget()
+	double		mMeanLoad;				//!< Mean fraction of the block deadline spent rendering.
+	double		mPercentile99Load;		//!< 99th percentile fraction of the block deadline spent rendering.
+	double		mMaxLoad;				//!< Largest fraction of the block deadline spent rendering a block.
+	uint64_t	mNumBlocks;				//!< Number of blocks rendered.
+	uint64_t	mNumOverBudget;			//!< Number of blocks that took longer than mBudget.
+	uint64_t	mNumDeadlineMisses;		//!< Number of blocks that took longer than the whole block deadline.
+
+	//! Returns whether 99% of blocks rendered within budget.
+	bool	isWithinBudget() const		{ return mPercentile99Load <= mBudget; }
+	//! Returns the unused fraction of the budget at the 99th percentile, which is negative when over budget.
+	double	getHeadroom() const			{ return mBudget - mPercentile99Load; }
+};
+
+} } // namespace cinder::audio2
@@ -0,0 +1,458 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/audio2/RenderGraph.h"
+#include "cinder/audio2/dsp/Converter.h"
+#include "cinder/audio2/Debug.h"
+
+#include <algorithm>
+#include <map>
+
+using namespace std;
+
+namespace cinder { namespace audio2 {
+
+namespace {
+
+const size_t kNoValue = size_t( -1 );
+
+size_t getNumBytes( const Buffer *buffer )	{ return buffer->getSize() * sizeof( float ); }
+
+} // anonymous namespace
+
+RenderGraph::RenderGraph( const NodeRef &output, const set<NodeRef> &autoPulledNodes, size_t framesPerBlock, const WorkerPoolRef &workerPool, MemoryPool *memoryPool )
+	: mWorkerPool( workerPool ), mMemoryPool( memoryPool ), mFramesPerBlock( framesPerBlock )
+{
+	if( output )
+		compile( output, &output->mInternalBuffer, &mSteps, true );
+
+	for( const NodeRef &node : autoPulledNodes ) {
+		Buffer *inPlaceBuffer = nullptr;
+		if( node->getProcessInPlace() ) {
+			mScratchBuffers.emplace_back( new BufferDynamic( mFramesPerBlock, node->getNumChannels(), mMemoryPool ) );
+			inPlaceBuffer = mScratchBuffers.back().get();
+		}
+
+		compile( node, inPlaceBuffer, &mAutoPulledSteps, true );
+	}
+
+	assignPooledBuffers( output ? output->getInternalBuffer() : nullptr );
+	assignSilentFlags();
+}
+
+// Mirrors the control flow of Node::pullInputs(), but instead of processing emits the equivalent steps.
+void RenderGraph::compile( const NodeRef &node, Buffer *inPlaceBuffer, vector<Step> *steps, bool allowParallel )
+{
+	Node *n = node.get();
+
+	// Summing Node's are only processed once per block. If one is reached again, either through multiple outputs or a feedback
+	// cycle, its internal buffer is used as-is. In-place Node's have only one output, so they should never be reached twice.
+	if( ! mTraversedNodes.insert( n ).second ) {
+		if( n->getProcessInPlace() )
+			CI_LOG_E( "in-place Node reached twice while compiling: " << n->getName() );
+		return;
+	}
+
+	mNodes.push_back( node );
+
+	if( n->getProcessInPlace() ) {
+		CI_ASSERT( inPlaceBuffer );
+
+		if( n->mInputs.empty() )
+			steps->push_back( Step( Step::PROCESS_NO_INPUTS, n, inPlaceBuffer ) );
+		else {
+			const NodeRef &input = n->mInputs.begin()->second;
+			compile( input, inPlaceBuffer, steps, allowParallel );
+
+			if( ! input->getProcessInPlace() )
+				steps->push_back( Step( Step::MIX, n, inPlaceBuffer, input->getInternalBuffer() ) );
+
+			steps->push_back( Step( Step::PROCESS, n, inPlaceBuffer ) );
+		}
+	}
+	else
+		compileSumming( node, steps, allowParallel );
+}
+
+void RenderGraph::compileSumming( const NodeRef &node, vector<Step> *steps, bool allowParallel )
+{
+	Node *n = node.get();
+	steps->push_back( Step( Step::SUM_BEGIN, n, &n->mSummingBuffer ) );
+
+	// Inputs that form independent branches are each compiled into their own step array and buffer. They are processed
+	// in parallel before any other inputs, as nothing outside of the branch can observe them. Branches are not split further.
+	map<Node *, const Buffer *> branchResults;
+	if( allowParallel && mWorkerPool && n->mInputs.size() > 1 ) {
+		vector<NodeRef> branchInputs;
+		for( const auto &in : n->mInputs ) {
+			if( isIndependentBranch( in.second, n ) )
+				branchInputs.push_back( in.second );
+		}
+
+		if( branchInputs.size() > 1 ) {
+			Step parallelStep( Step::PARALLEL, n, nullptr );
+			parallelStep.mBranchBegin = mBranches.size();
+
+			for( const NodeRef &input : branchInputs ) {
+				Buffer *branchBuffer = nullptr;
+				if( input->getProcessInPlace() ) {
+					mScratchBuffers.emplace_back( new BufferDynamic( mFramesPerBlock, input->getNumChannels(), mMemoryPool ) );
+					branchBuffer = mScratchBuffers.back().get();
+				}
+
+				vector<Step> branchSteps;
+				compile( input, branchBuffer, &branchSteps, false );
+				mBranches.push_back( move( branchSteps ) );
+
+				branchResults[input.get()] = input->getProcessInPlace() ? branchBuffer : input->getInternalBuffer();
+			}
+
+			parallelStep.mBranchEnd = mBranches.size();
+			steps->push_back( parallelStep );
+		}
+	}
+
+	// Sum all inputs in bus order, so that the result doesn't depend on whether branches were processed in parallel.
+	for( const auto &in : n->mInputs ) {
+		const NodeRef &input = in.second;
+
+		const Buffer *processedBuffer;
+		auto branchIt = branchResults.find( input.get() );
+		if( branchIt != branchResults.end() )
+			processedBuffer = branchIt->second;
+		else {
+			compile( input, &n->mInternalBuffer, steps, allowParallel );
+			processedBuffer = input->getProcessInPlace() ? &n->mInternalBuffer : input->getInternalBuffer();
+		}
+
+		steps->push_back( Step( Step::SUM, n, &n->mSummingBuffer, processedBuffer ) );
+	}
+
+	// process the summed inputs, then mix them to the internal buffer that outputs read from.
+	steps->push_back( Step( Step::PROCESS, n, &n->mSummingBuffer ) );
+	steps->push_back( Step( Step::MIX, n, &n->mInternalBuffer, &n->mSummingBuffer ) );
+}
+
+// A branch is independent if every Node within it has only one output, leading towards \a summingNode, and none have been compiled yet.
+// Under these conditions no Node in the branch can be reached from anywhere else in the graph, so processing it can not race with other branches.
+bool RenderGraph::isIndependentBranch( const NodeRef &input, const Node *summingNode ) const
+{
+	set<const Node *> branchNodes;
+	vector<const Node *> stack( 1, input.get() );
+
+	while( ! stack.empty() ) {
+		const Node *node = stack.back();
+		stack.pop_back();
+
+		if( node == summingNode || node->getNumConnectedOutputs() != 1 || mTraversedNodes.count( node ) )
+			return false;
+		if( ! branchNodes.insert( node ).second )
+			return false;
+
+		for( const auto &in : node->mInputs )
+			stack.push_back( in.second.get() );
+	}
+
+	return true;
+}
+
+// Buffer's referenced by more than one step array are never pooled: branches are processed concurrently, and the auto-pulled steps may be
+// processed by a newer RenderGraph than the one that processed the output's steps. The output's internal buffer is read after processing.
+void RenderGraph::assignPooledBuffers( const Buffer *outputBuffer )
+{
+	vector<vector<Step> *> stepArrays = getStepArrays();
+
+	set<const Buffer *> unpooledBuffers;
+	if( outputBuffer )
+		unpooledBuffers.insert( outputBuffer );
+
+	map<const Buffer *, size_t> referencingArrays;
+	for( size_t i = 0; i < stepArrays.size(); i++ ) {
+		for( const Step &step : *stepArrays[i] ) {
+			const Buffer *buffers[] = { step.mBuffer, step.mSource };
+			for( const Buffer *buffer : buffers ) {
+				if( ! buffer )
+					continue;
+
+				auto result = referencingArrays.insert( make_pair( buffer, i ) );
+				if( ! result.second && result.first->second != i )
+					unpooledBuffers.insert( buffer );
+				if( buffer->getNumFrames() != mFramesPerBlock )
+					unpooledBuffers.insert( buffer );
+			}
+		}
+	}
+
+	for( const auto &buffer : referencingArrays ) {
+		mMemoryReport.mNumNodeBuffers++;
+		mMemoryReport.mNumNodeBytes += getNumBytes( buffer.first );
+	}
+
+	for( vector<Step> *steps : stepArrays )
+		assignPooledBuffers( steps, unpooledBuffers );
+
+	set<const Buffer *> renderBuffers;
+	for( vector<Step> *steps : stepArrays ) {
+		for( const Step &step : *steps ) {
+			if( step.mBuffer )
+				renderBuffers.insert( step.mBuffer );
+			if( step.mSource )
+				renderBuffers.insert( step.mSource );
+		}
+	}
+
+	for( const Buffer *buffer : renderBuffers ) {
+		mMemoryReport.mNumRenderBuffers++;
+		mMemoryReport.mNumRenderBytes += getNumBytes( buffer );
+	}
+	for( const auto &buffer : mPooledBuffers ) {
+		mMemoryReport.mNumPooledBuffers++;
+		mMemoryReport.mNumPooledBytes += getNumBytes( buffer.get() );
+	}
+}
+
+// Each time a step overwrites a Buffer it begins a new value, which lives until the last step that reads it. Values are then assigned
+// pooled Buffer's with a linear scan in the order that they begin, reusing a pooled Buffer once the value it holds has been read for the last time.
+void RenderGraph::assignPooledBuffers( vector<Step> *steps, const set<const Buffer *> &unpooledBuffers )
+{
+	struct Value {
+		Value( const Buffer *buffer, size_t step ) : mBuffer( buffer ), mBegin( step ), mEnd( step ), mPooledBuffer( nullptr )	{}
+
+		const Buffer*	mBuffer;
+		size_t			mBegin, mEnd;
+		BufferDynamic*	mPooledBuffer;
+	};
+
+	vector<Value> values;
+	map<const Buffer *, size_t> currentValues;
+	set<const Buffer *> liveInBuffers;
+	// for each step, the values of its buffer and source
+	vector<pair<size_t, size_t> > stepValues( steps->size(), make_pair( kNoValue, kNoValue ) );
+
+	auto define = [&]( const Buffer *buffer, size_t step ) -> size_t {
+		currentValues[buffer] = values.size();
+		values.push_back( Value( buffer, step ) );
+		return values.size() - 1;
+	};
+
+	auto use = [&]( const Buffer *buffer, size_t step ) -> size_t {
+		auto valueIt = currentValues.find( buffer );
+		if( valueIt == currentValues.end() ) {
+			// read before being written this block, so it carries over the previous block's contents (ex. from a feedback cycle).
+			liveInBuffers.insert( buffer );
+			return kNoValue;
+		}
+
+		values[valueIt->second].mEnd = step;
+		return valueIt->second;
+	};
+
+	for( size_t i = 0; i < steps->size(); i++ ) {
+		const Step &step = (*steps)[i];
+		switch( step.mType ) {
+			case Step::PROCESS_NO_INPUTS:
+			case Step::SUM_BEGIN:
+				stepValues[i].first = define( step.mBuffer, i );
+				break;
+			case Step::PROCESS:
+				stepValues[i].first = use( step.mBuffer, i );
+				break;
+			case Step::MIX:
+				stepValues[i].second = use( step.mSource, i );
+				stepValues[i].first = define( step.mBuffer, i );
+				break;
+			case Step::SUM:
+				stepValues[i].second = use( step.mSource, i );
+				stepValues[i].first = use( step.mBuffer, i );
+				break;
+			default:
+				break;
+		}
+	}
+
+	vector<size_t> activeValues;
+	vector<BufferDynamic *> freeBuffers;
+	for( size_t v = 0; v < values.size(); v++ ) {
+		Value &value = values[v];
+		if( unpooledBuffers.count( value.mBuffer ) || liveInBuffers.count( value.mBuffer ) )
+			continue;
+
+		// a value that ends at the step this one begins on is still being read by it, so its Buffer is not yet free.
+		for( auto activeIt = activeValues.begin(); activeIt != activeValues.end(); /* */ ) {
+			if( values[*activeIt].mEnd < value.mBegin ) {
+				freeBuffers.push_back( values[*activeIt].mPooledBuffer );
+				activeIt = activeValues.erase( activeIt );
+			}
+			else
+				++activeIt;
+		}
+
+		size_t numChannels = value.mBuffer->getNumChannels();
+		auto freeIt = find_if( freeBuffers.begin(), freeBuffers.end(), [numChannels]( const BufferDynamic *buffer ) { return buffer->getNumChannels() == numChannels; } );
+		if( freeIt != freeBuffers.end() ) {
+			value.mPooledBuffer = *freeIt;
+			freeBuffers.erase( freeIt );
+		}
+		else {
+			mPooledBuffers.emplace_back( new BufferDynamic( mFramesPerBlock, numChannels, mMemoryPool ) );
+			value.mPooledBuffer = mPooledBuffers.back().get();
+		}
+
+		activeValues.push_back( v );
+	}
+
+	for( size_t i = 0; i < steps->size(); i++ ) {
+		Step &step = (*steps)[i];
+		if( stepValues[i].first != kNoValue && values[stepValues[i].first].mPooledBuffer )
+			step.mBuffer = values[stepValues[i].first].mPooledBuffer;
+		if( stepValues[i].second != kNoValue && values[stepValues[i].second].mPooledBuffer )
+			step.mSource = values[stepValues[i].second].mPooledBuffer;
+	}
+}
+
+// Buffer's start out flagged as not silent, as their contents are unknown until they are first written.
+void RenderGraph::assignSilentFlags()
+{
+	vector<vector<Step> *> stepArrays = getStepArrays();
+
+	map<const Buffer *, size_t> flagIndices;
+	for( vector<Step> *steps : stepArrays ) {
+		for( const Step &step : *steps ) {
+			if( step.mBuffer )
+				flagIndices.insert( make_pair( step.mBuffer, flagIndices.size() ) );
+			if( step.mSource )
+				flagIndices.insert( make_pair( step.mSource, flagIndices.size() ) );
+		}
+	}
+
+	mSilentFlags.reset( new bool[flagIndices.size()] );
+	fill( mSilentFlags.get(), mSilentFlags.get() + flagIndices.size(), false );
+
+	for( vector<Step> *steps : stepArrays ) {
+		for( Step &step : *steps ) {
+			if( step.mBuffer )
+				step.mBufferSilent = &mSilentFlags[flagIndices[step.mBuffer]];
+			if( step.mSource )
+				step.mSourceSilent = &mSilentFlags[flagIndices[step.mSource]];
+		}
+	}
+}
+
+vector<vector<RenderGraph::Step> *> RenderGraph::getStepArrays()
+{
+	vector<vector<Step> *> result;
+	result.push_back( &mSteps );
+	result.push_back( &mAutoPulledSteps );
+	for( auto &branch : mBranches )
+		result.push_back( &branch );
+
+	return result;
+}
+
+void RenderGraph::processSteps( const vector<Step> &steps, uint64_t numProcessedFrames )
+{
+	for( const Step &step : steps ) {
+		Node *node = step.mNode;
+
+		switch( step.mType ) {
+			case Step::PROCESS_NO_INPUTS:
+				if( node->mEnabled )
+					processNode( node, step.mBuffer, step.mBufferSilent, numProcessedFrames, false );
+				else if( ! *step.mBufferSilent ) {
+					step.mBuffer->zero();
+					*step.mBufferSilent = true;
+				}
+				break;
+			case Step::PROCESS:
+				// a disabled Node passes its input through, so the Buffer's silent flag is unchanged.
+				if( node->mEnabled ) {
+					if( ! *step.mBufferSilent )
+						node->mNumSilentInputFrames = 0;
+					else if( canSkipSilentInput( node ) )
+						break;
+
+					processNode( node, step.mBuffer, step.mBufferSilent, numProcessedFrames, true );
+				}
+				break;
+			case Step::MIX:
+				if( ! *step.mSourceSilent ) {
+					dsp::mixBuffers( step.mSource, step.mBuffer );
+					*step.mBufferSilent = false;
+				}
+				else if( ! *step.mBufferSilent ) {
+					step.mBuffer->zero();
+					*step.mBufferSilent = true;
+				}
+				break;
+			case Step::SUM_BEGIN:
+				node->mLastProcessedFrame = numProcessedFrames;
+				if( ! *step.mBufferSilent ) {
+					step.mBuffer->zero();
+					*step.mBufferSilent = true;
+				}
+				break;
+			case Step::SUM:
+				if( ! *step.mSourceSilent ) {
+					dsp::sumBuffers( step.mSource, step.mBuffer );
+					*step.mBufferSilent = false;
+				}
+				break;
+			case Step::PARALLEL: {
+				const size_t branchBegin = step.mBranchBegin;
+				mWorkerPool->run( step.mBranchEnd - branchBegin, [this, branchBegin, numProcessedFrames]( size_t i ) {
+					processSteps( mBranches[branchBegin + i], numProcessedFrames );
+				} );
+				break;
+			}
+			default:
+				CI_ASSERT_NOT_REACHABLE();
+		}
+
+	}
+}
+
+// When \a passThrough is true, frames outside of a scheduled start or stop still hold the input, so the result is only silent if both were.
+void RenderGraph::processNode( Node *node, Buffer *buffer, bool *silent, uint64_t numProcessedFrames, bool passThrough )
+{
+	const bool inputSilent = *silent;
+	const bool scheduled = node->mScheduledStartFrame || node->mScheduledStopFrame;
+
+	node->mSilent = false;
+	node->callProcess( buffer, numProcessedFrames, passThrough );
+	*silent = node->mSilent && ( inputSilent || ! ( passThrough && scheduled ) );
+}
+
+// Returns true once \a node's input has been silent for at least its tail, otherwise counts another block of silent input.
+bool RenderGraph::canSkipSilentInput( Node *node ) const
+{
+	size_t tailFrames = node->getTailFrames();
+	if( tailFrames == Node::TAIL_INFINITE )
+		return false;
+	if( node->mNumSilentInputFrames >= tailFrames )
+		return true;
+
+	node->mNumSilentInputFrames += mFramesPerBlock;
+	return false;
+}
+
+} } // namespace cinder::audio2
@@ -0,0 +1,148 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/audio2/Node.h"
+#include "cinder/audio2/WorkerPool.h"
+
+#include <boost/noncopyable.hpp>
+
+#include <set>
+#include <vector>
+
+namespace cinder { namespace audio2 {
+
+//! \brief Flattened, pre-resolved representation of a Context's Node graph, which is processed on the audio thread.
+//!
+//! The graph is compiled by walking the inputs of the NodeOutput (and any auto-pulled Node's) in the same order that Node::pullInputs()
+//! would, emitting a topologically sorted array of steps. Each step references a raw Node and the Buffer's it operates on, so processing
+//! a block is a linear walk over this array. A RenderGraph is immutable once compiled; the Context compiles a new one whenever connections change
+//! and publishes it to the audio thread atomically, so the audio thread never waits for graph edits to complete.
+//!
+//! If compiled with a WorkerPool, inputs of a summing Node that form independent branches (no Node within them is shared with the rest of the graph)
+//! are compiled into separate step arrays with their own buffers, which are processed in parallel and then summed in bus order, so the result is
+//! identical to serial processing.
+//!
+//! Rather than processing with each Node's own internal and summing Buffer's, a RenderGraph assigns Buffer's from a pool by liveness analysis,
+//! similar to how a register allocator assigns registers: the contents written to a Buffer by one step live until the last step that reads them,
+//! and contents that are never live at the same time share the same pooled Buffer. This keeps the memory touched each block small on large graphs.
+//!
+//! Each Buffer processed also has a flag that is set while it is known to contain only silence. Silent inputs aren't summed, and a Node whose
+//! input has been silent for longer than its tail (see Node::getTailFrames()) isn't processed until its input is no longer silent.
+class RenderGraph : public boost::noncopyable {
+  public:
+	//! Describes the Buffer memory that a RenderGraph touches while processing, in comparison to processing with each Node's own Buffer's.
+	struct MemoryReport {
+		MemoryReport() : mNumNodeBuffers( 0 ), mNumNodeBytes( 0 ), mNumRenderBuffers( 0 ), mNumRenderBytes( 0 ), mNumPooledBuffers( 0 ), mNumPooledBytes( 0 )	{}
+
+		size_t mNumNodeBuffers;		//!< Number of Node and scratch Buffer's that would be touched without pooling.
+		size_t mNumNodeBytes;		//!< Size in bytes of the Buffer's counted by mNumNodeBuffers.
+		size_t mNumRenderBuffers;	//!< Number of Buffer's that are touched while processing, including pooled Buffer's.
+		size_t mNumRenderBytes;		//!< Size in bytes of the Buffer's counted by mNumRenderBuffers.
+		size_t mNumPooledBuffers;	//!< Number of Buffer's allocated for the pool, which are owned by the RenderGraph.
+		size_t mNumPooledBytes;		//!< Size in bytes of the Buffer's counted by mNumPooledBuffers.
+	};
+
+	//! Compiles the graph ending at \a output, along with the graphs ending at each of \a autoPulledNodes. If \a workerPool is provided, independent branches are processed with it.
+	//! The RenderGraph's own Buffer's are allocated from \a memoryPool, or from the heap if it is null.
+	//! \note Must be called on a non-audio thread and synchronized with the Context's mutex.
+	RenderGraph( const NodeRef &output, const std::set<NodeRef> &autoPulledNodes, size_t framesPerBlock, const WorkerPoolRef &workerPool = WorkerPoolRef(), MemoryPool *memoryPool = nullptr );
+
+	//! Processes the graph ending at the output, leaving the result in its internal buffer. \a numProcessedFrames is used to mark summing Node's as processed for this block.
+	void process( uint64_t numProcessedFrames )				{ processSteps( mSteps, numProcessedFrames ); }
+	//! Processes the graphs ending at the auto-pulled Node's.
+	void processAutoPulled( uint64_t numProcessedFrames )	{ processSteps( mAutoPulledSteps, numProcessedFrames ); }
+
+	//! Returns the number of steps in the graph ending at the output.
+	size_t getNumSteps() const				{ return mSteps.size(); }
+	//! Returns the number of steps in the graphs ending at the auto-pulled Node's.
+	size_t getNumAutoPulledSteps() const	{ return mAutoPulledSteps.size(); }
+	//! Returns the number of unique Node's referenced by this RenderGraph.
+	size_t getNumNodes() const				{ return mNodes.size(); }
+	//! Returns the number of branches that are processed in parallel.
+	size_t getNumParallelBranches() const	{ return mBranches.size(); }
+	//! Returns every Node referenced by this RenderGraph.
+	const std::vector<NodeRef>& getNodes() const	{ return mNodes; }
+	//! Returns whether \a node is processed by this RenderGraph.
+	bool contains( const Node *node ) const	{ return mTraversedNodes.count( node ) != 0; }
+	//! Returns a description of the Buffer memory touched while processing.
+	const MemoryReport& getMemoryReport() const	{ return mMemoryReport; }
+
+  private:
+	struct Step {
+		enum Type {
+			PROCESS_NO_INPUTS,	//! In-place Node without inputs: process \a buffer if enabled, otherwise zero it.
+			PROCESS,			//! In-place Node: process \a buffer if enabled.
+			MIX,				//! Mix \a source to \a buffer, replacing its contents.
+			SUM_BEGIN,			//! Summing Node: mark as processed and zero \a buffer (its summing buffer).
+			SUM,				//! Sum \a source into \a buffer.
+			PARALLEL			//! Process branches [mBranchBegin:mBranchEnd) with the WorkerPool.
+		};
+
+		Step( Type type, Node *node, Buffer *buffer, const Buffer *source = nullptr )
+			: mType( type ), mNode( node ), mBuffer( buffer ), mSource( source ), mBufferSilent( nullptr ), mSourceSilent( nullptr ), mBranchBegin( 0 ), mBranchEnd( 0 )
+		{}
+
+		Type			mType;
+		Node*			mNode;
+		Buffer*			mBuffer;
+		const Buffer*	mSource;
+		bool*			mBufferSilent;
+		const bool*		mSourceSilent;
+		size_t			mBranchBegin, mBranchEnd;
+	};
+
+	void compile( const NodeRef &node, Buffer *inPlaceBuffer, std::vector<Step> *steps, bool allowParallel );
+	void compileSumming( const NodeRef &node, std::vector<Step> *steps, bool allowParallel );
+	bool isIndependentBranch( const NodeRef &input, const Node *summingNode ) const;
+	void assignPooledBuffers( const Buffer *outputBuffer );
+	void assignPooledBuffers( std::vector<Step> *steps, const std::set<const Buffer *> &unpooledBuffers );
+	void assignSilentFlags();
+	std::vector<std::vector<Step> *> getStepArrays();
+	void processSteps( const std::vector<Step> &steps, uint64_t numProcessedFrames );
+	void processNode( Node *node, Buffer *buffer, bool *silent, uint64_t numProcessedFrames, bool passThrough );
+	bool canSkipSilentInput( Node *node ) const;
+
+	std::vector<Step>	mSteps, mAutoPulledSteps;
+	// independent branches, referenced by PARALLEL steps
+	std::vector<std::vector<Step> >	mBranches;
+	WorkerPoolRef					mWorkerPool;
+	MemoryPool						*mMemoryPool;
+	size_t							mFramesPerBlock;
+
+	// Holds references to every Node in the graph while it may be processed, so that a Node disconnected on
+	// another thread is not destroyed until the RenderGraph that references it is.
+	std::vector<NodeRef>	mNodes;
+	// Node's that have been compiled, used to break cycles and only process summing Node's once.
+	std::set<const Node *>	mTraversedNodes;
+	// Auto-pulled Node's and parallel branches that process in-place need a Buffer to process into.
+	std::vector<std::unique_ptr<BufferDynamic> >	mScratchBuffers;
+	// Buffer's that steps are assigned to by liveness, in place of Node and scratch Buffer's.
+	std::vector<std::unique_ptr<BufferDynamic> >	mPooledBuffers;
+	MemoryReport									mMemoryReport;
+	// whether each Buffer that steps reference currently contains only silence, indexed by Step::mBufferSilent and Step::mSourceSilent.
+	std::unique_ptr<bool[]>							mSilentFlags;
+};
+
+} } // namespace cinder::audio2
@@ -23,6 +23,7 @@
 
 #include "cinder/audio2/SamplePlayer.h"
 #include "cinder/audio2/Context.h"
+#include "cinder/audio2/dsp/Converter.h"
 #include "cinder/audio2/Debug.h"
 #include "cinder/CinderMath.h"
 
@@ -89,28 +90,117 @@ size_t SamplePlayer::getNumSeconds() const
 	return size_t( (double)mNumFrames / (double)getSampleRate() );
 }
 
+// ----------------------------------------------------------------------------------------------------
+// MARK: - SampleBuffer
+// ----------------------------------------------------------------------------------------------------
+
+namespace {
+
+template <typename T>
+shared_ptr<BufferT<T> > convertBuffer( const Buffer &buffer )
+{
+	auto result = make_shared<BufferT<T> >( buffer.getNumFrames(), buffer.getNumChannels() );
+	dsp::convertBuffers( &buffer, result.get() );
+	return result;
+}
+
+template <typename T>
+void convertFrames( const BufferT<T> &source, Buffer *dest, size_t numFrames, size_t frameOffset )
+{
+	CI_ASSERT( dest->getNumChannels() == source.getNumChannels() );
+	CI_ASSERT( numFrames <= dest->getNumFrames() );
+	CI_ASSERT( frameOffset + numFrames <= source.getNumFrames() );
+
+	for( size_t ch = 0; ch < source.getNumChannels(); ch++ )
+		dsp::convert( source.getChannel( ch ) + frameOffset, dest->getChannel( ch ), numFrames );
+}
+
+} // anonymous namespace
+
+// static
+SampleBuffer SampleBuffer::create( const BufferRef &buffer, Format format )
+{
+	switch( format ) {
+		case INT_16:	return SampleBuffer( convertBuffer<int16_t>( *buffer ) );
+		case INT_24:	return SampleBuffer( convertBuffer<Int24>( *buffer ) );
+		default:		return SampleBuffer( buffer );
+	}
+}
+
+size_t SampleBuffer::getNumFrames() const
+{
+	switch( mFormat ) {
+		case INT_16:	return mBufferInt16 ? mBufferInt16->getNumFrames() : 0;
+		case INT_24:	return mBufferInt24 ? mBufferInt24->getNumFrames() : 0;
+		default:		return mBuffer ? mBuffer->getNumFrames() : 0;
+	}
+}
+
+size_t SampleBuffer::getNumChannels() const
+{
+	switch( mFormat ) {
+		case INT_16:	return mBufferInt16 ? mBufferInt16->getNumChannels() : 0;
+		case INT_24:	return mBufferInt24 ? mBufferInt24->getNumChannels() : 0;
+		default:		return mBuffer ? mBuffer->getNumChannels() : 0;
+	}
+}
+
+size_t SampleBuffer::getNumBytes() const
+{
+	size_t sampleBytes;
+	switch( mFormat ) {
+		case INT_16:	sampleBytes = sizeof( int16_t );	break;
+		case INT_24:	sampleBytes = sizeof( Int24 );		break;
+		default:		sampleBytes = sizeof( float );		break;
+	}
+
+	return getNumFrames() * getNumChannels() * sampleBytes;
+}
+
+void SampleBuffer::copyTo( Buffer *dest, size_t numFrames, size_t frameOffset ) const
+{
+	if( ! numFrames )
+		return;
+
+	switch( mFormat ) {
+		case INT_16:	convertFrames( *mBufferInt16, dest, numFrames, frameOffset );	break;
+		case INT_24:	convertFrames( *mBufferInt24, dest, numFrames, frameOffset );	break;
+		default:		dest->copyOffset( *mBuffer, numFrames, 0, frameOffset );		break;
+	}
+}
+
 // ----------------------------------------------------------------------------------------------------
 // MARK: - BufferPlayer
 // ----------------------------------------------------------------------------------------------------
 
 BufferPlayer::BufferPlayer( const Format &format )
-	: SamplePlayer( format )
+	: SamplePlayer( format ), mSampleBuffer( make_shared<SampleBuffer>() ), mRenderSampleBuffer( mSampleBuffer.get() )
 {
 }
 
 BufferPlayer::BufferPlayer( const BufferRef &buffer, const Format &format )
-	: SamplePlayer( format ), mBuffer( buffer )
+	: SamplePlayer( format ), mSampleBuffer( make_shared<SampleBuffer>( buffer ) ), mRenderSampleBuffer( mSampleBuffer.get() )
 {
-	mNumFrames = mLoopEnd = mBuffer->getNumFrames();
+	mNumFrames = mLoopEnd = mSampleBuffer->getNumFrames();
 
 	// force channel mode to match buffer
 	mChannelMode = ChannelMode::SPECIFIED;
-	setNumChannels( mBuffer->getNumChannels() );
+	setNumChannels( mSampleBuffer->getNumChannels() );
+}
+
+BufferPlayer::BufferPlayer( const SampleBuffer &sampleBuffer, const Format &format )
+	: SamplePlayer( format ), mSampleBuffer( make_shared<SampleBuffer>( sampleBuffer ) ), mRenderSampleBuffer( mSampleBuffer.get() )
+{
+	mNumFrames = mLoopEnd = mSampleBuffer->getNumFrames();
+
+	// force channel mode to match buffer
+	mChannelMode = ChannelMode::SPECIFIED;
+	setNumChannels( mSampleBuffer->getNumChannels() );
 }
 
 void BufferPlayer::start()
 {
-	if( ! mBuffer ) {
+	if( mSampleBuffer->isEmpty() ) {
 		CI_LOG_E( "no audio buffer, returning." );
 		return;
 	}
@@ -133,45 +223,63 @@ void BufferPlayer::seek( size_t readPositionFrames )
 	mReadPos = math<size_t>::clamp( readPositionFrames, 0, mNumFrames );
 }
 
-void BufferPlayer::setBuffer( const BufferRef &buffer )
+void BufferPlayer::setSampleBuffer( const SampleBuffer &sampleBuffer )
 {
-	lock_guard<mutex> lock( getContext()->getMutex() );
+	auto ctx = getContext();
+	bool numChannelsChanged = false;
+	{
+		lock_guard<mutex> lock( ctx->getMutex() );
 
-	bool enabled = mEnabled;
-	if( mEnabled )
-		stop();
+		bool enabled = mEnabled;
+		if( mEnabled )
+			stop();
 
-	if( mNumChannels != buffer->getNumChannels() ) {
-		setNumChannels( buffer->getNumChannels() );
-		configureConnections();
-	}
+		if( mNumChannels != sampleBuffer.getNumChannels() ) {
+			setNumChannels( sampleBuffer.getNumChannels() );
+			configureConnections();
+			numChannelsChanged = true;
+		}
 
-	mBuffer = buffer;
-	mNumFrames = buffer->getNumFrames();
+		shared_ptr<SampleBuffer> retiredBuffer = mSampleBuffer;
+		mSampleBuffer = make_shared<SampleBuffer>( sampleBuffer );
+		mRenderSampleBuffer = mSampleBuffer.get();
+		mNumFrames = mSampleBuffer->getNumFrames();
 
-	if( ! mLoopEnd  || mLoopEnd > mNumFrames )
-		mLoopEnd = mNumFrames;
+		if( ! mLoopEnd  || mLoopEnd > mNumFrames )
+			mLoopEnd = mNumFrames;
+
+		// the audio thread may still be reading from the previous Buffer
+		ctx->retire( retiredBuffer );
+
+		if( enabled )
+			start();
+	}
 
-	if( enabled )
-		start();
+	// reconfiguring the channels suspended rendering, so publish a new RenderGraph.
+	if( numChannelsChanged )
+		ctx->updateRenderGraph();
 }
 
-void BufferPlayer::loadBuffer( const SourceFileRef &sourceFile )
+void BufferPlayer::loadBuffer( const SourceFileRef &sourceFile, SampleBuffer::Format sampleFormat )
 {
 	auto sf = sourceFile->clone();
 
 	sf->setOutputFormat( getSampleRate() );
-	setBuffer( sf->loadBuffer() );
+	setSampleBuffer( SampleBuffer::create( sf->loadBuffer(), sampleFormat ) );
 }
 
 void BufferPlayer::process( Buffer *buffer )
 {
+	const SampleBuffer *sourceBuffer = mRenderSampleBuffer;
 	size_t readPos = mReadPos;
 	size_t numFrames = buffer->getNumFrames();
-	size_t readEnd = mLoop ? mLoopEnd.load() : mNumFrames;
+	size_t sourceNumFrames = sourceBuffer->getNumFrames();
+
+	// the loop end is updated after a new Buffer is published, so it may be beyond the end of a smaller one
+	size_t readEnd = mLoop ? min( mLoopEnd.load(), sourceNumFrames ) : sourceNumFrames;
 	size_t readCount = readEnd < readPos ? 0 : min( readEnd - readPos, numFrames );
 
-	buffer->copyOffset( *mBuffer, readCount, 0, readPos );
+	sourceBuffer->copyTo( buffer, readCount, readPos );
 
 	if( readCount < numFrames  ) {
 		// TODO: if looping, copy from mLoopBegin instead of zero'ing
@@ -270,10 +378,7 @@ void FilePlayer::seek( size_t readPositionFrames )
 		return;
 	}
 
-	// Synchronize with the mutex that protects the read thread, which is different depending on if
-	// read is async or sync (done on audio thread)
-	mutex &m = mIsReadAsync ? mAsyncReadMutex : getContext()->getMutex();
-	lock_guard<mutex> lock( m );
+	lock_guard<mutex> lock( mReadMutex );
 
 	mIsEof = false;
 	seekImpl( readPositionFrames );
@@ -284,25 +389,37 @@ void FilePlayer::setSourceFile( const SourceFileRef &sourceFile )
 	// update source's samplerate to match context
 	sourceFile->setOutputFormat( getSampleRate(), sourceFile->getNumChannels() );
 
-	lock_guard<mutex> lock( getContext()->getMutex() );
+	auto ctx = getContext();
+	bool numChannelsChanged = false;
+	{
+		lock_guard<mutex> lock( ctx->getMutex() );
 
-	bool enabled = mEnabled;
-	if( mEnabled )
-		stop();
+		bool enabled = mEnabled;
+		if( mEnabled )
+			stop();
 
-	if( mNumChannels != sourceFile->getNumChannels() ) {
-		setNumChannels( sourceFile->getNumChannels() );
-		configureConnections();
-	}
+		if( mNumChannels != sourceFile->getNumChannels() ) {
+			setNumChannels( sourceFile->getNumChannels() );
+			configureConnections();
+			numChannelsChanged = true;
+		}
 
-	mSourceFile = sourceFile;
-	mNumFrames = sourceFile->getNumFrames();
+		{
+			lock_guard<mutex> readLock( mReadMutex );
+			mSourceFile = sourceFile;
+			mNumFrames = sourceFile->getNumFrames();
+		}
 
-	if( ! mLoopEnd  || mLoopEnd > mNumFrames )
-		mLoopEnd = mNumFrames;
+		if( ! mLoopEnd  || mLoopEnd > mNumFrames )
+			mLoopEnd = mNumFrames;
 
-	if( enabled )
-		start();
+		if( enabled )
+			start();
+	}
+
+	// reconfiguring the channels suspended rendering, so publish a new RenderGraph.
+	if( numChannelsChanged )
+		ctx->updateRenderGraph();
 }
 
 uint64_t FilePlayer::getLastUnderrun()
@@ -325,10 +442,15 @@ void FilePlayer::process( Buffer *buffer )
 	size_t readPos = mReadPos;
 	size_t numReadAvail = mRingBuffers[0].getAvailableRead();
 
+	// When reading synchronously, the SourceFile is only accessed if it isn't currently being changed on another thread,
+	// otherwise reading and seeking are skipped this block and the ringbuffer's padding covers for it.
+	unique_lock<mutex> readLock( mReadMutex, defer_lock );
+	bool canAccessSourceFile = mIsReadAsync || readLock.try_lock();
+
 	if( numReadAvail < mBufferFramesThreshold ) {
 		if( mIsReadAsync )
 			mIssueAsyncReadCond.notify_one();
-		else
+		else if( canAccessSourceFile )
 			readImpl();
 	}
 
@@ -346,8 +468,10 @@ void FilePlayer::process( Buffer *buffer )
 		buffer->zero( readCount, numFrames - readCount );
 
 		readPos += readCount;
-		if( mLoop && readPos >= mLoopEnd )
-			seekImpl( mLoopBegin );
+		if( mLoop && readPos >= mLoopEnd ) {
+			if( canAccessSourceFile )
+				seekImpl( mLoopBegin );
+		}
 		else if( readPos >= mNumFrames ) {
 			mIsEof = true;
 			mEnabled = false;
@@ -359,7 +483,7 @@ void FilePlayer::readAsyncImpl()
 {
 	size_t lastReadPos = mReadPos;
 	while( true ) {
-		unique_lock<mutex> lock( mAsyncReadMutex );
+		unique_lock<mutex> lock( mReadMutex );
 		mIssueAsyncReadCond.wait( lock );
 
 		if( mAsyncReadShouldQuit )
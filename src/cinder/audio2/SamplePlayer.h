@@ -95,30 +95,87 @@ class SamplePlayer : public NodeInput {
 	bool				mStartAtBeginning;
 };
 
+//! \brief The samples played by a BufferPlayer, stored in one of several formats.
+//!
+//! Samples are stored either as floats, or to save memory as 16 or 24-bit integers, which take a half or three quarters of the memory and
+//! are converted to floats block by block as they are played. Implicitly constructible from a Buffer in any of those formats.
+class SampleBuffer {
+  public:
+	enum Format { FLOAT_32, INT_16, INT_24 };
+
+	//! Constructs an empty SampleBuffer.
+	SampleBuffer() : mFormat( FLOAT_32 )	{}
+	SampleBuffer( const BufferRef &buffer ) : mFormat( FLOAT_32 ), mBuffer( buffer )			{}
+	SampleBuffer( const BufferInt16Ref &buffer ) : mFormat( INT_16 ), mBufferInt16( buffer )	{}
+	SampleBuffer( const BufferInt24Ref &buffer ) : mFormat( INT_24 ), mBufferInt24( buffer )	{}
+
+	//! Returns a SampleBuffer containing \a buffer's samples converted to \a format. If \a format is FLOAT_32, it refers to \a buffer itself.
+	static SampleBuffer create( const BufferRef &buffer, Format format );
+
+	//! Returns the format that the samples are stored in.
+	Format	getFormat() const		{ return mFormat; }
+	//! Returns whether there is no Buffer.
+	bool	isEmpty() const			{ return ! mBuffer && ! mBufferInt16 && ! mBufferInt24; }
+	size_t	getNumFrames() const;
+	size_t	getNumChannels() const;
+	//! Returns the number of bytes taken by the samples.
+	size_t	getNumBytes() const;
+
+	//! Converts \a numFrames frames starting at \a frameOffset to floats, written to the start of \a dest. Can be called from the audio thread.
+	//! \note requires channel counts to match.
+	void	copyTo( Buffer *dest, size_t numFrames, size_t frameOffset ) const;
+
+	//! Returns the Buffer if the samples are stored as floats, otherwise null.
+	const BufferRef&		getBuffer() const		{ return mBuffer; }
+	//! Returns the Buffer if the samples are stored as 16-bit integers, otherwise null.
+	const BufferInt16Ref&	getBufferInt16() const	{ return mBufferInt16; }
+	//! Returns the Buffer if the samples are stored as 24-bit integers, otherwise null.
+	const BufferInt24Ref&	getBufferInt24() const	{ return mBufferInt24; }
+
+  private:
+	Format			mFormat;
+	BufferRef		mBuffer;
+	BufferInt16Ref	mBufferInt16;
+	BufferInt24Ref	mBufferInt24;
+};
+
 //! Buffer-based sample player. In other words, all samples are loaded into memory before playback.
+//! To save memory, the samples can be stored as 16 or 24-bit integers by playing a SampleBuffer of either format.
 class BufferPlayer : public SamplePlayer {
   public:
 	//! Constructs a BufferPlayer without a buffer, with the assumption one will be set later. \note Format::channels() can still be used to allocate the expected channel count ahead of time.
 	BufferPlayer( const Format &format = Format() );
 	//! Constructs a BufferPlayer with \a buffer. \note Channel mode is always ChannelMode::SPECIFIED and num channels matches \a buffer. Format::channels() is ignored.
 	BufferPlayer( const BufferRef &buffer, const Format &format = Format() );
+	//! Constructs a BufferPlayer with \a sampleBuffer, which may store its samples in any SampleBuffer::Format. \note Channel mode is always ChannelMode::SPECIFIED and num channels matches \a sampleBuffer.
+	BufferPlayer( const SampleBuffer &sampleBuffer, const Format &format = Format() );
 
 	virtual ~BufferPlayer() {}
 
 	virtual void start() override;
 	virtual void stop() override;
 	virtual void seek( size_t readPositionFrames ) override;
+	// scheduled start( double when ) and stop( double when ), which would otherwise be hidden by the overrides above.
+	using Node::start;
+	using Node::stop;
+
+	//! Loads and stores a reference to a Buffer created from the entire contents of \a sourceFile, with its samples stored in \a sampleFormat.
+	void loadBuffer( const SourceFileRef &sourceFile, SampleBuffer::Format sampleFormat = SampleBuffer::FLOAT_32 );
 
-	//! Loads and stores a reference to a Buffer created from the entire contents of \a sourceFile.
-	void loadBuffer( const SourceFileRef &sourceFile );
+	//! Replaces the Buffer that is played. The audio thread switches to \a buffer at the start of its next block, the previous Buffer is retired by the Context.
+	void setBuffer( const BufferRef &buffer )	{ setSampleBuffer( buffer ); }
+	//! Returns the Buffer that is played, or null if its samples aren't stored as floats. \see getSampleBuffer()
+	const BufferRef& getBuffer() const	{ return mSampleBuffer->getBuffer(); }
 
-	void setBuffer( const BufferRef &buffer );
-	const BufferRef& getBuffer() const	{ return mBuffer; }
+	//! Replaces the SampleBuffer that is played, which may store its samples in any SampleBuffer::Format. \see setBuffer()
+	void setSampleBuffer( const SampleBuffer &sampleBuffer );
+	const SampleBuffer& getSampleBuffer() const	{ return *mSampleBuffer; }
 
   protected:
 	virtual void process( Buffer *buffer )	override;
 
-	BufferRef mBuffer;
+	std::shared_ptr<SampleBuffer>	mSampleBuffer;
+	std::atomic<SampleBuffer *>		mRenderSampleBuffer; // mSampleBuffer as seen by the audio thread
 };
 
 class FilePlayer : public SamplePlayer {
@@ -131,6 +188,9 @@ class FilePlayer : public SamplePlayer {
 	virtual void start() override;
 	virtual void stop() override;
 	virtual void seek( size_t readPositionFrames ) override;
+	// scheduled start( double when ) and stop( double when ), which would otherwise be hidden by the overrides above.
+	using Node::start;
+	using Node::stop;
 
 	bool isReadAsync() const	{ return mIsReadAsync; }
 
@@ -161,7 +221,7 @@ class FilePlayer : public SamplePlayer {
 	std::atomic<uint64_t>						mLastUnderrun, mLastOverrun;
 
 	std::unique_ptr<std::thread>				mReadThread;
-	std::mutex									mAsyncReadMutex;
+	std::mutex									mReadMutex;	// synchronizes access to mSourceFile with the thread that reads it, never blocks the audio thread
 	std::condition_variable						mIssueAsyncReadCond;
 	bool										mIsReadAsync, mAsyncReadShouldQuit;
 };
@@ -80,7 +80,17 @@ const Buffer& Scope::getBuffer()
 float Scope::getVolume()
 {
 	fillCopiedBuffer();
-	return dsp::rms( mCopiedBuffer.getData(), mCopiedBuffer.getSize() );
+	if( mCopiedBuffer.isContiguous() )
+		return dsp::rms( mCopiedBuffer.getData(), mCopiedBuffer.getSize() );
+
+	// the channels are padded apart, so the mean square of each is averaged.
+	float sumSquares = 0;
+	for( size_t ch = 0; ch < mCopiedBuffer.getNumChannels(); ch++ ) {
+		float channelRms = dsp::rms( mCopiedBuffer.getChannel( ch ), mCopiedBuffer.getNumFrames() );
+		sumSquares += channelRms * channelRms;
+	}
+
+	return sqrt( sumSquares / float( mCopiedBuffer.getNumChannels() ) );
 }
 
 float Scope::getVolume( size_t channel )
@@ -129,8 +139,7 @@ void ScopeSpectral::initialize()
 	else if( ! isPowerOf2( mWindowSize ) )
 		mWindowSize = nextPowerOf2( static_cast<uint32_t>( mWindowSize ) );
 
-	mWindowingTable = makeAlignedArray<float>( mWindowSize );
-	generateWindow( mWindowType, mWindowingTable.get(), mWindowSize );
+	mWindowingTable = dsp::getWindow( mWindowType, mWindowSize );
 }
 
 // TODO: When mNumChannels > 1, use generic channel converter.
@@ -148,10 +157,10 @@ const std::vector<float>& ScopeSpectral::getMagSpectrum()
 			for( size_t i = 0; i < mWindowSize; i++ )
 				mFftBuffer[i] += mCopiedBuffer.getChannel( ch )[i] * scale;
 		}
-		dsp::mul( mFftBuffer.getData(), mWindowingTable.get(), mFftBuffer.getData(), mWindowSize );
+		dsp::mul( mFftBuffer.getData(), mWindowingTable->getData(), mFftBuffer.getData(), mWindowSize );
 	}
 	else
-		dsp::mul( mCopiedBuffer.getData(), mWindowingTable.get(), mFftBuffer.getData(), mWindowSize );
+		dsp::mul( mCopiedBuffer.getData(), mWindowingTable->getData(), mFftBuffer.getData(), mWindowSize );
 
 	mFft->forward( &mFftBuffer, &mBufferSpectral );
 
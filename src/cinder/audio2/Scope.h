@@ -134,7 +134,7 @@ class ScopeSpectral : public Scope {
 	Buffer						mFftBuffer;			// windowed samples before transform
 	BufferSpectral				mBufferSpectral;	// transformed samples
 	std::vector<float>			mMagSpectrum;		// computed magnitude spectrum from frequency-domain samples
-	AlignedArrayPtr				mWindowingTable;
+	std::shared_ptr<const Buffer>	mWindowingTable;		// shared by all analyzers with the same window type and size
 	size_t						mFftSize;
 	dsp::WindowType				mWindowType;
 	float						mSmoothingFactor;
@@ -114,8 +114,9 @@ BufferRef SourceFile::loadBuffer()
 	BufferRef result = make_shared<Buffer>( mNumFrames, mNumChannels );
 
 	if( mConverter ) {
-		// TODO: need BufferView's in order to reduce number of copies
-		Buffer converterDestBuffer( mConverter->getDestMaxFramesPerBlock(), mNumChannels );
+		// converted frames are written straight into result, except near the end where it may have less room left than the Converter requires.
+		const size_t destMaxFrames = mConverter->getDestMaxFramesPerBlock();
+		Buffer converterDestBuffer;
 		size_t readCount = 0;
 		while( true ) {
 			size_t framesNeeded = min( mMaxFramesPerRead, mFileNumFrames - readCount );
@@ -129,8 +130,18 @@ BufferRef SourceFile::loadBuffer()
 			size_t outNumFrames = performRead( &mConverterReadBuffer, 0, framesNeeded );
 			CI_ASSERT( outNumFrames == framesNeeded );
 
-			pair<size_t, size_t> count = mConverter->convert( &mConverterReadBuffer, &converterDestBuffer );
-			result->copyOffset( converterDestBuffer, count.second, mReadPos, 0 );
+			pair<size_t, size_t> count;
+			if( mNumFrames - mReadPos >= destMaxFrames ) {
+				BufferView resultView( result.get(), mReadPos, destMaxFrames );
+				count = mConverter->convert( &mConverterReadBuffer, &resultView );
+			}
+			else {
+				if( converterDestBuffer.isEmpty() )
+					converterDestBuffer = Buffer( destMaxFrames, mNumChannels );
+
+				count = mConverter->convert( &mConverterReadBuffer, &converterDestBuffer );
+				result->copyOffset( converterDestBuffer, count.second, mReadPos, 0 );
+			}
 
 			readCount += outNumFrames;
 			mReadPos += count.second;
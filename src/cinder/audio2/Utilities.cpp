@@ -22,6 +22,7 @@
  */
 
 #include "cinder/audio2/Utilities.h"
+#include "cinder/audio2/Debug.h"
 #include "cinder/Cinder.h"
 
 #include <cstdlib>
@@ -31,6 +32,13 @@
 	#include <cxxabi.h>
 #endif
 
+#if defined( CINDER_MSW )
+	#include <windows.h>
+#else
+	#include <pthread.h>
+	#include <sched.h>
+#endif
+
 using namespace std;
 
 namespace cinder { namespace audio2 {
@@ -53,18 +61,32 @@ string demangledTypeName( const char *mangledName )
 
 bool thresholdBuffer( const Buffer &buffer, float threshold, size_t *recordFrame )
 {
-	const float *buf = buffer.getData();
-	size_t count = buffer.getSize();
-	for( size_t t = 0; t < count; t++ ) {
-		if( fabs( buf[t] ) > threshold ) {
-			if( recordFrame )
-				*recordFrame = t % buffer.getNumFrames();
-			return true;
+	for( size_t ch = 0; ch < buffer.getNumChannels(); ch++ ) {
+		const float *channel = buffer.getChannel( ch );
+		for( size_t t = 0; t < buffer.getNumFrames(); t++ ) {
+			if( fabs( channel[t] ) > threshold ) {
+				if( recordFrame )
+					*recordFrame = t;
+				return true;
+			}
 		}
 	}
 
 	return false;
 }
 
+void increaseThreadPriority()
+{
+#if defined( CINDER_MSW )
+	if( ! ::SetThreadPriority( ::GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL ) )
+		CI_LOG_W( "Unable to set thread priority, error: " << ::GetLastError() );
+#else
+	::sched_param param;
+	param.sched_priority = ::sched_get_priority_max( SCHED_FIFO ) - 1;
+	int result = ::pthread_setschedparam( ::pthread_self(), SCHED_FIFO, &param );
+	if( result != 0 )
+		CI_LOG_V( "Unable to set SCHED_FIFO (error: " << result << "), using default priority." );
+#endif
+}
 
 } } // namespace cinder::audio2
\ No newline at end of file
@@ -103,6 +103,8 @@ T wrap( T val )
 std::string demangledTypeName( const char *mangledName );
 //! Checks if the absolute value of any sample in \a buffer is over \a threshold. Optionally provide \a recordFrame to record the frame index. \return true if one is found, false otherwise. 
 bool thresholdBuffer( const Buffer &buffer, float threshold, size_t *recordFrame = nullptr );
+//! Raises the priority of the calling thread so that it is suitable for processing audio, such as SCHED_FIFO on posix systems. Failure is logged but otherwise ignored, as this usually requires extra privileges.
+void increaseThreadPriority();
 
 } } // namespace cinder::audio2
 
@@ -26,6 +26,7 @@
 #include "cinder/audio2/NodeEffect.h"
 
 #include <map>
+#include <tuple>
 
 using namespace std;
 using namespace ci;
@@ -52,7 +53,7 @@ public:
 
 	void	addVoice( const VoiceRef &source );
 
-	BufferRef loadBuffer( const SourceFileRef &sourceFile, size_t numChannels );
+	SampleBuffer loadBuffer( const SourceFileRef &sourceFile, size_t numChannels, SampleBuffer::Format sampleFormat );
 
 private:
 	MixerImpl();
@@ -64,7 +65,7 @@ private:
 	};
 
 	std::vector<Bus> mBusses;
-	std::map<std::pair<SourceFileRef, size_t>, BufferRef> mBufferCache;		// key is [shared_ptr, num channels]
+	std::map<std::tuple<SourceFileRef, size_t, SampleBuffer::Format>, SampleBuffer> mBufferCache;		// key is [shared_ptr, num channels, sample format]
 
 	GainRef mMasterGain;
 };
@@ -92,6 +93,9 @@ void MixerImpl::addVoice( const VoiceRef &source )
 {
 	Context *ctx = Context::master();
 
+	// the voice's Node's are published to the audio thread together, once they are all connected.
+	ScopedDeferredRenderGraphUpdates deferredUpdates( ctx );
+
 	source->mBusId = mBusses.size();
 	mBusses.push_back( MixerImpl::Bus() );
 	MixerImpl::Bus &bus = mBusses.back();
@@ -105,14 +109,14 @@ void MixerImpl::addVoice( const VoiceRef &source )
 	bus.mPan->addConnection( mMasterGain );
 }
 
-BufferRef MixerImpl::loadBuffer( const SourceFileRef &sourceFile, size_t numChannels )
+SampleBuffer MixerImpl::loadBuffer( const SourceFileRef &sourceFile, size_t numChannels, SampleBuffer::Format sampleFormat )
 {
-	auto key = make_pair( sourceFile, numChannels );
+	auto key = make_tuple( sourceFile, numChannels, sampleFormat );
 	auto cached = mBufferCache.find( key );
 	if( cached != mBufferCache.end() )
 		return cached->second;
 	else {
-		BufferRef result = sourceFile->loadBuffer();
+		SampleBuffer result = SampleBuffer::create( sourceFile->loadBuffer(), sampleFormat );
 		mBufferCache.insert( make_pair( key, result ) );
 		return result;
 	}
@@ -213,7 +217,7 @@ VoiceSamplePlayer::VoiceSamplePlayer( const SourceFileRef &sourceFile, const Opt
 	sourceFile->setOutputFormat( audio2::master()->getSampleRate(), options.getChannels() );
 
 	if( sourceFile->getNumFrames() <= options.getMaxFramesForBufferPlayback() ) {
-		BufferRef buffer = MixerImpl::get()->loadBuffer( sourceFile, options.getChannels() );
+		SampleBuffer buffer = MixerImpl::get()->loadBuffer( sourceFile, options.getChannels(), options.getSampleFormat() );
 		mNode = Context::master()->makeNode( new BufferPlayer( buffer ) );
 	} else
 		mNode = Context::master()->makeNode( new FilePlayer( sourceFile ) );
@@ -48,19 +48,23 @@ class Voice {
   public:
 	//! Optional parameters passed into Voice::create() methods.
 	struct Options {
-		Options() : mChannels( 0 ), mMaxFramesForBufferPlayback( 96000 ) {}
+		Options() : mChannels( 0 ), mMaxFramesForBufferPlayback( 96000 ), mSampleFormat( SampleBuffer::FLOAT_32 ) {}
 
 		//! Sets the number of channels for the Voice.
 		Options& channels( size_t ch )							{ mChannels = ch; return *this; }
 		//! Sets the maximum number of frames acceptable for a VoiceSamplePlayer to use in-memory buffer playback via BufferPlayer (default = 96,000).
 		//! If the file is larger than this, it will be streamed from disk using a FilePlayer.
 		Options& maxFramesForBufferPlayback( size_t frames )	{ mMaxFramesForBufferPlayback = frames; return *this; }
+		//! Sets the format that samples are stored in for in-memory buffer playback (default = SampleBuffer::FLOAT_32). The integer formats use less memory.
+		Options& sampleFormat( SampleBuffer::Format format )	{ mSampleFormat = format; return *this; }
 
-		size_t			getChannels() const						{ return mChannels; }
-		size_t			getMaxFramesForBufferPlayback() const	{ return mMaxFramesForBufferPlayback; }
+		size_t					getChannels() const						{ return mChannels; }
+		size_t					getMaxFramesForBufferPlayback() const	{ return mMaxFramesForBufferPlayback; }
+		SampleBuffer::Format	getSampleFormat() const					{ return mSampleFormat; }
 
 	protected:
-		size_t			mChannels, mMaxFramesForBufferPlayback;
+		size_t					mChannels, mMaxFramesForBufferPlayback;
+		SampleBuffer::Format	mSampleFormat;
 	};
 
 	//! Creates a Voice that manages sample playback of an audio file pointed at with \a sourceFile.
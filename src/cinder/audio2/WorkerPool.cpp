@@ -0,0 +1,203 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/audio2/WorkerPool.h"
+#include "cinder/audio2/Utilities.h"
+#include "cinder/audio2/CinderAssert.h"
+
+#include <chrono>
+
+using namespace std;
+
+namespace cinder { namespace audio2 {
+
+namespace {
+
+// number of times an idle worker yields before going to sleep, which keeps it responsive between consecutive audio blocks.
+const size_t kNumIdleSpins = 2000;
+// sleeping workers wake up at least this often, in case they missed a notification.
+const chrono::milliseconds kMaxSleepDuration( 2 );
+
+const uint64_t kIndexMask	= 0xFFFFFF;
+const uint64_t kTagMask		= 0xFFFF;
+
+inline uint64_t packRange( uint64_t tag, uint64_t begin, uint64_t end )	{ return ( ( tag & kTagMask ) << 48 ) | ( ( begin & kIndexMask ) << 24 ) | ( end & kIndexMask ); }
+inline uint64_t rangeTag( uint64_t range )		{ return range >> 48; }
+inline uint64_t rangeBegin( uint64_t range )	{ return ( range >> 24 ) & kIndexMask; }
+inline uint64_t rangeEnd( uint64_t range )		{ return range & kIndexMask; }
+
+} // anonymous namespace
+
+WorkerPool::WorkerPool( size_t numThreads )
+	: mGeneration( 0 ), mNumRemainingTasks( 0 ), mInvokeFn( nullptr ), mTaskFn( nullptr ), mBusy( false ), mRunning( true ), mRealtime( true )
+{
+	startThreads( numThreads );
+}
+
+WorkerPool::WorkerPool( const Options &options )
+	: mGeneration( 0 ), mNumRemainingTasks( 0 ), mInvokeFn( nullptr ), mTaskFn( nullptr ), mBusy( false ), mRunning( true ), mRealtime( options.isRealtime() )
+{
+	startThreads( options.getNumThreads() );
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		lock_guard<mutex> lock( mSleepMutex );
+		mRunning = false;
+	}
+	mSleepCondition.notify_all();
+
+	for( auto &t : mThreads )
+		t.join();
+}
+
+void WorkerPool::startThreads( size_t numThreads )
+{
+	if( ! numThreads ) {
+		size_t hardwareThreads = thread::hardware_concurrency();
+		numThreads = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+
+	// queue 0 belongs to the thread that calls run()
+	mNumQueues = numThreads + 1;
+	mQueues.reset( new Queue[mNumQueues] );
+
+	for( size_t i = 0; i < numThreads; i++ )
+		mThreads.emplace_back( bind( &WorkerPool::workerLoop, this, i + 1 ) );
+}
+
+void WorkerPool::runImpl( size_t numTasks, InvokeFn invokeFn, const void *taskFn )
+{
+	CI_ASSERT( numTasks <= kIndexMask );
+
+	// if there is nothing to parallelize or another thread is currently using the pool, process on this thread.
+	if( numTasks < 2 || mThreads.empty() || mBusy.exchange( true ) ) {
+		for( size_t i = 0; i < numTasks; i++ )
+			invokeFn( taskFn, i );
+		return;
+	}
+
+	// Publish the batch. Workers only claim tasks from ranges tagged with the generation they observed, so one that
+	// wakes late from a previous batch can not run this batch's tasks with a stale task function.
+	uint64_t generation = mGeneration.load( memory_order_relaxed ) + 1;
+	mInvokeFn.store( invokeFn, memory_order_relaxed );
+	mTaskFn.store( taskFn, memory_order_relaxed );
+	mNumRemainingTasks.store( numTasks, memory_order_relaxed );
+
+	for( size_t q = 0; q < mNumQueues; q++ ) {
+		uint64_t begin = numTasks * q / mNumQueues;
+		uint64_t end = numTasks * ( q + 1 ) / mNumQueues;
+		mQueues[q].mRange.store( packRange( generation, begin, end ), memory_order_relaxed );
+	}
+
+	mGeneration.store( generation, memory_order_release );
+
+	// Briefly taking the sleep mutex ensures that a worker between checking for a new batch and going to sleep receives the
+	// notification. try_lock never blocks this thread; in the rare case that it fails, the worker wakes up on its own after kMaxSleepDuration.
+	if( mSleepMutex.try_lock() )
+		mSleepMutex.unlock();
+	mSleepCondition.notify_all();
+
+	executeTasks( 0, generation & kTagMask );
+
+	// join: wait for tasks claimed by the workers to finish.
+	while( mNumRemainingTasks.load( memory_order_acquire ) )
+		this_thread::yield();
+
+	mBusy = false;
+}
+
+void WorkerPool::workerLoop( size_t queueIndex )
+{
+	if( mRealtime )
+		increaseThreadPriority();
+
+	uint64_t lastGeneration = mGeneration.load( memory_order_acquire );
+	size_t numSpins = 0;
+
+	while( mRunning ) {
+		uint64_t generation = mGeneration.load( memory_order_acquire );
+		if( generation != lastGeneration ) {
+			lastGeneration = generation;
+			executeTasks( queueIndex, generation & kTagMask );
+			numSpins = 0;
+			continue;
+		}
+
+		if( mRealtime && numSpins++ < kNumIdleSpins ) {
+			this_thread::yield();
+			continue;
+		}
+
+		unique_lock<mutex> lock( mSleepMutex );
+		mSleepCondition.wait_for( lock, kMaxSleepDuration, [&] {
+			return ! mRunning || mGeneration.load( memory_order_acquire ) != lastGeneration;
+		} );
+	}
+}
+
+void WorkerPool::executeTasks( size_t queueIndex, uint64_t tag )
+{
+	InvokeFn invokeFn = mInvokeFn.load( memory_order_acquire );
+	const void *taskFn = mTaskFn.load( memory_order_acquire );
+
+	size_t task;
+	while( true ) {
+		// first drain our own queue from the front
+		bool claimed = claimTask( queueIndex, tag, false, &task );
+
+		// then steal from the back of the other queues
+		for( size_t i = 1; ! claimed && i < mNumQueues; i++ )
+			claimed = claimTask( ( queueIndex + i ) % mNumQueues, tag, true, &task );
+
+		if( ! claimed )
+			break;
+
+		invokeFn( taskFn, task );
+		mNumRemainingTasks.fetch_sub( 1, memory_order_release );
+	}
+}
+
+bool WorkerPool::claimTask( size_t queueIndex, uint64_t tag, bool fromBack, size_t *task )
+{
+	auto &range = mQueues[queueIndex].mRange;
+	uint64_t current = range.load( memory_order_acquire );
+
+	while( true ) {
+		uint64_t begin = rangeBegin( current );
+		uint64_t end = rangeEnd( current );
+		if( rangeTag( current ) != tag || begin >= end )
+			return false;
+
+		uint64_t claimedTask = fromBack ? end - 1 : begin;
+		uint64_t desired = fromBack ? packRange( tag, begin, end - 1 ) : packRange( tag, begin + 1, end );
+
+		if( range.compare_exchange_weak( current, desired, memory_order_acq_rel, memory_order_acquire ) ) {
+			*task = (size_t)claimedTask;
+			return true;
+		}
+	}
+}
+
+} } // namespace cinder::audio2
@@ -0,0 +1,122 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <boost/noncopyable.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cinder { namespace audio2 {
+
+typedef std::shared_ptr<class WorkerPool>	WorkerPoolRef;
+
+//! \brief Pool of worker threads that execute a batch of independent tasks in parallel, suitable for use within an audio callback.
+//!
+//! run() splits the task indices evenly between the calling thread and the workers. Each thread first takes tasks from its own
+//! queue, then steals from the back of the others' queues once it runs out, and run() returns once all tasks have completed.
+//! Claiming a task is a single compare-and-swap, so the calling thread never blocks on a lock. By default the workers run at realtime
+//! priority and idle workers spin briefly before sleeping, see Options::realtime().
+//!
+//! Only one batch is processed at a time. If run() is called while the pool is busy with another thread's batch, the tasks are
+//! executed on the calling thread instead. This lets many Context's share one pool without oversubscribing the cores, see Context::setWorkerPool().
+class WorkerPool : public boost::noncopyable {
+  public:
+	struct Options {
+		Options() : mNumThreads( 0 ), mRealtime( true ) {}
+
+		//! Sets the number of worker threads, in addition to the thread that calls run(). If 0 (default), one less than the number of hardware threads is used.
+		Options& numThreads( size_t numThreads )	{ mNumThreads = numThreads; return *this; }
+		//! Sets whether the workers run at realtime priority and spin briefly before sleeping, which keeps them responsive between
+		//! consecutive audio blocks (default = true). Pools used for long-running offline work should disable this, otherwise they can
+		//! starve the rest of the system.
+		Options& realtime( bool realtime )			{ mRealtime = realtime; return *this; }
+
+		size_t	getNumThreads() const	{ return mNumThreads; }
+		bool	isRealtime() const		{ return mRealtime; }
+
+	  protected:
+		size_t	mNumThreads;
+		bool	mRealtime;
+	};
+
+	//! Creates a realtime WorkerPool with \a numThreads worker threads, in addition to the thread that calls run(). If \a numThreads is 0, one less than the number of hardware threads is used.
+	WorkerPool( size_t numThreads = 0 );
+	//! Creates a WorkerPool configured with \a options.
+	WorkerPool( const Options &options );
+	~WorkerPool();
+
+	//! Returns the number of worker threads, not including the thread that calls run().
+	size_t getNumThreads() const	{ return mThreads.size(); }
+	//! Returns whether the workers run at realtime priority and spin before sleeping. \see Options::realtime()
+	bool isRealtime() const			{ return mRealtime; }
+
+	//! Calls \a taskFn( i ) for each i in [0:numTasks) across the worker threads and the calling thread, returning once all tasks have completed.
+	//! \a taskFn is not copied, so it does not allocate.
+	template <typename TaskFnT>
+	void run( size_t numTasks, const TaskFnT &taskFn )
+	{
+		runImpl( numTasks, &invokeTask<TaskFnT>, &taskFn );
+	}
+
+  private:
+	typedef void (*InvokeFn)( const void *taskFn, size_t task );
+
+	template <typename TaskFnT>
+	static void invokeTask( const void *taskFn, size_t task )	{ ( *static_cast<const TaskFnT *>( taskFn ) )( task ); }
+
+	// Range of task indices [begin:end), along with the tag of the batch it belongs to, packed so that it can be claimed with one CAS.
+	struct Queue {
+		Queue() : mRange( 0 ) {}
+
+		std::atomic<uint64_t>	mRange;
+		char					mPadding[64 - sizeof( std::atomic<uint64_t> )]; // avoid false sharing between queues
+	};
+
+	void startThreads( size_t numThreads );
+	void runImpl( size_t numTasks, InvokeFn invokeFn, const void *taskFn );
+	void workerLoop( size_t queueIndex );
+	void executeTasks( size_t queueIndex, uint64_t tag );
+	bool claimTask( size_t queueIndex, uint64_t tag, bool fromBack, size_t *task );
+
+	std::vector<std::thread>	mThreads;
+	std::unique_ptr<Queue[]>	mQueues;
+	size_t						mNumQueues;
+
+	std::atomic<uint64_t>		mGeneration;
+	std::atomic<size_t>			mNumRemainingTasks;
+	std::atomic<InvokeFn>		mInvokeFn;
+	std::atomic<const void *>	mTaskFn;
+	std::atomic<bool>			mBusy, mRunning;
+	bool						mRealtime;
+
+	std::mutex					mSleepMutex;
+	std::condition_variable		mSleepCondition;
+};
+
+} } // namespace cinder::audio2
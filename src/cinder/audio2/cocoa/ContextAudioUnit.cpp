@@ -141,19 +141,11 @@ OSStatus LineOutAudioUnit::renderCallback( void *data, ::AudioUnitRenderActionFl
 		return noErr;
 	}
 
-	lock_guard<mutex> lock( renderData->context->getMutex() );
-
-	// verify associated context still exists proceeding, which may not be true if we blocked in ~Context() and were then subsequently deallocated.
-	if( ! renderData->context ) {
-		zeroBufferList( bufferList );
-		return noErr;
-	}
-
 	LineOutAudioUnit *lineOut = static_cast<LineOutAudioUnit *>( renderData->node );
 	lineOut->mInternalBuffer.zero();
 
 	renderData->context->setCurrentTimeStamp( timeStamp );
-	lineOut->pullInputs( &lineOut->mInternalBuffer );
+	lineOut->processGraph();
 
 	// if clip detection is enabled and buffer clipped, silence it
 	if( lineOut->checkNotClipping() )
@@ -302,9 +294,13 @@ void LineInAudioUnit::process( Buffer *buffer )
 		copyFromBufferList( buffer, mBufferList.get() );
 	}
 	else {
-		// copy from ringbuffer. If not possible, store the timestamp of the underrun
-		if( ! mRingBuffer.read( buffer->getData(), buffer->getSize() ) )
+		// copy from ringbuffer, one channel at a time since they may be padded. If not possible, store the timestamp of the underrun
+		if( mRingBuffer.getAvailableRead() < buffer->getSize() )
 			markUnderrun();
+		else {
+			for( size_t ch = 0; ch < buffer->getNumChannels(); ch++ )
+				mRingBuffer.read( buffer->getChannel( ch ), buffer->getNumFrames() );
+		}
 	}
 }
 
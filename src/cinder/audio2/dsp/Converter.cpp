@@ -23,6 +23,7 @@
 
 #include "cinder/audio2/dsp/Converter.h"
 #include "cinder/audio2/dsp/Dsp.h"
+#include "cinder/audio2/dsp/Simd.h"
 #include "cinder/audio2/dsp/ConverterR8brain.h"
 #include "cinder/audio2/CinderAssert.h"
 
@@ -30,7 +31,12 @@
 	#include "cinder/audio2/cocoa/CinderCoreAudio.h"
 #endif
 
+#if defined( CINDER_AUDIO_VDSP )
+	#include <Accelerate/Accelerate.h>
+#endif
+
 #include <algorithm>
+#include <cmath>
 
 using namespace ci;
 using namespace std;
@@ -110,4 +116,64 @@ void sumBuffers( const Buffer *sourceBuffer, Buffer *destBuffer, size_t numFrame
 		CI_ASSERT( 0 && "unhandled" );
 }
 
+namespace {
+
+const float kInt16Scale = 32768.0f;
+const float kInt24Scale = 8388608.0f;
+
+// scales \a sample to an integer of \a scale steps either side of zero, rounded and clipped to the integer's range.
+inline int32_t quantize( float sample, float scale )
+{
+	float scaled = std::floor( sample * scale + 0.5f );
+	return int32_t( std::max( -scale, std::min( scale - 1.0f, scaled ) ) );
+}
+
+} // anonymous namespace
+
+#if defined( CINDER_AUDIO_VDSP )
+
+void convert( const int16_t *sourceArray, float *destArray, size_t length )
+{
+	const float scale = 1.0f / kInt16Scale;
+	vDSP_vflt16( sourceArray, 1, destArray, 1, length );
+	vDSP_vsmul( destArray, 1, &scale, destArray, 1, length );
+}
+
+void convert( const Int24 *sourceArray, float *destArray, size_t length )
+{
+	const float scale = 1.0f / kInt24Scale;
+	vDSP_vflt24( reinterpret_cast<const vDSP_int24 *>( sourceArray ), 1, destArray, 1, length );
+	vDSP_vsmul( destArray, 1, &scale, destArray, 1, length );
+}
+
+#else // ! defined( CINDER_AUDIO_VDSP )
+
+void convert( const int16_t *sourceArray, float *destArray, size_t length )
+{
+	getSimdKernels().mInt16ToFloat( sourceArray, 1.0f / kInt16Scale, destArray, length );
+}
+
+void convert( const Int24 *sourceArray, float *destArray, size_t length )
+{
+	getSimdKernels().mInt24ToFloat( reinterpret_cast<const uint8_t *>( sourceArray ), 1.0f / kInt24Scale, destArray, length );
+}
+
+#endif // ! defined( CINDER_AUDIO_VDSP )
+
+void convert( const float *sourceArray, int16_t *destArray, size_t length )
+{
+	for( size_t i = 0; i < length; i++ )
+		destArray[i] = int16_t( quantize( sourceArray[i], kInt16Scale ) );
+}
+
+void convert( const float *sourceArray, Int24 *destArray, size_t length )
+{
+	for( size_t i = 0; i < length; i++ ) {
+		uint32_t value = uint32_t( quantize( sourceArray[i], kInt24Scale ) );
+		destArray[i].mBytes[0] = uint8_t( value );
+		destArray[i].mBytes[1] = uint8_t( value >> 8 );
+		destArray[i].mBytes[2] = uint8_t( value >> 16 );
+	}
+}
+
 } } } // namespace cinder::audio2::dsp
\ No newline at end of file
@@ -65,6 +65,15 @@ void sumBuffers( const Buffer *sourceBuffer, Buffer *destBuffer, size_t numFrame
 //! Sums \a sourceBuffer into \a destBuffer. Channel up or down mixing is applied if necessary. Unequal frame counts are permitted (the minimum size will be used).
 inline void sumBuffers( const Buffer *sourceBuffer, Buffer *destBuffer )	{ sumBuffers( sourceBuffer, destBuffer, std::min( sourceBuffer->getNumFrames(), destBuffer->getNumFrames() ) ); }
 
+//! Converts \a length 16-bit samples from \a sourceArray to floats in the range [-1, 1) in \a destArray.
+void convert( const int16_t *sourceArray, float *destArray, size_t length );
+//! Converts \a length floats from \a sourceArray to 16-bit samples in \a destArray, rounding them and clipping them to the range [-1, 1).
+void convert( const float *sourceArray, int16_t *destArray, size_t length );
+//! Converts \a length packed 24-bit samples from \a sourceArray to floats in the range [-1, 1) in \a destArray.
+void convert( const Int24 *sourceArray, float *destArray, size_t length );
+//! Converts \a length floats from \a sourceArray to packed 24-bit samples in \a destArray, rounding them and clipping them to the range [-1, 1).
+void convert( const float *sourceArray, Int24 *destArray, size_t length );
+
 template <typename SourceT, typename DestT>
 void convert( const SourceT *sourceArray, DestT *destArray, size_t length )
 {
@@ -22,14 +22,19 @@
 */
 
 #include "cinder/audio2/dsp/Dsp.h"
+#include "cinder/audio2/dsp/Simd.h"
 
 #include "cinder/CinderMath.h"
 
+#include <map>
+#include <mutex>
+
 #if defined( CINDER_AUDIO_VDSP )
 	#include <Accelerate/Accelerate.h>
 #endif
 
 using namespace ci;
+using namespace std;
 
 namespace cinder { namespace audio2 { namespace dsp {
 
@@ -105,6 +110,17 @@ void addMul( const float *arrayA, const float *arrayB, float scalar, float *resu
 	vDSP_vasm( const_cast<float *>( arrayA ), 1, const_cast<float *>( arrayB ), 1, &scalar, result, 1, length );
 }
 
+namespace {
+
+float maxElement( const float *array, size_t length )
+{
+	float result;
+	vDSP_maxv( const_cast<float *>( array ), 1, &result, length );
+	return result;
+}
+
+} // anonymous namespace
+
 #else // ! defined( CINDER_AUDIO_VDSP )
 
 // from WebKit's applyWindow in RealtimeAnalyser.cpp
@@ -124,81 +140,86 @@ void generateBlackmanWindow( float *window, size_t length )
 
 void generateHammWindow( float *window, size_t length )
 {
-	CI_ASSERT( 0 && "not implemented" );
+	double oneOverN = 1.0 / static_cast<double>( length );
+
+	for( size_t i = 0; i < length; i++ ) {
+		double x = static_cast<double>(i) * oneOverN;
+		window[i] = float( 0.54 - 0.46 * cos( 2.0 * M_PI * x ) );
+	}
 }
 
 void generateHannWindow( float *window, size_t length )
 {
-	CI_ASSERT( 0 && "not implemented" );
+	double oneOverN = 1.0 / static_cast<double>( length );
+
+	for( size_t i = 0; i < length; i++ ) {
+		double x = static_cast<double>(i) * oneOverN;
+		window[i] = float( 0.5 - 0.5 * cos( 2.0 * M_PI * x ) );
+	}
 }
 
+// the vector functions below dispatch to the widest SimdKernels the CPU supports, see Simd.h
+
 void fill( float value, float *array, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		array[i] = value;
+	getSimdKernels().mFill( value, array, length );
 }
 
 float sum( const float *array, size_t length )
 {
-	float result( 0.0f );
-	for( size_t i = 0; i < length; i++ )
-		result += array[i];
-	return result;
+	return getSimdKernels().mSum( array, length );
 }
 
 void add( const float *array, float scalar, float *result, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		result[i] = array[i] + scalar;
+	getSimdKernels().mAddScalar( array, scalar, result, length );
 }
 
 void add( const float *arrayA, const float *arrayB, float *result, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		result[i] = arrayA[i] + arrayB[i];
+	getSimdKernels().mAdd( arrayA, arrayB, result, length );
 }
 
 void sub( const float *array, float scalar, float *result, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		result[i] = array[i] - scalar;
+	getSimdKernels().mAddScalar( array, -scalar, result, length );
 }
 
 void sub( const float *arrayA, const float *arrayB, float *result, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		result[i] = arrayA[i] - arrayB[i];
+	getSimdKernels().mSub( arrayA, arrayB, result, length );
 }
 
 float rms( const float *array, size_t length )
 {
-	float sumSquared( 0.0f );
-	for( size_t i = 0; i < length; i++ ) {
-		float val = array[i];
-		sumSquared += val * val;
-	}
-
+	float sumSquared = getSimdKernels().mSumSquares( array, length );
 	return math<float>::sqrt( sumSquared / (float)length );
 }
 
 void mul( const float *array, float scalar, float *result, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		result[i] = array[i] * scalar;
+	getSimdKernels().mMulScalar( array, scalar, result, length );
 }
 
 void mul( const float *arrayA, const float *arrayB, float *result, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		result[i] = arrayA[i] * arrayB[i];
+	getSimdKernels().mMul( arrayA, arrayB, result, length );
 }
 
 void addMul( const float *arrayA, const float *arrayB, float scalar, float *result, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		result[i] = ( arrayA[i] + arrayB[i] ) * scalar;
+	getSimdKernels().mAddMul( arrayA, arrayB, scalar, result, length );
+}
+
+namespace {
+
+float maxElement( const float *array, size_t length )
+{
+	return getSimdKernels().mMax( array, length );
 }
 
+} // anonymous namespace
+
 #endif // ! defined( CINDER_AUDIO_VDSP )
 
 
@@ -221,6 +242,32 @@ void generateWindow( WindowType windowType, float *window, size_t length )
 	}
 }
 
+namespace {
+
+// process-wide cache for getWindow(), tables are never removed so the returned pointers stay valid.
+mutex sWindowCacheMutex;
+map<pair<WindowType, size_t>, shared_ptr<const Buffer> > sWindowCache;
+
+} // anonymous namespace
+
+shared_ptr<const Buffer> getWindow( WindowType windowType, size_t length )
+{
+	lock_guard<mutex> lock( sWindowCacheMutex );
+
+	auto key = make_pair( windowType, length );
+	auto cached = sWindowCache.find( key );
+	if( cached != sWindowCache.end() )
+		return cached->second;
+	else {
+		auto window = make_shared<Buffer>( length );
+		generateWindow( windowType, window->getData(), length );
+
+		shared_ptr<const Buffer> result = window;
+		sWindowCache.insert( make_pair( key, result ) );
+		return result;
+	}
+}
+
 void divide( const float *array, float scalar, float *result, size_t length )
 {
 	mul( array, 1 / scalar, result, length );
@@ -228,12 +275,7 @@ void divide( const float *array, float scalar, float *result, size_t length )
 
 void normalize( float *array, size_t length, float maxValue )
 {
-	float max = 0;
-	for( size_t i = 0; i < length; i++ ) {
-		if( max < array[i] )
-			max = array[i];
-	}
-
+	float max = maxElement( array, length );
 	if( max > 0.00001f ) {
 		mul( array, maxValue / max, array, length );
 	}
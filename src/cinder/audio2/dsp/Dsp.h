@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include "cinder/audio2/Buffer.h"
 #include "cinder/audio2/CinderAssert.h"
 
 #include "cinder/Cinder.h"
@@ -32,6 +33,7 @@
 #endif
 
 #include <atomic>
+#include <memory>
 #include <vector>
 #include <cmath>
 
@@ -53,6 +55,9 @@ enum WindowType {
 
 //! fills \a window array with a windowing function specified by \a windowType
 void generateWindow( WindowType windowType, float *window, size_t length );
+//! Returns a window of \a length samples specified by \a windowType, generating it on the first request. Windows are cached for
+//! the lifetime of the process and are immutable, so any number of analyzers and threads can share one table. Thread-safe.
+std::shared_ptr<const Buffer> getWindow( WindowType windowType, size_t length );
 //! fills \a array with value \a value
 void fill( float value, float *array, size_t length );
 //! add \a scalar to \a array of length \a length, into \a result.
@@ -134,7 +134,9 @@ void Fft::inverse( const BufferSpectral *spectral, Buffer *waveform )
 	CI_ASSERT( waveform->getNumFrames() == mSize );
 	CI_ASSERT( spectral->getNumFrames() == mSizeOverTwo );
 
-	mBufferCopy.copy( *spectral );
+	// spectral has two channels of half the size, so its real and imaginary parts are copied as one array.
+	std::copy( spectral->getReal(), spectral->getReal() + mSizeOverTwo, mBufferCopy.getData() );
+	std::copy( spectral->getImag(), spectral->getImag() + mSizeOverTwo, mBufferCopy.getData() + mSizeOverTwo );
 
 	float *real = mBufferCopy.getData();
 	float *imag = &mBufferCopy.getData()[mSizeOverTwo];
@@ -23,9 +23,11 @@
 
 #pragma once
 
+#include "cinder/audio2/MemoryPool.h"
 #include "cinder/audio2/CinderAssert.h"
 
 #include <atomic>
+#include <cstring>
 
 namespace cinder { namespace audio2 { namespace dsp {
 
@@ -35,6 +37,8 @@ namespace cinder { namespace audio2 { namespace dsp {
 //!
 //! The implementation remains lock-free and thread-safe within a single write thread / single read thread context.
 //!
+//! The internal buffer is aligned to MemoryPool::getAlignment().
+//!
 //! \note \a T must be POD.
 template <typename T>
 class RingBufferT {
@@ -42,7 +46,7 @@ public:
 	//! Constructs a RingBufferT with size = 0
 	RingBufferT() : mData( nullptr ), mAllocatedSize( 0 ), mWriteIndex( 0 ), mReadIndex( 0 ) {}
 	//! Constructs a RingBufferT with \a count maximum elements.
-	RingBufferT( size_t count ) : mAllocatedSize( 0 )
+	RingBufferT( size_t count ) : mData( nullptr ), mAllocatedSize( 0 )
 	{
 		resize( count );
 	}
@@ -56,8 +60,7 @@ public:
 
 	~RingBufferT()
 	{
-		if( mData )
-			free( mData );
+		MemoryPool::deallocate( mData );
 	}
 
 	//! Resizes the container to contain \a count maximum elements. Invalidates the internal buffer and resets read / write indices to 0.
@@ -65,12 +68,11 @@ public:
 	{
 		size_t allocatedSize = count + 1; // one bin is used to distinguish between the read and write indices when full.
 
-		if( mAllocatedSize )
-			mData = (T *)::realloc( mData, allocatedSize * sizeof( T ) );
-		else
-			mData = (T *)::calloc( allocatedSize, sizeof( T ) );
+		T *data = static_cast<T *>( MemoryPool::allocate( nullptr, allocatedSize * sizeof( T ) ) );
+		std::memset( data, 0, allocatedSize * sizeof( T ) );
 
-		CI_ASSERT( mData );
+		MemoryPool::deallocate( mData );
+		mData = data;
 
 		mAllocatedSize = allocatedSize;
 		mWriteIndex = 0;
@@ -0,0 +1,653 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/audio2/dsp/Simd.h"
+#include "cinder/audio2/CinderAssert.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#if defined( _M_X64 ) || defined( _M_IX86 ) || defined( __x86_64__ ) || defined( __i386__ )
+	#define CINDER_AUDIO_SIMD_X86
+#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+	#define CINDER_AUDIO_SIMD_NEON
+#endif
+
+// The x86 kernels are compiled for their instruction set per function, so that the rest of the library keeps its baseline
+// architecture flags and the wider kernels are only ever called after the CPU has been checked for them.
+#if defined( CINDER_AUDIO_SIMD_X86 )
+	#include <immintrin.h>
+
+	#if defined( _MSC_VER )
+		#include <intrin.h>
+		#define CINDER_AUDIO_TARGET( isa )
+		#if _MSC_VER >= 1800
+			#define CINDER_AUDIO_SIMD_AVX
+		#endif
+		#if _MSC_VER >= 1911
+			#define CINDER_AUDIO_SIMD_AVX512
+		#endif
+	#else
+		#include <cpuid.h>
+		#define CINDER_AUDIO_TARGET( isa ) __attribute__(( target( isa ) ))
+		#if defined( __clang__ ) || ( __GNUC__ > 4 ) || ( __GNUC__ == 4 && __GNUC_MINOR__ >= 9 )
+			#define CINDER_AUDIO_SIMD_AVX
+		#endif
+		#if defined( __clang__ ) || ( __GNUC__ >= 5 )
+			#define CINDER_AUDIO_SIMD_AVX512
+		#endif
+	#endif
+#elif defined( CINDER_AUDIO_SIMD_NEON )
+	#include <arm_neon.h>
+#endif
+
+using namespace std;
+
+namespace cinder { namespace audio2 { namespace dsp {
+
+// MARK: - Scalar reference
+
+namespace scalar {
+
+void fill( float value, float *array, size_t length )
+{
+	for( size_t i = 0; i < length; i++ )
+		array[i] = value;
+}
+
+float sum( const float *array, size_t length )
+{
+	float result = 0;
+	for( size_t i = 0; i < length; i++ )
+		result += array[i];
+	return result;
+}
+
+float sumSquares( const float *array, size_t length )
+{
+	float result = 0;
+	for( size_t i = 0; i < length; i++ )
+		result += array[i] * array[i];
+	return result;
+}
+
+float max( const float *array, size_t length )
+{
+	if( ! length )
+		return 0;
+
+	float result = array[0];
+	for( size_t i = 1; i < length; i++ )
+		result = std::max( result, array[i] );
+	return result;
+}
+
+void addScalar( const float *array, float scalar, float *result, size_t length )
+{
+	for( size_t i = 0; i < length; i++ )
+		result[i] = array[i] + scalar;
+}
+
+void add( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	for( size_t i = 0; i < length; i++ )
+		result[i] = arrayA[i] + arrayB[i];
+}
+
+void sub( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	for( size_t i = 0; i < length; i++ )
+		result[i] = arrayA[i] - arrayB[i];
+}
+
+void mulScalar( const float *array, float scalar, float *result, size_t length )
+{
+	for( size_t i = 0; i < length; i++ )
+		result[i] = array[i] * scalar;
+}
+
+void mul( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	for( size_t i = 0; i < length; i++ )
+		result[i] = arrayA[i] * arrayB[i];
+}
+
+void addMul( const float *arrayA, const float *arrayB, float scalar, float *result, size_t length )
+{
+	for( size_t i = 0; i < length; i++ )
+		result[i] = ( arrayA[i] + arrayB[i] ) * scalar;
+}
+
+// the bytes are assembled in the top of an int32_t, so that shifting it back down extends the sign.
+inline int32_t int24ToInt32( const uint8_t *bytes )
+{
+	uint32_t value = ( uint32_t( bytes[0] ) << 8 ) | ( uint32_t( bytes[1] ) << 16 ) | ( uint32_t( bytes[2] ) << 24 );
+	return int32_t( value ) >> 8;
+}
+
+void int16ToFloat( const int16_t *array, float scale, float *result, size_t length )
+{
+	for( size_t i = 0; i < length; i++ )
+		result[i] = float( array[i] ) * scale;
+}
+
+void int24ToFloat( const uint8_t *bytes, float scale, float *result, size_t length )
+{
+	for( size_t i = 0; i < length; i++ )
+		result[i] = float( int24ToInt32( bytes + i * 3 ) ) * scale;
+}
+
+const SimdKernels sKernels = { "scalar", fill, sum, sumSquares, max, addScalar, add, sub, mulScalar, mul, addMul, int16ToFloat, int24ToFloat };
+
+} // namespace scalar
+
+// MARK: - Vector kernels
+
+namespace {
+
+// returns the 4 bytes at \a bytes as a little-endian integer, where the bytes of a 24-bit sample are followed by one more.
+inline int32_t loadInt32( const uint8_t *bytes )
+{
+	int32_t result;
+	memcpy( &result, bytes, sizeof( result ) );
+	return result;
+}
+
+} // anonymous namespace
+
+// Defines the kernels for one instruction set in namespace ISA, given its vector type, the number of floats per vector and the
+// intrinsics for each operation. HSUM and HMAX reduce a vector to a float and ZEROUPPER is called once the wide registers are
+// no longer needed, which avoids the penalty of mixing AVX with the caller's SSE code. Loads and stores are unaligned, the
+// remaining ( length % WIDTH ) elements are handled by scalar loops and the reductions use two accumulators to hide latency.
+// LOAD_INT16 and LOAD_INT24 load WIDTH integer samples as floats. LOAD_INT24 may read up to 4 bytes past the last sample, so the
+// 24-bit loop stops two samples early.
+#define CINDER_AUDIO_SIMD_KERNELS( ISA, TARGET, VEC, WIDTH, LOAD, STORE, SET1, ADD, SUB, MUL, MAX, HSUM, HMAX, ZEROUPPER, LOAD_INT16, LOAD_INT24 )	\
+namespace ISA {																													\
+																																\
+TARGET void fill( float value, float *array, size_t length )																	\
+{																																\
+	VEC v = SET1( value );																										\
+	size_t i = 0;																												\
+	for( ; i + WIDTH <= length; i += WIDTH )																					\
+		STORE( array + i, v );																									\
+	ZEROUPPER;																													\
+	for( ; i < length; i++ )																									\
+		array[i] = value;																										\
+}																																\
+																																\
+TARGET float sum( const float *array, size_t length )																			\
+{																																\
+	VEC acc0 = SET1( 0.0f );																									\
+	VEC acc1 = SET1( 0.0f );																									\
+	size_t i = 0;																												\
+	for( ; i + 2 * WIDTH <= length; i += 2 * WIDTH ) {																			\
+		acc0 = ADD( acc0, LOAD( array + i ) );																					\
+		acc1 = ADD( acc1, LOAD( array + i + WIDTH ) );																			\
+	}																															\
+	if( i + WIDTH <= length ) {																									\
+		acc0 = ADD( acc0, LOAD( array + i ) );																					\
+		i += WIDTH;																												\
+	}																															\
+	float result = HSUM( ADD( acc0, acc1 ) );																					\
+	ZEROUPPER;																													\
+	for( ; i < length; i++ )																									\
+		result += array[i];																										\
+	return result;																												\
+}																																\
+																																\
+TARGET float sumSquares( const float *array, size_t length )																	\
+{																																\
+	VEC acc0 = SET1( 0.0f );																									\
+	VEC acc1 = SET1( 0.0f );																									\
+	size_t i = 0;																												\
+	for( ; i + 2 * WIDTH <= length; i += 2 * WIDTH ) {																			\
+		VEC a = LOAD( array + i );																								\
+		VEC b = LOAD( array + i + WIDTH );																						\
+		acc0 = ADD( acc0, MUL( a, a ) );																						\
+		acc1 = ADD( acc1, MUL( b, b ) );																						\
+	}																															\
+	if( i + WIDTH <= length ) {																									\
+		VEC a = LOAD( array + i );																								\
+		acc0 = ADD( acc0, MUL( a, a ) );																						\
+		i += WIDTH;																												\
+	}																															\
+	float result = HSUM( ADD( acc0, acc1 ) );																					\
+	ZEROUPPER;																													\
+	for( ; i < length; i++ )																									\
+		result += array[i] * array[i];																							\
+	return result;																												\
+}																																\
+																																\
+TARGET float max( const float *array, size_t length )																			\
+{																																\
+	if( ! length )																												\
+		return 0;																												\
+																																\
+	float result = array[0];																									\
+	size_t i = 0;																												\
+	if( length >= WIDTH ) {																										\
+		VEC acc = LOAD( array );																								\
+		for( i = WIDTH; i + WIDTH <= length; i += WIDTH )																		\
+			acc = MAX( acc, LOAD( array + i ) );																				\
+		result = HMAX( acc );																									\
+	}																															\
+	ZEROUPPER;																													\
+	for( ; i < length; i++ )																									\
+		result = std::max( result, array[i] );																					\
+	return result;																												\
+}																																\
+																																\
+TARGET void addScalar( const float *array, float scalar, float *result, size_t length )											\
+{																																\
+	VEC s = SET1( scalar );																										\
+	size_t i = 0;																												\
+	for( ; i + WIDTH <= length; i += WIDTH )																					\
+		STORE( result + i, ADD( LOAD( array + i ), s ) );																		\
+	ZEROUPPER;																													\
+	for( ; i < length; i++ )																									\
+		result[i] = array[i] + scalar;																							\
+}																																\
+																																\
+TARGET void add( const float *arrayA, const float *arrayB, float *result, size_t length )										\
+{																																\
+	size_t i = 0;																												\
+	for( ; i + WIDTH <= length; i += WIDTH )																					\
+		STORE( result + i, ADD( LOAD( arrayA + i ), LOAD( arrayB + i ) ) );														\
+	ZEROUPPER;																													\
+	for( ; i < length; i++ )																									\
+		result[i] = arrayA[i] + arrayB[i];																						\
+}																																\
+																																\
+TARGET void sub( const float *arrayA, const float *arrayB, float *result, size_t length )										\
+{																																\
+	size_t i = 0;																												\
+	for( ; i + WIDTH <= length; i += WIDTH )																					\
+		STORE( result + i, SUB( LOAD( arrayA + i ), LOAD( arrayB + i ) ) );														\
+	ZEROUPPER;																													\
+	for( ; i < length; i++ )																									\
+		result[i] = arrayA[i] - arrayB[i];																						\
+}																																\
+																																\
+TARGET void mulScalar( const float *array, float scalar, float *result, size_t length )											\
+{																																\
+	VEC s = SET1( scalar );																										\
+	size_t i = 0;																												\
+	for( ; i + WIDTH <= length; i += WIDTH )																					\
+		STORE( result + i, MUL( LOAD( array + i ), s ) );																		\
+	ZEROUPPER;																													\
+	for( ; i < length; i++ )																									\
+		result[i] = array[i] * scalar;																							\
+}																																\
+																																\
+TARGET void mul( const float *arrayA, const float *arrayB, float *result, size_t length )										\
+{																																\
+	size_t i = 0;																												\
+	for( ; i + WIDTH <= length; i += WIDTH )																					\
+		STORE( result + i, MUL( LOAD( arrayA + i ), LOAD( arrayB + i ) ) );														\
+	ZEROUPPER;																													\
+	for( ; i < length; i++ )																									\
+		result[i] = arrayA[i] * arrayB[i];																						\
+}																																\
+																																\
+TARGET void addMul( const float *arrayA, const float *arrayB, float scalar, float *result, size_t length )						\
+{																																\
+	VEC s = SET1( scalar );																										\
+	size_t i = 0;																												\
+	for( ; i + WIDTH <= length; i += WIDTH )																					\
+		STORE( result + i, MUL( ADD( LOAD( arrayA + i ), LOAD( arrayB + i ) ), s ) );											\
+	ZEROUPPER;																													\
+	for( ; i < length; i++ )																									\
+		result[i] = ( arrayA[i] + arrayB[i] ) * scalar;																			\
+}																																\
+																																\
+TARGET void int16ToFloat( const int16_t *array, float scale, float *result, size_t length )										\
+{																																\
+	VEC s = SET1( scale );																										\
+	size_t i = 0;																												\
+	for( ; i + WIDTH <= length; i += WIDTH )																					\
+		STORE( result + i, MUL( LOAD_INT16( array + i ), s ) );																	\
+	ZEROUPPER;																													\
+	for( ; i < length; i++ )																									\
+		result[i] = float( array[i] ) * scale;																					\
+}																																\
+																																\
+TARGET void int24ToFloat( const uint8_t *bytes, float scale, float *result, size_t length )										\
+{																																\
+	VEC s = SET1( scale );																										\
+	size_t i = 0;																												\
+	for( ; i + WIDTH + 2 <= length; i += WIDTH )																				\
+		STORE( result + i, MUL( LOAD_INT24( bytes + i * 3 ), s ) );																\
+	ZEROUPPER;																													\
+	for( ; i < length; i++ )																									\
+		result[i] = float( scalar::int24ToInt32( bytes + i * 3 ) ) * scale;														\
+}																																\
+																																\
+																																\
+const SimdKernels sKernels = { #ISA, fill, sum, sumSquares, max, addScalar, add, sub, mulScalar, mul, addMul, int16ToFloat, int24ToFloat };	\
+																																\
+}
+
+#if defined( CINDER_AUDIO_SIMD_X86 )
+
+namespace {
+
+CINDER_AUDIO_TARGET( "sse2" ) inline float hsumSse2( __m128 v )
+{
+	__m128 shuffled = _mm_shuffle_ps( v, v, _MM_SHUFFLE( 2, 3, 0, 1 ) );
+	__m128 sums = _mm_add_ps( v, shuffled );
+	shuffled = _mm_movehl_ps( shuffled, sums );
+	return _mm_cvtss_f32( _mm_add_ss( sums, shuffled ) );
+}
+
+CINDER_AUDIO_TARGET( "sse2" ) inline float hmaxSse2( __m128 v )
+{
+	__m128 shuffled = _mm_shuffle_ps( v, v, _MM_SHUFFLE( 2, 3, 0, 1 ) );
+	__m128 maxes = _mm_max_ps( v, shuffled );
+	shuffled = _mm_movehl_ps( shuffled, maxes );
+	return _mm_cvtss_f32( _mm_max_ss( maxes, shuffled ) );
+}
+
+// SSE2 can't sign-extend 16-bit integers directly, so each is unpacked into the top of an int32 and shifted back down.
+CINDER_AUDIO_TARGET( "sse2" ) inline __m128i loadInt16AsInt32Sse2( const int16_t *array )
+{
+	__m128i samples = _mm_loadl_epi64( reinterpret_cast<const __m128i *>( array ) );
+	return _mm_srai_epi32( _mm_unpacklo_epi16( samples, samples ), 16 );
+}
+
+CINDER_AUDIO_TARGET( "sse2" ) inline __m128 loadInt16Sse2( const int16_t *array )
+{
+	return _mm_cvtepi32_ps( loadInt16AsInt32Sse2( array ) );
+}
+
+// without a byte shuffle, each sample is loaded along with the following byte, which the shifts then discard.
+CINDER_AUDIO_TARGET( "sse2" ) inline __m128 loadInt24Sse2( const uint8_t *bytes )
+{
+	__m128i samples = _mm_set_epi32( loadInt32( bytes + 9 ), loadInt32( bytes + 6 ), loadInt32( bytes + 3 ), loadInt32( bytes ) );
+	return _mm_cvtepi32_ps( _mm_srai_epi32( _mm_slli_epi32( samples, 8 ), 8 ) );
+}
+
+} // anonymous namespace
+
+CINDER_AUDIO_SIMD_KERNELS( sse2, CINDER_AUDIO_TARGET( "sse2" ), __m128, 4, _mm_loadu_ps, _mm_storeu_ps, _mm_set1_ps, _mm_add_ps, _mm_sub_ps, _mm_mul_ps, _mm_max_ps, hsumSse2, hmaxSse2, (void)0, loadInt16Sse2, loadInt24Sse2 )
+
+#if defined( CINDER_AUDIO_SIMD_AVX )
+
+namespace {
+
+CINDER_AUDIO_TARGET( "avx" ) inline float hsumAvx( __m256 v )
+{
+	return hsumSse2( _mm_add_ps( _mm256_castps256_ps128( v ), _mm256_extractf128_ps( v, 1 ) ) );
+}
+
+CINDER_AUDIO_TARGET( "avx" ) inline float hmaxAvx( __m256 v )
+{
+	return hmaxSse2( _mm_max_ps( _mm256_castps256_ps128( v ), _mm256_extractf128_ps( v, 1 ) ) );
+}
+
+// AVX has no 256-bit integer instructions, so the samples are widened to int32 in two 128-bit halves and converted together.
+CINDER_AUDIO_TARGET( "avx" ) inline __m256 loadInt16Avx( const int16_t *array )
+{
+	__m256i samples = _mm256_castsi128_si256( loadInt16AsInt32Sse2( array ) );
+	return _mm256_cvtepi32_ps( _mm256_insertf128_si256( samples, loadInt16AsInt32Sse2( array + 4 ), 1 ) );
+}
+
+// shuffles the 4 samples in the first 12 of 16 bytes into the top of each int32, then shifts them down to extend the sign.
+CINDER_AUDIO_TARGET( "avx" ) inline __m128i loadInt24AsInt32Ssse3( const uint8_t *bytes )
+{
+	const __m128i shuffle = _mm_setr_epi8( -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11 );
+	__m128i samples = _mm_shuffle_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i *>( bytes ) ), shuffle );
+	return _mm_srai_epi32( samples, 8 );
+}
+
+CINDER_AUDIO_TARGET( "avx" ) inline __m256 loadInt24Avx( const uint8_t *bytes )
+{
+	__m256i samples = _mm256_castsi128_si256( loadInt24AsInt32Ssse3( bytes ) );
+	return _mm256_cvtepi32_ps( _mm256_insertf128_si256( samples, loadInt24AsInt32Ssse3( bytes + 12 ), 1 ) );
+}
+
+} // anonymous namespace
+
+CINDER_AUDIO_SIMD_KERNELS( avx, CINDER_AUDIO_TARGET( "avx" ), __m256, 8, _mm256_loadu_ps, _mm256_storeu_ps, _mm256_set1_ps, _mm256_add_ps, _mm256_sub_ps, _mm256_mul_ps, _mm256_max_ps, hsumAvx, hmaxAvx, _mm256_zeroupper(), loadInt16Avx, loadInt24Avx )
+
+#endif // defined( CINDER_AUDIO_SIMD_AVX )
+
+#if defined( CINDER_AUDIO_SIMD_AVX512 )
+
+namespace {
+
+// GCC 12's unmasked AVX-512 intrinsics (including the casts down to 128 and 256 bits) pass an _mm*_undefined_*() value through,
+// which -Wuninitialized reports wherever they are inlined. The zero-masked forms with a full mask compile to the same instructions.
+const __mmask16 kAvx512AllLanes = 0xFFFF;
+
+CINDER_AUDIO_TARGET( "avx512f" ) inline __m512 maxAvx512( __m512 a, __m512 b )
+{
+	return _mm512_maskz_max_ps( kAvx512AllLanes, a, b );
+}
+
+// only AVX-512F is assumed, so the vector is reduced in 128-bit quarters rather than halves, which need the DQ extension's _mm512_extractf32x8_ps.
+CINDER_AUDIO_TARGET( "avx512f" ) inline float hsumAvx512( __m512 v )
+{
+	__m128 low = _mm_add_ps( _mm512_maskz_extractf32x4_ps( 0xF, v, 0 ), _mm512_maskz_extractf32x4_ps( 0xF, v, 1 ) );
+	__m128 high = _mm_add_ps( _mm512_maskz_extractf32x4_ps( 0xF, v, 2 ), _mm512_maskz_extractf32x4_ps( 0xF, v, 3 ) );
+	return hsumSse2( _mm_add_ps( low, high ) );
+}
+
+CINDER_AUDIO_TARGET( "avx512f" ) inline float hmaxAvx512( __m512 v )
+{
+	__m128 low = _mm_max_ps( _mm512_maskz_extractf32x4_ps( 0xF, v, 0 ), _mm512_maskz_extractf32x4_ps( 0xF, v, 1 ) );
+	__m128 high = _mm_max_ps( _mm512_maskz_extractf32x4_ps( 0xF, v, 2 ), _mm512_maskz_extractf32x4_ps( 0xF, v, 3 ) );
+	return hmaxSse2( _mm_max_ps( low, high ) );
+}
+
+CINDER_AUDIO_TARGET( "avx512f" ) inline __m512 loadInt16Avx512( const int16_t *array )
+{
+	__m512i samples = _mm512_maskz_cvtepi16_epi32( kAvx512AllLanes, _mm256_loadu_si256( reinterpret_cast<const __m256i *>( array ) ) );
+	return _mm512_maskz_cvtepi32_ps( kAvx512AllLanes, samples );
+}
+
+CINDER_AUDIO_TARGET( "avx512f" ) inline __m512 loadInt24Avx512( const uint8_t *bytes )
+{
+	__m512i samples = _mm512_castsi128_si512( loadInt24AsInt32Ssse3( bytes ) );
+	samples = _mm512_inserti32x4( samples, loadInt24AsInt32Ssse3( bytes + 12 ), 1 );
+	samples = _mm512_inserti32x4( samples, loadInt24AsInt32Ssse3( bytes + 24 ), 2 );
+	samples = _mm512_inserti32x4( samples, loadInt24AsInt32Ssse3( bytes + 36 ), 3 );
+	return _mm512_maskz_cvtepi32_ps( kAvx512AllLanes, samples );
+}
+
+} // anonymous namespace
+
+CINDER_AUDIO_SIMD_KERNELS( avx512, CINDER_AUDIO_TARGET( "avx512f" ), __m512, 16, _mm512_loadu_ps, _mm512_storeu_ps, _mm512_set1_ps, _mm512_add_ps, _mm512_sub_ps, _mm512_mul_ps, maxAvx512, hsumAvx512, hmaxAvx512, _mm256_zeroupper(), loadInt16Avx512, loadInt24Avx512 )
+
+#endif // defined( CINDER_AUDIO_SIMD_AVX512 )
+
+#elif defined( CINDER_AUDIO_SIMD_NEON )
+
+namespace {
+
+// vaddvq_f32 and vmaxvq_f32 are AArch64 only, pairwise operations also work on ARMv7.
+inline float hsumNeon( float32x4_t v )
+{
+	float32x2_t sums = vadd_f32( vget_low_f32( v ), vget_high_f32( v ) );
+	return vget_lane_f32( vpadd_f32( sums, sums ), 0 );
+}
+
+inline float hmaxNeon( float32x4_t v )
+{
+	float32x2_t maxes = vmax_f32( vget_low_f32( v ), vget_high_f32( v ) );
+	return vget_lane_f32( vpmax_f32( maxes, maxes ), 0 );
+}
+
+inline float32x4_t loadInt16Neon( const int16_t *array )
+{
+	return vcvtq_f32_s32( vmovl_s16( vld1_s16( array ) ) );
+}
+
+// as with SSE2, each sample is loaded along with the following byte, which the shifts then discard.
+inline float32x4_t loadInt24Neon( const uint8_t *bytes )
+{
+	const int32_t samples[4] = { loadInt32( bytes ), loadInt32( bytes + 3 ), loadInt32( bytes + 6 ), loadInt32( bytes + 9 ) };
+	return vcvtq_f32_s32( vshrq_n_s32( vshlq_n_s32( vld1q_s32( samples ), 8 ), 8 ) );
+}
+
+} // anonymous namespace
+
+CINDER_AUDIO_SIMD_KERNELS( neon, , float32x4_t, 4, vld1q_f32, vst1q_f32, vdupq_n_f32, vaddq_f32, vsubq_f32, vmulq_f32, vmaxq_f32, hsumNeon, hmaxNeon, (void)0, loadInt16Neon, loadInt24Neon )
+
+#endif // defined( CINDER_AUDIO_SIMD_NEON )
+
+#undef CINDER_AUDIO_SIMD_KERNELS
+
+// MARK: - CPU detection and dispatch
+
+namespace {
+
+#if defined( CINDER_AUDIO_SIMD_X86 )
+
+struct CpuFeatures {
+	bool mSse2, mAvx, mAvx512;
+};
+
+void cpuid( int leaf, int subleaf, unsigned int regs[4] )
+{
+#if defined( _MSC_VER )
+	int info[4];
+	__cpuidex( info, leaf, subleaf );
+	for( int i = 0; i < 4; i++ )
+		regs[i] = static_cast<unsigned int>( info[i] );
+#else
+	__cpuid_count( leaf, subleaf, regs[0], regs[1], regs[2], regs[3] );
+#endif
+}
+
+// returns the register state that the OS saves on context switches, only valid if the CPU reports OSXSAVE.
+unsigned long long xgetbv()
+{
+#if defined( _MSC_VER ) && ( _MSC_VER >= 1600 )
+	return _xgetbv( 0 );
+#elif defined( _MSC_VER )
+	return 0;
+#else
+	unsigned int eax, edx;
+	__asm__ __volatile__( "xgetbv" : "=a"( eax ), "=d"( edx ) : "c"( 0 ) );
+	return ( static_cast<unsigned long long>( edx ) << 32 ) | eax;
+#endif
+}
+
+CpuFeatures detectCpuFeatures()
+{
+	CpuFeatures result = { false, false, false };
+
+	unsigned int regs[4];
+	cpuid( 0, 0, regs );
+	unsigned int maxLeaf = regs[0];
+	if( maxLeaf < 1 )
+		return result;
+
+	cpuid( 1, 0, regs );
+	result.mSse2 = ( regs[3] & ( 1u << 26 ) ) != 0;
+
+	bool osxsave = ( regs[2] & ( 1u << 27 ) ) != 0;
+	bool avx = ( regs[2] & ( 1u << 28 ) ) != 0;
+	if( ! osxsave || ! avx )
+		return result;
+
+	// the OS must save the ymm registers for AVX and additionally the opmask and zmm registers for AVX-512.
+	unsigned long long xcr0 = xgetbv();
+	bool osYmm = ( xcr0 & 0x06 ) == 0x06;
+	bool osZmm = ( xcr0 & 0xe6 ) == 0xe6;
+
+	result.mAvx = osYmm;
+	if( maxLeaf < 7 )
+		return result;
+
+	cpuid( 7, 0, regs );
+	result.mAvx512 = osZmm && ( regs[1] & ( 1u << 16 ) ) != 0;
+
+	return result;
+}
+
+#endif // defined( CINDER_AUDIO_SIMD_X86 )
+
+const size_t MAX_SUPPORTED_KERNELS = 4;
+
+// fills \a result with the supported kernels, narrowest first, and returns how many there are. Doesn't allocate.
+size_t findSupportedKernels( const SimdKernels *result[MAX_SUPPORTED_KERNELS] )
+{
+	size_t count = 0;
+	result[count++] = &scalar::sKernels;
+
+#if defined( CINDER_AUDIO_SIMD_X86 )
+	CpuFeatures features = detectCpuFeatures();
+	if( features.mSse2 )
+		result[count++] = &sse2::sKernels;
+#if defined( CINDER_AUDIO_SIMD_AVX )
+	if( features.mAvx )
+		result[count++] = &avx::sKernels;
+#endif
+#if defined( CINDER_AUDIO_SIMD_AVX512 )
+	if( features.mAvx512 )
+		result[count++] = &avx512::sKernels;
+#endif
+#elif defined( CINDER_AUDIO_SIMD_NEON )
+	result[count++] = &neon::sKernels;
+#endif
+
+	return count;
+}
+
+const SimdKernels* findWidestKernels()
+{
+	const SimdKernels *supported[MAX_SUPPORTED_KERNELS];
+	return supported[findSupportedKernels( supported ) - 1];
+}
+
+// selected during static initialization, so that the audio thread never runs the CPU detection. It is only null if a dsp:: function
+// is called from another static initializer before this one has run.
+atomic<const SimdKernels *> sCurrentKernels( findWidestKernels() );
+
+} // anonymous namespace
+
+vector<const SimdKernels *> getSupportedSimdKernels()
+{
+	const SimdKernels *supported[MAX_SUPPORTED_KERNELS];
+	size_t count = findSupportedKernels( supported );
+
+	return vector<const SimdKernels *>( supported, supported + count );
+}
+
+const SimdKernels& getSimdKernels()
+{
+	const SimdKernels *kernels = sCurrentKernels.load( memory_order_acquire );
+	if( ! kernels )
+		kernels = findWidestKernels();
+
+	return *kernels;
+}
+
+void setSimdKernels( const SimdKernels *kernels )
+{
+	sCurrentKernels.store( kernels ? kernels : findWidestKernels(), memory_order_release );
+}
+
+} } } // namespace cinder::audio2::dsp
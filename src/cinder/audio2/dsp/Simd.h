@@ -0,0 +1,66 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cinder { namespace audio2 { namespace dsp {
+
+//! \brief Table of the vector kernels that back the dsp:: functions on platforms without vDSP.
+//!
+//! One table exists per instruction set that the library was compiled with (scalar, SSE2, AVX, AVX-512 or NEON). The widest one that
+//! the running CPU and OS support is selected while the library is statically initialized. All kernels accept unaligned
+//! pointers and any \a length, and \a result may alias an input array.
+struct SimdKernels {
+	//! Name of the instruction set, e.g. "avx".
+	const char *mName;
+
+	void	(*mFill)( float value, float *array, size_t length );
+	float	(*mSum)( const float *array, size_t length );
+	float	(*mSumSquares)( const float *array, size_t length );
+	//! Returns the largest element of \a array, or 0 if \a length is 0.
+	float	(*mMax)( const float *array, size_t length );
+	void	(*mAddScalar)( const float *array, float scalar, float *result, size_t length );
+	void	(*mAdd)( const float *arrayA, const float *arrayB, float *result, size_t length );
+	void	(*mSub)( const float *arrayA, const float *arrayB, float *result, size_t length );
+	void	(*mMulScalar)( const float *array, float scalar, float *result, size_t length );
+	void	(*mMul)( const float *arrayA, const float *arrayB, float *result, size_t length );
+	//! result = ( arrayA + arrayB ) * scalar
+	void	(*mAddMul)( const float *arrayA, const float *arrayB, float scalar, float *result, size_t length );
+	//! result = array * scale, converting the 16-bit integers to float.
+	void	(*mInt16ToFloat)( const int16_t *array, float scale, float *result, size_t length );
+	//! result = array * scale, converting the packed, little-endian 24-bit integers in \a bytes (3 per sample) to float.
+	void	(*mInt24ToFloat)( const uint8_t *bytes, float scale, float *result, size_t length );
+};
+
+//! Returns the kernels used by the dsp:: functions, which are the widest supported instruction set's unless overridden with setSimdKernels().
+const SimdKernels& getSimdKernels();
+//! Returns all kernel tables that can run on this machine, ordered from narrowest to widest. The first is always the scalar reference.
+std::vector<const SimdKernels *> getSupportedSimdKernels();
+//! Overrides the kernels used by the dsp:: functions, which is useful for testing and benchmarking. Passing nullptr restores the automatic selection. \a kernels must be one of getSupportedSimdKernels().
+void setSimdKernels( const SimdKernels *kernels );
+
+} } } // namespace cinder::audio2::dsp
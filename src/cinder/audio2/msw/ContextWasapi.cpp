@@ -464,19 +464,13 @@ void LineOutWasapi::stop()
 
 void LineOutWasapi::renderInputs()
 {
+	// holding a reference keeps the Context alive while rendering
 	auto ctx = getContext();
 	if( ! ctx )
 		return;
 
-	lock_guard<mutex> lock( ctx->getMutex() );
-
-	// verify context still exists, since its destructor may have been holding the lock
-	ctx = getContext();
-	if( ! ctx )
-		return;
-
 	mInternalBuffer.zero();
-	pullInputs( &mInternalBuffer );
+	processGraph();
 
 	if( checkNotClipping() )
 		mInternalBuffer.zero();
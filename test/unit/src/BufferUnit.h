@@ -30,6 +30,133 @@ BOOST_AUTO_TEST_CASE( test_copy )
 	BOOST_CHECK( maxErr < ACCEPTABLE_FLOAT_ERROR );
 }
 
+BOOST_AUTO_TEST_CASE( test_view )
+{
+	BufferT<int> buffer( 8, 2 );
+	for( size_t i = 0; i < buffer.getSize(); i++ )
+		buffer[i] = int( i );
+
+	BufferViewT<int> view( &buffer, 2, 4 );
+	BOOST_CHECK( view.isView() );
+	BOOST_CHECK( ! view.isContiguous() );
+	BOOST_REQUIRE_EQUAL( view.getNumFrames(), 4 );
+	BOOST_REQUIRE_EQUAL( view.getNumChannels(), 2 );
+	BOOST_CHECK_EQUAL( view.getChannel( 0 )[0], 2 );
+	BOOST_CHECK_EQUAL( view.getChannel( 1 )[0], 10 );
+	BOOST_CHECK_EQUAL( view[5], 11 );
+
+	// writing through the view writes to the viewed buffer.
+	view.zero( 1, 2 );
+	BOOST_CHECK_EQUAL( buffer.getChannel( 0 )[2], 2 );
+	BOOST_CHECK_EQUAL( buffer.getChannel( 0 )[3], 0 );
+	BOOST_CHECK_EQUAL( buffer.getChannel( 1 )[4], 0 );
+	BOOST_CHECK_EQUAL( buffer.getChannel( 1 )[5], 13 );
+
+	// views of views and copies of views refer to the same storage.
+	BufferViewT<int> subView( &view, 3 );
+	BufferViewT<int> viewCopy = subView;
+	BOOST_REQUIRE_EQUAL( viewCopy.getNumFrames(), 1 );
+	BOOST_CHECK_EQUAL( viewCopy.getChannel( 1 ), buffer.getChannel( 1 ) + 5 );
+
+	// copying a view to a buffer copies its channels to aligned storage of its own.
+	BufferT<int> copied( view );
+	BOOST_CHECK( ! copied.isView() );
+	BOOST_CHECK_EQUAL( copied.getChannelStride(), BufferT<int>::getChannelAlignment() );
+	BOOST_REQUIRE_EQUAL( copied.getSize(), 8 );
+	BOOST_CHECK_EQUAL( copied[4], 10 );
+
+	BufferT<int> moved( std::move( subView ) );
+	BOOST_CHECK( ! moved.isView() );
+	BOOST_CHECK_EQUAL( moved.getChannel( 1 )[0], 13 );
+	BOOST_CHECK_EQUAL( buffer.getChannel( 1 )[5], 13 );
+
+	view.zero();
+	for( size_t i = 0; i < 8; i++ ) {
+		bool inView = ( i % 8 ) >= 2 && ( i % 8 ) < 6;
+		BOOST_CHECK_EQUAL( buffer[i] == 0, inView || i == 0 );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( test_aligned_channels )
+{
+	const size_t alignment = MemoryPool::getAlignment();
+	const size_t frameAlignment = Buffer::getChannelAlignment();
+	BOOST_REQUIRE_EQUAL( frameAlignment * sizeof( float ), alignment );
+
+	// block sizes are usually a multiple of the alignment, so the channels don't need padding.
+	Buffer block( 512, 2 );
+	BOOST_CHECK( block.isContiguous() );
+	BOOST_CHECK_EQUAL( block.getChannelStride(), 512 );
+
+	// otherwise each channel is padded so that the next starts aligned.
+	BufferDynamic buffer( 100, 3 );
+	BOOST_CHECK( ! buffer.isContiguous() );
+	BOOST_CHECK_EQUAL( buffer.getChannelStride() % frameAlignment, 0 );
+	BOOST_CHECK( buffer.getChannelStride() >= 100 );
+	for( size_t ch = 0; ch < buffer.getNumChannels(); ch++ )
+		BOOST_CHECK_EQUAL( (size_t)buffer.getChannel( ch ) % alignment, 0 );
+
+	for( size_t i = 0; i < buffer.getSize(); i++ )
+		buffer[i] = float( i );
+
+	BOOST_CHECK_EQUAL( buffer.getChannel( 2 )[10], 210.0f );
+
+	buffer.setNumFrames( 1000 );
+	BOOST_CHECK_EQUAL( buffer.getAllocatedSize(), buffer.getChannelStride() * 3 );
+	for( size_t ch = 0; ch < buffer.getNumChannels(); ch++ )
+		BOOST_CHECK_EQUAL( (size_t)buffer.getChannel( ch ) % alignment, 0 );
+
+	// mono and interleaved buffers are always contiguous.
+	BOOST_CHECK( Buffer( 100 ).isContiguous() );
+	BufferInterleaved interleaved( 100, 2 );
+	BOOST_CHECK( interleaved.isContiguous() );
+	BOOST_CHECK_EQUAL( (size_t)interleaved.getData() % alignment, 0 );
+
+	BufferSpectral spectral( 36 );
+	BOOST_CHECK_EQUAL( spectral.getImag(), spectral.getChannel( 1 ) );
+	BOOST_CHECK_EQUAL( (size_t)spectral.getImag() % alignment, 0 );
+
+	AlignedArrayPtr array = makeAlignedArray<float>( 100 );
+	BOOST_CHECK_EQUAL( (size_t)array.get() % alignment, 0 );
+	BOOST_CHECK_EQUAL( array.get()[99], 0.0f );
+}
+
+BOOST_AUTO_TEST_CASE( test_convert_int )
+{
+	const float samples[] = { 0.0f, 0.5f, -0.5f, 1.0f / 3.0f, -1.0f, 1.0f, 2.0f, -2.0f };
+	const size_t numSamples = sizeof( samples ) / sizeof( float );
+
+	int16_t samples16[numSamples];
+	float converted16[numSamples];
+	dsp::convert( samples, samples16, numSamples );
+	dsp::convert( samples16, converted16, numSamples );
+
+	Int24 samples24[numSamples];
+	float converted24[numSamples];
+	dsp::convert( samples, samples24, numSamples );
+	dsp::convert( samples24, converted24, numSamples );
+
+	BOOST_CHECK_EQUAL( samples16[1], 16384 );
+	BOOST_CHECK_EQUAL( samples16[4], -32768 );
+	BOOST_CHECK_EQUAL( samples16[5], 32767 );
+	BOOST_CHECK_EQUAL( samples16[7], -32768 );
+
+	// within range, samples round trip to within half a step.
+	for( size_t i = 0; i < 5; i++ ) {
+		BOOST_CHECK_SMALL( converted16[i] - samples[i], 0.5f / 32768.0f );
+		BOOST_CHECK_SMALL( converted24[i] - samples[i], 0.5f / 8388608.0f );
+	}
+
+	// out of range samples are clipped.
+	BOOST_CHECK_EQUAL( converted24[5], 8388607.0f / 8388608.0f );
+	BOOST_CHECK_EQUAL( converted24[6], 8388607.0f / 8388608.0f );
+	BOOST_CHECK_EQUAL( converted24[7], -1.0f );
+
+	// integer Buffer's are padded like any other, so their channels are aligned.
+	BufferInt24 buffer24( 100, 2 );
+	BOOST_CHECK_EQUAL( (size_t)buffer24.getChannel( 1 ) % MemoryPool::getAlignment(), 0 );
+}
+
 BOOST_AUTO_TEST_CASE( test_interleave_out_of_place )
 {
 	BufferInterleavedT<int> interleaved( 4, 2 );
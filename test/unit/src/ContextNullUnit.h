@@ -0,0 +1,101 @@
+#pragma once
+
+#include "cinder/audio2/ContextNull.h"
+#include "cinder/audio2/DeviceManagerNull.h"
+#include "cinder/audio2/Gen.h"
+#include "cinder/audio2/NodeEffect.h"
+
+#include <chrono>
+#include <thread>
+
+BOOST_AUTO_TEST_SUITE( test_context_null )
+
+using namespace std;
+using namespace ci;
+using namespace ci::audio2;
+
+namespace {
+
+// runs ctx for \a duration and returns the number of frames that were processed per second.
+double measureFramesPerSecond( Context *ctx, chrono::milliseconds duration )
+{
+	uint64_t beginFrames = ctx->getNumProcessedFrames();
+	auto beginTime = chrono::steady_clock::now();
+
+	ctx->start();
+	this_thread::sleep_for( duration );
+	ctx->stop();
+
+	double seconds = chrono::duration<double>( chrono::steady_clock::now() - beginTime ).count();
+	return double( ctx->getNumProcessedFrames() - beginFrames ) / seconds;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE( test_render_paced_and_free_run )
+{
+	Context::setMaster( new ContextNull, new DeviceManagerNull );
+	Device::getDefaultOutput()->updateFormat( Device::Format().sampleRate( 44100 ).framesPerBlock( 256 ) );
+
+	auto ctx = Context::master();
+	auto gen = ctx->makeNode( new GenSine( 440, Node::Format().autoEnable() ) );
+	gen >> ctx->getOutput();
+
+	auto lineOut = dynamic_pointer_cast<LineOutNull>( ctx->getOutput() );
+	BOOST_REQUIRE( lineOut );
+
+	// paced in real-time, allowing for a couple blocks of scheduling jitter.
+	double pacedRate = measureFramesPerSecond( ctx, chrono::milliseconds( 300 ) );
+	BOOST_CHECK( pacedRate > 44100 * 0.5 );
+	BOOST_CHECK( pacedRate < 44100 * 1.5 );
+
+	// a single sine renders many times faster than real-time.
+	lineOut->enableFreeRun();
+	double freeRunRate = measureFramesPerSecond( ctx, chrono::milliseconds( 100 ) );
+	BOOST_CHECK( freeRunRate > 44100 * 10 );
+
+	ctx->disconnectAllNodes();
+	Context::setMaster( nullptr, nullptr );
+}
+
+BOOST_AUTO_TEST_CASE( test_independent_contexts )
+{
+	Context::setMaster( new ContextNull, new DeviceManagerNull );
+	Device::getDefaultOutput()->updateFormat( Device::Format().sampleRate( 44100 ).framesPerBlock( 256 ) );
+
+	auto workerPool = make_shared<WorkerPool>( 2 );
+
+	// each session has its own graph and render thread, sharing the worker pool.
+	vector<ContextNullRef> sessions;
+	for( size_t i = 0; i < 3; i++ ) {
+		auto ctx = ContextNull::create();
+		ctx->setWorkerPool( workerPool );
+		BOOST_CHECK( ctx->getWorkerPool() == workerPool );
+
+		auto mix = ctx->makeNode( new Gain( 0.1f ) );
+		for( size_t j = 0; j < 4; j++ )
+			ctx->makeNode( new GenSine( 220.0f * ( i + 1 ) + j, Node::Format().autoEnable() ) ) >> mix;
+
+		mix >> ctx->getOutput();
+		sessions.push_back( ctx );
+	}
+
+	for( auto &ctx : sessions )
+		ctx->start();
+
+	this_thread::sleep_for( chrono::milliseconds( 100 ) );
+
+	for( auto &ctx : sessions ) {
+		ctx->stop();
+		BOOST_CHECK( ctx->getNumProcessedFrames() > 0 );
+		BOOST_CHECK_EQUAL( ctx->getCpuBudgetReport().mNumBlocks, ctx->getNumProcessedFrames() / 256 );
+		ctx->disconnectAllNodes();
+	}
+
+	// the master Context is unaffected by the sessions.
+	BOOST_CHECK_EQUAL( Context::master()->getNumProcessedFrames(), 0 );
+
+	Context::setMaster( nullptr, nullptr );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,651 @@
+#pragma once
+
+#include "cinder/audio2/ContextOffline.h"
+#include "cinder/audio2/NodeInput.h"
+#include "cinder/audio2/NodeEffect.h"
+#include "cinder/audio2/Gen.h"
+#include "cinder/audio2/Filter.h"
+#include "cinder/audio2/dsp/Dsp.h"
+#include "cinder/audio2/Scope.h"
+#include "cinder/audio2/SamplePlayer.h"
+
+#include <atomic>
+#include <thread>
+
+BOOST_AUTO_TEST_SUITE( test_context_offline )
+
+using namespace std;
+using namespace ci;
+using namespace ci::audio2;
+
+namespace {
+
+// writes a running frame count to all channels, so that block boundaries can be verified.
+CallbackProcessorRef makeCounter( const ContextOfflineRef &ctx, size_t *counter )
+{
+	auto fn = [counter]( Buffer *buffer, size_t sampleRate ) {
+		for( size_t i = 0; i < buffer->getNumFrames(); i++ ) {
+			for( size_t ch = 0; ch < buffer->getNumChannels(); ch++ )
+				buffer->getChannel( ch )[i] = float( *counter ) / 10000.0f;
+
+			(*counter)++;
+		}
+	};
+
+	return ctx->makeNode( new CallbackProcessor( fn, Node::Format().autoEnable() ) );
+}
+
+CallbackProcessorRef makeConstant( const ContextOfflineRef &ctx, float value )
+{
+	auto fn = [value]( Buffer *buffer, size_t sampleRate ) {
+		fill( buffer->getData(), buffer->getData() + buffer->getSize(), value );
+	};
+
+	return ctx->makeNode( new CallbackProcessor( fn, Node::Format().autoEnable() ) );
+}
+
+// counts the blocks it processes, with a fixed tail.
+class TailCounter : public Node {
+  public:
+	TailCounter( size_t tailFrames ) : Node( Format().autoEnable() ), mTailFrames( tailFrames ), mNumProcessedBlocks( 0 )	{}
+
+	size_t getTailFrames() const override	{ return mTailFrames; }
+
+	size_t mTailFrames, mNumProcessedBlocks;
+
+  protected:
+	void process( Buffer *buffer ) override	{ mNumProcessedBlocks++; }
+};
+
+// a constant 1.0 source that counts the calls to stop().
+class StopCounter : public NodeInput {
+  public:
+	StopCounter() : NodeInput( Format() ), mNumStops( 0 )	{}
+
+	using NodeInput::stop;
+	void stop() override	{ mNumStops++; NodeInput::stop(); }
+
+	atomic<size_t> mNumStops;
+
+  protected:
+	void process( Buffer *buffer ) override	{ fill( buffer->getData(), buffer->getData() + buffer->getSize(), 1.0f ); }
+};
+
+// renders one block of \a ctx, which retires an object that records the thread it is destroyed on. As the object is retired while the block is
+// being processed, it can't be collected until the block is done, by which time the housekeeping thread holds the only reference to it.
+void renderRetiring( const ContextOfflineRef &ctx, atomic<bool> *destroyed, thread::id *destroyedThreadId )
+{
+	Context *context = ctx.get();
+	auto retiring = ctx->makeNode( new CallbackProcessor( [=]( Buffer *buffer, size_t sampleRate ) {
+		context->retire( shared_ptr<int>( new int( 0 ), [=]( int *object ) {
+			*destroyedThreadId = this_thread::get_id();
+			delete object;
+			*destroyed = true;
+		} ) );
+	}, Node::Format().autoEnable() ) );
+
+	retiring >> ctx->getOutput();
+	Buffer buffer( ctx->getFramesPerBlock(), ctx->getOutput()->getNumChannels() );
+	ctx->render( &buffer );
+	retiring->disconnectAll();
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE( test_render_buffer )
+{
+	auto ctx = ContextOffline::create( 44100, 64, 2 );
+	size_t counter = 0;
+	auto gen = makeCounter( ctx, &counter );
+	gen >> ctx->getOutput();
+
+	// not a multiple of the block size, so the last block is only partially copied
+	Buffer buffer( 1000, 2 );
+	ctx->render( &buffer );
+
+	BOOST_CHECK_EQUAL( ctx->getNumProcessedFrames(), 1024 );
+	BOOST_CHECK_EQUAL( counter, 1024 );
+
+	for( size_t ch = 0; ch < buffer.getNumChannels(); ch++ ) {
+		for( size_t i = 0; i < buffer.getNumFrames(); i++ )
+			BOOST_REQUIRE_EQUAL( buffer.getChannel( ch )[i], float( i ) / 10000.0f );
+	}
+
+	// rendering again continues where the last call left off
+	ctx->render( &buffer );
+	BOOST_CHECK_EQUAL( ctx->getNumProcessedFrames(), 2048 );
+	BOOST_CHECK_EQUAL( buffer[0], 1024.0f / 10000.0f );
+}
+
+BOOST_AUTO_TEST_CASE( test_render_summing )
+{
+	auto ctx = ContextOffline::create( 44100, 64, 1 );
+	size_t counter = 0;
+	auto gen = makeCounter( ctx, &counter );
+	auto gain1 = ctx->makeNode( new Gain( 2.0f ) );
+	auto gain2 = ctx->makeNode( new Gain( 3.0f ) );
+
+	// gen has two outputs and the output has two inputs, so both must sum. gen is only processed once per block.
+	gen >> gain1 >> ctx->getOutput();
+	gen >> gain2 >> ctx->getOutput();
+
+	Buffer buffer( 128, 1 );
+	ctx->render( &buffer );
+
+	BOOST_CHECK_EQUAL( counter, 128 );
+	for( size_t i = 0; i < buffer.getNumFrames(); i++ )
+		BOOST_REQUIRE_CLOSE( buffer[i], 5.0f * float( i ) / 10000.0f, 0.0001f );
+
+	// after disconnecting, only gain1's path remains
+	gain2->disconnect();
+	ctx->render( &buffer );
+
+	BOOST_CHECK_EQUAL( counter, 256 );
+	BOOST_CHECK_CLOSE( buffer[0], 2.0f * 128.0f / 10000.0f, 0.0001f );
+}
+
+BOOST_AUTO_TEST_CASE( test_render_parallel )
+{
+	// renders a graph with many independent branches plus one shared Node, returning the result.
+	auto renderVoices = []( bool parallel ) {
+		auto ctx = ContextOffline::create( 44100, 64, 2 );
+		ctx->enableParallelProcessing( parallel, 3 );
+
+		auto mix = ctx->makeNode( new Gain( 0.1f ) );
+		for( size_t i = 0; i < 32; i++ ) {
+			auto gen = ctx->makeNode( new GenTriangle( 100.0f + i * 10.0f, Node::Format().autoEnable() ) );
+			auto gain = ctx->makeNode( new Gain( 1.0f / ( i + 1 ) ) );
+			gen >> gain >> mix;
+		}
+
+		auto shared = ctx->makeNode( new GenSine( 220.0f, Node::Format().autoEnable() ) );
+		shared >> mix;
+		shared >> ctx->makeNode( new Gain( 0.5f ) ) >> mix;
+
+		mix >> ctx->getOutput();
+
+		Buffer buffer( 1000, 2 );
+		ctx->render( &buffer );
+		return buffer;
+	};
+
+	Buffer serial = renderVoices( false );
+	Buffer parallel = renderVoices( true );
+
+	BOOST_CHECK( dsp::rms( serial.getData(), serial.getSize() ) > 0.01f );
+	for( size_t i = 0; i < serial.getSize(); i++ )
+		BOOST_REQUIRE_EQUAL( serial[i], parallel[i] );
+}
+
+BOOST_AUTO_TEST_CASE( test_render_sessions_shared_pool )
+{
+	// renders one session's mix of independent branches, with a WorkerPool that may be shared with other sessions.
+	auto renderSession = []( size_t session, const WorkerPoolRef &workerPool ) {
+		auto ctx = ContextOffline::create( 44100, 64, 1 );
+		ctx->setWorkerPool( workerPool );
+
+		auto mix = ctx->makeNode( new Gain( 0.1f ) );
+		for( size_t i = 0; i < 8; i++ )
+			ctx->makeNode( new GenTriangle( 100.0f * ( session + 1 ) + i * 10.0f, Node::Format().autoEnable() ) ) >> mix;
+
+		mix >> ctx->getOutput();
+
+		Buffer buffer( 4096, 1 );
+		ctx->render( &buffer );
+		return buffer;
+	};
+
+	const size_t numSessions = 4;
+	auto workerPool = make_shared<WorkerPool>( 2 );
+
+	// each session renders on its own thread, all contending for the same pool.
+	vector<Buffer> buffers( numSessions );
+	vector<thread> threads;
+	for( size_t session = 0; session < numSessions; session++ ) {
+		threads.emplace_back( [&, session] {
+			buffers[session] = renderSession( session, workerPool );
+		} );
+	}
+	for( auto &t : threads )
+		t.join();
+
+	for( size_t session = 0; session < numSessions; session++ ) {
+		Buffer expected = renderSession( session, nullptr );
+		BOOST_CHECK( dsp::rms( expected.getData(), expected.getSize() ) > 0.01f );
+		for( size_t i = 0; i < expected.getSize(); i++ )
+			BOOST_REQUIRE_EQUAL( buffers[session][i], expected[i] );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( test_render_pooled_buffers )
+{
+	const bool parallelModes[] = { false, true };
+	for( bool parallel : parallelModes ) {
+		auto ctx = ContextOffline::create( 44100, 64, 2 );
+		ctx->enableParallelProcessing( parallel, 2 );
+
+		// each voice sums two inputs, so it needs its own buffers without pooling. No two voices are live at the same time.
+		auto mix = ctx->makeNode( new Gain( 1.0f ) );
+		for( size_t i = 0; i < 16; i++ ) {
+			auto voice = ctx->makeNode( new Gain( 0.5f ) );
+			makeConstant( ctx, float( i + 1 ) ) >> voice;
+			makeConstant( ctx, 2.0f ) >> voice;
+			voice >> mix;
+		}
+
+		// a Node with two outputs is read after other inputs have been summed, so its buffer must stay live.
+		auto shared = makeConstant( ctx, 1.0f );
+		shared >> mix;
+		shared >> ctx->makeNode( new Gain( 3.0f ) ) >> mix;
+
+		// the summed result is well above the clip threshold, which would otherwise silence the output.
+		ctx->getOutput()->enableClipDetection( false );
+		mix >> ctx->getOutput();
+
+		Buffer buffer( 128, 2 );
+		ctx->render( &buffer );
+
+		for( size_t i = 0; i < buffer.getSize(); i++ )
+			BOOST_REQUIRE_EQUAL( buffer[i], 88.0f );
+
+		// parallel branches are processed concurrently, so they can't share buffers with each other.
+		auto report = ctx->getMemoryReport();
+		BOOST_CHECK( report.mNumPooledBuffers > 0 );
+		if( ! parallel ) {
+			BOOST_CHECK( report.mNumRenderBuffers < report.mNumNodeBuffers / 2 );
+			BOOST_CHECK( report.mNumRenderBytes < report.mNumNodeBytes / 2 );
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( test_skip_silent_inputs )
+{
+	auto ctx = ContextOffline::create( 44100, 64, 1 );
+	auto source = makeConstant( ctx, 0.5f );
+	auto gain = ctx->makeNode( new Gain( 1.0f ) );
+	auto counter = ctx->makeNode( new TailCounter( 100 ) );
+	source >> gain >> counter >> ctx->getOutput();
+
+	Buffer buffer( 64 * 4, 1 );
+	ctx->render( &buffer );
+	BOOST_CHECK_EQUAL( counter->mNumProcessedBlocks, 4 );
+
+	// a zero Gain flags its output as silent, so counter is only processed until its tail is covered, which takes two blocks.
+	gain->setValue( 0 );
+	ctx->render( &buffer );
+	BOOST_CHECK_EQUAL( counter->mNumProcessedBlocks, 6 );
+	BOOST_CHECK_EQUAL( dsp::rms( buffer.getData(), buffer.getSize() ), 0 );
+
+	gain->setValue( 1 );
+	ctx->render( &buffer );
+	BOOST_CHECK_EQUAL( counter->mNumProcessedBlocks, 10 );
+	BOOST_CHECK_EQUAL( buffer[0], 0.5f );
+
+	// a disabled source is silent as well, it is skipped while summing.
+	auto source2 = makeConstant( ctx, 0.25f );
+	source2 >> counter;
+	source->stop();
+	ctx->render( &buffer );
+	BOOST_CHECK_EQUAL( counter->mNumProcessedBlocks, 14 );
+	BOOST_CHECK_EQUAL( buffer[0], 0.25f );
+}
+
+BOOST_AUTO_TEST_CASE( test_edit_while_rendering )
+{
+	auto ctx = ContextOffline::create( 44100, 64, 1 );
+	auto gen = ctx->makeNode( new GenSine( 440.0f, Node::Format().autoEnable() ) );
+	auto gain = ctx->makeNode( new Gain( 0.5f ) );
+	gen >> gain >> ctx->getOutput();
+
+	Buffer buffer( 64, 1 );
+	ctx->render( &buffer );
+
+	// the render thread never waits on these edits, it picks up each published RenderGraph and Ramp list with its next block.
+	atomic<bool> done( false );
+	thread renderThread( [&] {
+		Buffer renderBuffer( 64, 1 );
+		while( ! done )
+			ctx->render( &renderBuffer );
+	} );
+
+	for( size_t i = 0; i < 500; i++ ) {
+		auto branch = ctx->makeNode( new Gain( 0.25f ) );
+		gen >> branch >> ctx->getOutput();
+
+		gain->setValue( float( i % 10 ) / 10.0f );
+		gain->getParam()->applyRamp( 1.0f, 0.01f );
+		gain->getParam()->appendRamp( 0.5f, 0.01f );
+
+		branch->disconnectAll();
+	}
+
+	done = true;
+	renderThread.join();
+
+	// with the render thread stopped, everything that was retired can be destroyed.
+	ctx->collectRetired();
+	BOOST_CHECK_EQUAL( ctx->getNumRetired(), 0 );
+
+	gain->setValue( 0.5f );
+	ctx->render( &buffer );
+	BOOST_CHECK_EQUAL( gain->getParam()->getNumRamps(), 0 );
+	BOOST_CHECK( dsp::rms( buffer.getData(), buffer.getSize() ) > 0.1f );
+}
+
+BOOST_AUTO_TEST_CASE( test_retired_destroyed_off_thread )
+{
+	auto ctx = ContextOffline::create( 44100, 64, 1 );
+
+	// retire() never destroys on the calling thread, the housekeeping thread picks the object up without collectRetired() being called.
+	atomic<bool> destroyed( false );
+	thread::id destroyedThreadId;
+	renderRetiring( ctx, &destroyed, &destroyedThreadId );
+
+	for( size_t i = 0; i < 500 && ! destroyed; i++ )
+		this_thread::sleep_for( chrono::milliseconds( 2 ) );
+
+	BOOST_REQUIRE( destroyed );
+	BOOST_CHECK( destroyedThreadId != this_thread::get_id() );
+	BOOST_CHECK_EQUAL( ctx->getNumRetired(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( test_housekeeping_thread_shared )
+{
+	// every Context is collected from by the same housekeeping thread, rather than each starting its own.
+	const size_t numContexts = 4;
+	vector<ContextOfflineRef> contexts;
+	atomic<bool> destroyed[numContexts];
+	thread::id destroyedThreadIds[numContexts];
+	for( size_t i = 0; i < numContexts; i++ ) {
+		destroyed[i] = false;
+		contexts.push_back( ContextOffline::create( 44100, 64, 1 ) );
+		renderRetiring( contexts.back(), &destroyed[i], &destroyedThreadIds[i] );
+	}
+
+	for( size_t i = 0; i < numContexts; i++ ) {
+		for( size_t j = 0; j < 500 && ! destroyed[i]; j++ )
+			this_thread::sleep_for( chrono::milliseconds( 2 ) );
+
+		BOOST_REQUIRE( destroyed[i] );
+	}
+
+	BOOST_CHECK( destroyedThreadIds[0] != this_thread::get_id() );
+	for( size_t i = 1; i < numContexts; i++ )
+		BOOST_CHECK( destroyedThreadIds[i] == destroyedThreadIds[0] );
+}
+
+BOOST_AUTO_TEST_CASE( test_scheduled_start_stop )
+{
+	auto ctx = ContextOffline::create( 1000, 64, 1 );
+
+	// a 1.0 constant source, started and stopped part way through blocks.
+	auto source = ctx->makeNode( new CallbackProcessor( []( Buffer *buffer, size_t sampleRate ) {
+		fill( buffer->getData(), buffer->getData() + buffer->getSize(), 1.0f );
+	} ) );
+	source >> ctx->getOutput();
+	source->start( 0.1 );
+	source->stop( 0.3 );
+
+	Buffer buffer( 64 * 6, 1 );
+	ctx->render( &buffer );
+
+	for( size_t i = 0; i < buffer.getNumFrames(); i++ )
+		BOOST_REQUIRE_EQUAL( buffer[i], ( i >= 100 && i < 300 ) ? 1.0f : 0.0f );
+
+	// the housekeeping thread disables the Node once the audio thread has reached its stop.
+	for( size_t i = 0; i < 500 && source->isEnabled(); i++ )
+		this_thread::sleep_for( chrono::milliseconds( 2 ) );
+
+	BOOST_CHECK( ! source->isEnabled() );
+
+	// an effect passes its input through outside of its scheduled range.
+	auto gain = ctx->makeNode( new Gain( 0.5f ) );
+	source->disconnectAll();
+	source >> gain >> ctx->getOutput();
+	source->start();
+	gain->stop();
+	gain->start( 0.4 );
+
+	ctx->render( &buffer );
+	for( size_t i = 0; i < buffer.getNumFrames(); i++ )
+		BOOST_REQUIRE_EQUAL( buffer[i], ( i + 384 >= 400 ) ? 0.5f : 1.0f );
+}
+
+BOOST_AUTO_TEST_CASE( test_scheduled_start_stop_order )
+{
+	// a stop before a pending start is discarded whichever of the two is scheduled first.
+	for( size_t stopFirst = 0; stopFirst < 2; stopFirst++ ) {
+		auto ctx = ContextOffline::create( 1000, 64, 1 );
+
+		auto source = ctx->makeNode( new CallbackProcessor( []( Buffer *buffer, size_t sampleRate ) {
+			fill( buffer->getData(), buffer->getData() + buffer->getSize(), 1.0f );
+		} ) );
+		source >> ctx->getOutput();
+		if( stopFirst ) {
+			source->stop( 0.1 );
+			source->start( 0.2 );
+		}
+		else {
+			source->start( 0.2 );
+			source->stop( 0.1 );
+		}
+
+		Buffer buffer( 64 * 6, 1 );
+		ctx->render( &buffer );
+
+		for( size_t i = 0; i < buffer.getNumFrames(); i++ )
+			BOOST_REQUIRE_EQUAL( buffer[i], i >= 200 ? 1.0f : 0.0f );
+
+		BOOST_CHECK( source->isEnabled() );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( test_scheduled_channel_change )
+{
+	auto ctx = ContextOffline::create( 1000, 64, 2 );
+
+	auto mono = ctx->makeNode( new CallbackProcessor( []( Buffer *buffer, size_t sampleRate ) {
+		fill( buffer->getData(), buffer->getData() + buffer->getSize(), 1.0f );
+	}, Node::Format().channels( 1 ).autoEnable() ) );
+	auto gain = ctx->makeNode( new Gain( 0.5f ) );
+	mono >> gain >> ctx->getOutput();
+	gain->start( 0.1 );
+
+	// a stereo input gives the Gain another channel after its scheduled buffer was allocated, it is resized before the audio thread uses it.
+	auto stereo = ctx->makeNode( new CallbackProcessor( []( Buffer *buffer, size_t sampleRate ) {
+		fill( buffer->getData(), buffer->getData() + buffer->getSize(), 1.0f );
+	}, Node::Format().channels( 2 ).autoEnable() ) );
+	mono->disconnectAll();
+	stereo >> gain;
+	BOOST_REQUIRE_EQUAL( gain->getNumChannels(), 2 );
+
+	Buffer buffer( 64 * 4, 2 );
+	ctx->render( &buffer );
+
+	for( size_t ch = 0; ch < 2; ch++ ) {
+		for( size_t i = 0; i < buffer.getNumFrames(); i++ )
+			BOOST_REQUIRE_EQUAL( buffer.getChannel( ch )[i], i >= 100 ? 0.5f : 1.0f );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( test_scheduled_stop_calls_stop )
+{
+	auto ctx = ContextOffline::create( 1000, 64, 1 );
+	auto source = ctx->makeNode( new StopCounter );
+	source >> ctx->getOutput();
+	source->start();
+	source->stop( 0.1 );
+
+	Buffer buffer( 64 * 4, 1 );
+	ctx->render( &buffer );
+
+	for( size_t i = 0; i < buffer.getNumFrames(); i++ )
+		BOOST_REQUIRE_EQUAL( buffer[i], i < 100 ? 1.0f : 0.0f );
+
+	// stop() is called on the housekeeping thread rather than the audio thread, so a subclass can stop its own processing.
+	for( size_t i = 0; i < 500 && ! source->mNumStops; i++ )
+		this_thread::sleep_for( chrono::milliseconds( 2 ) );
+
+	BOOST_CHECK_EQUAL( source->mNumStops, 1 );
+	BOOST_CHECK( ! source->isEnabled() );
+}
+
+BOOST_AUTO_TEST_CASE( test_scheduled_buffer_player )
+{
+	auto ctx = ContextOffline::create( 1000, 64, 1 );
+
+	BufferRef ramp = make_shared<Buffer>( 50, 1 );
+	for( size_t i = 0; i < ramp->getNumFrames(); i++ )
+		(*ramp)[i] = float( i + 1 ) / 100.0f;
+
+	auto player = ctx->makeNode( new BufferPlayer( ramp ) );
+	player >> ctx->getOutput();
+	player->start( 0.04 );
+
+	// the player begins reading at its first frame, exactly at the scheduled frame.
+	Buffer buffer( 128, 1 );
+	ctx->render( &buffer );
+
+	for( size_t i = 0; i < buffer.getNumFrames(); i++ ) {
+		float expected = ( i >= 40 && i < 90 ) ? float( i - 40 + 1 ) / 100.0f : 0.0f;
+		BOOST_REQUIRE_EQUAL( buffer[i], expected );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( test_buffer_player_sample_formats )
+{
+	BufferRef ramp = make_shared<Buffer>( 200, 2 );
+	for( size_t i = 0; i < ramp->getSize(); i++ )
+		(*ramp)[i] = float( i ) / 400.0f - 0.5f;
+
+	const SampleBuffer::Format formats[] = { SampleBuffer::FLOAT_32, SampleBuffer::INT_16, SampleBuffer::INT_24 };
+	const float maxErrors[] = { 0.0f, 0.5f / 32768.0f, 0.5f / 8388608.0f };
+
+	for( size_t f = 0; f < 3; f++ ) {
+		SampleBuffer sampleBuffer = SampleBuffer::create( ramp, formats[f] );
+		BOOST_REQUIRE_EQUAL( sampleBuffer.getFormat(), formats[f] );
+		BOOST_REQUIRE_EQUAL( sampleBuffer.getNumFrames(), 200 );
+		BOOST_REQUIRE_EQUAL( sampleBuffer.getNumChannels(), 2 );
+		BOOST_CHECK_EQUAL( sampleBuffer.getBuffer() == ramp, formats[f] == SampleBuffer::FLOAT_32 );
+
+		auto ctx = ContextOffline::create( 44100, 64, 2 );
+		auto player = ctx->makeNode( new BufferPlayer( sampleBuffer ) );
+		player >> ctx->getOutput();
+		player->start();
+
+		Buffer rendered( 256, 2 );
+		ctx->render( &rendered );
+
+		for( size_t ch = 0; ch < 2; ch++ ) {
+			for( size_t i = 0; i < 200; i++ )
+				BOOST_REQUIRE_SMALL( rendered.getChannel( ch )[i] - ramp->getChannel( ch )[i], maxErrors[f] + 1e-9f );
+
+			BOOST_CHECK_EQUAL( rendered.getChannel( ch )[200], 0.0f );
+		}
+	}
+
+	BOOST_CHECK_EQUAL( SampleBuffer::create( ramp, SampleBuffer::INT_16 ).getNumBytes(), 200 * 2 * 2 );
+	BOOST_CHECK_EQUAL( SampleBuffer::create( ramp, SampleBuffer::INT_24 ).getNumBytes(), 200 * 2 * 3 );
+
+	// BufferPlayer's can switch between formats.
+	auto ctx = ContextOffline::create( 44100, 64, 2 );
+	auto player = ctx->makeNode( new BufferPlayer( ramp ) );
+	player->setSampleBuffer( SampleBuffer::create( ramp, SampleBuffer::INT_16 ) );
+	BOOST_CHECK( ! player->getBuffer() );
+	BOOST_CHECK( player->getSampleBuffer().getBufferInt16() );
+	player->setBuffer( ramp );
+	BOOST_CHECK_EQUAL( player->getBuffer(), ramp );
+}
+
+BOOST_AUTO_TEST_CASE( test_render_auto_pulled )
+{
+	auto ctx = ContextOffline::create( 44100, 64, 1 );
+	size_t counter = 0;
+	auto gen = makeCounter( ctx, &counter );
+	auto scope = ctx->makeNode( new Scope( Scope::Format().windowSize( 128 ) ) );
+
+	// scope has no outputs, so it is pulled by the Context at the end of each block
+	gen >> scope;
+
+	Buffer buffer( 128, 1 );
+	ctx->render( &buffer );
+
+	BOOST_CHECK_EQUAL( counter, 128 );
+	BOOST_CHECK_EQUAL( scope->getBuffer()[127], 127.0f / 10000.0f );
+}
+
+BOOST_AUTO_TEST_CASE( test_render_channel_mismatch )
+{
+	auto ctx = ContextOffline::create( 44100, 64, 2 );
+
+	Buffer buffer( 64, 1 );
+	BOOST_CHECK_THROW( ctx->render( &buffer ), AudioFormatExc );
+	BOOST_CHECK_THROW( ctx->createLineOut( nullptr ), AudioContextExc );
+}
+
+BOOST_AUTO_TEST_CASE( test_batch_render )
+{
+	// variations of a filtered triangle wave.
+	auto makeGraphFn = []( size_t variation ) {
+		return [variation]( const ContextOfflineRef &ctx ) {
+			auto gen = ctx->makeNode( new GenTriangle( 110.0f + variation * 20.0f, Node::Format().autoEnable() ) );
+			auto filter = ctx->makeNode( new FilterLowPass );
+			filter->setCutoffFreq( 500.0f + variation * 100.0f );
+			gen >> filter >> ctx->makeNode( new Gain( 0.5f ) ) >> ctx->getOutput();
+		};
+	};
+
+	const size_t numJobs = 16;
+	BatchRender batch( make_shared<WorkerPool>( WorkerPool::Options().numThreads( 3 ).realtime( false ) ) );
+	for( size_t i = 0; i < numJobs; i++ )
+		BOOST_CHECK_EQUAL( batch.addJob( BatchRender::Job( makeGraphFn( i ), 22050 ).channels( 1 ).framesPerBlock( 256 ) ), i );
+
+	vector<size_t> progress;
+	batch.setProgressFn( [&]( size_t numCompleted, size_t numTotal ) {
+		BOOST_CHECK_EQUAL( numTotal, numJobs );
+		progress.push_back( numCompleted );
+	} );
+
+	batch.render();
+
+	BOOST_REQUIRE_EQUAL( progress.size(), numJobs );
+	for( size_t i = 0; i < numJobs; i++ )
+		BOOST_CHECK_EQUAL( progress[i], i + 1 );
+
+	// each job matches rendering its graph on its own.
+	for( size_t i = 0; i < numJobs; i++ ) {
+		auto ctx = ContextOffline::create( 44100, 256, 1 );
+		makeGraphFn( i )( ctx );
+		Buffer expected( 22050, 1 );
+		ctx->render( &expected );
+
+		BufferRef rendered = batch.getBuffer( i );
+		BOOST_REQUIRE( rendered );
+		BOOST_REQUIRE_EQUAL( rendered->getNumFrames(), 22050 );
+		BOOST_CHECK( dsp::rms( rendered->getData(), rendered->getSize() ) > 0.01f );
+		for( size_t j = 0; j < expected.getSize(); j++ )
+			BOOST_REQUIRE_EQUAL( ( *rendered )[j], expected[j] );
+	}
+
+	const BatchRenderStats &stats = batch.getStats();
+	BOOST_CHECK_EQUAL( stats.mNumJobs, numJobs );
+	BOOST_CHECK_EQUAL( stats.mNumFrames, numJobs * 22050 );
+	BOOST_CHECK_CLOSE( stats.mRenderedSeconds, numJobs * 0.5, 1e-6 );
+	BOOST_CHECK( stats.getRealtimeMultiple() > 1 );
+
+	// rendering again only renders jobs that were added since, and a job that throws doesn't stop the others.
+	batch.addJob( BatchRender::Job( []( const ContextOfflineRef &ctx ) { throw AudioContextExc( "bad graph" ); }, 100 ) );
+	batch.addJob( BatchRender::Job( makeGraphFn( 0 ), 100 ) );
+	progress.clear();
+	batch.setProgressFn( nullptr );
+
+	BOOST_CHECK_THROW( batch.render(), AudioContextExc );
+	BOOST_CHECK( ! batch.getBuffer( numJobs ) );
+	BOOST_CHECK( batch.getBuffer( numJobs + 1 ) );
+	BOOST_CHECK_EQUAL( batch.getStats().mNumJobs, numJobs + 1 );
+
+	// realtime pools, such as those used by Context's for parallel processing, are rejected.
+	BOOST_CHECK_THROW( BatchRender( make_shared<WorkerPool>( 1 ) ), AudioExc );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
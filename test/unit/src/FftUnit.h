@@ -48,4 +48,42 @@ BOOST_AUTO_TEST_CASE( test_round_trip )
 		computeRoundTrip( 2 << i );
 }
 
+BOOST_AUTO_TEST_CASE( test_windows )
+{
+	const size_t length = 16;
+	Buffer window( length );
+
+	// all windows are periodic, so they peak at length / 2 and are symmetric around it.
+	const dsp::WindowType types[] = { dsp::WindowType::BLACKMAN, dsp::WindowType::HAMM, dsp::WindowType::HANN, dsp::WindowType::RECT };
+	for( dsp::WindowType type : types ) {
+		dsp::generateWindow( type, window.getData(), length );
+		BOOST_CHECK_CLOSE( window[length / 2], 1.0f, 0.001f );
+		for( size_t i = 1; i < length / 2; i++ )
+			BOOST_CHECK_SMALL( window[i] - window[length - i], 0.00001f );
+	}
+
+	dsp::generateWindow( dsp::WindowType::HAMM, window.getData(), length );
+	BOOST_CHECK_CLOSE( window[0], 0.08f, 0.001f );
+
+	dsp::generateWindow( dsp::WindowType::HANN, window.getData(), length );
+	BOOST_CHECK_SMALL( window[0], 0.00001f );
+	BOOST_CHECK_CLOSE( window[length / 4], 0.5f, 0.001f );
+}
+
+BOOST_AUTO_TEST_CASE( test_window_cache )
+{
+	auto window = dsp::getWindow( dsp::WindowType::HAMM, 1024 );
+	BOOST_REQUIRE( window );
+	BOOST_CHECK_EQUAL( window->getNumFrames(), 1024 );
+
+	Buffer expected( 1024 );
+	dsp::generateWindow( dsp::WindowType::HAMM, expected.getData(), 1024 );
+	BOOST_CHECK_EQUAL( maxError( *window, expected ), 0 );
+
+	// the same type and size share one table, anything else gets its own.
+	BOOST_CHECK( dsp::getWindow( dsp::WindowType::HAMM, 1024 ) == window );
+	BOOST_CHECK( dsp::getWindow( dsp::WindowType::HAMM, 512 ) != window );
+	BOOST_CHECK( dsp::getWindow( dsp::WindowType::HANN, 1024 ) != window );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
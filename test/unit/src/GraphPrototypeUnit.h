@@ -0,0 +1,85 @@
+#pragma once
+
+#include "cinder/audio2/GraphPrototype.h"
+#include "cinder/audio2/ContextOffline.h"
+#include "cinder/audio2/NodeEffect.h"
+#include "cinder/audio2/Filter.h"
+#include "cinder/audio2/Gen.h"
+#include "cinder/audio2/dsp/Dsp.h"
+
+BOOST_AUTO_TEST_SUITE( test_graph_prototype )
+
+using namespace std;
+using namespace ci;
+using namespace ci::audio2;
+
+BOOST_AUTO_TEST_CASE( test_instantiate_matches_connect )
+{
+	const size_t numVoices = 20;
+
+	auto prototype = make_shared<GraphPrototype>();
+	size_t gen = prototype->addNode( [] { return new GenTriangle( 110.0f, Node::Format().autoEnable() ); } );
+	size_t filter = prototype->addNode( [] { return new FilterLowPass; } );
+	size_t gain = prototype->addNode( [] { return new Gain( 0.5f ); } );
+	prototype->connect( gen, filter );
+	prototype->connect( filter, gain );
+	BOOST_CHECK_EQUAL( prototype->getNumNodes(), 3 );
+	BOOST_CHECK( ! prototype->isResolved() );
+
+	auto protoCtx = ContextOffline::create( 44100, 64, 2 );
+	auto protoMixer = protoCtx->makeNode( new Gain( 0.1f ) );
+	protoMixer >> protoCtx->getOutput();
+
+	for( size_t i = 0; i < numVoices; i++ ) {
+		vector<NodeRef> nodes = prototype->instantiate( protoCtx, protoMixer );
+		BOOST_REQUIRE_EQUAL( nodes.size(), 3 );
+		BOOST_CHECK( prototype->isResolved() );
+
+		// each copy is independent.
+		dynamic_pointer_cast<GenTriangle>( nodes[gen] )->setFreq( 110.0f + i * 30.0f );
+		BOOST_CHECK( nodes[gen]->isInitialized() && nodes[gain]->isInitialized() );
+		BOOST_CHECK_EQUAL( nodes[gain]->getNumConnectedOutputs(), 1 );
+	}
+
+	BOOST_CHECK_EQUAL( protoMixer->getNumConnectedInputs(), numVoices );
+
+	// the same graph, built with connect().
+	auto ctx = ContextOffline::create( 44100, 64, 2 );
+	auto mixer = ctx->makeNode( new Gain( 0.1f ) );
+	mixer >> ctx->getOutput();
+	for( size_t i = 0; i < numVoices; i++ ) {
+		auto voiceGen = ctx->makeNode( new GenTriangle( 110.0f + i * 30.0f, Node::Format().autoEnable() ) );
+		voiceGen >> ctx->makeNode( new FilterLowPass ) >> ctx->makeNode( new Gain( 0.5f ) ) >> mixer;
+	}
+
+	Buffer expected( 2048, 2 ), rendered( 2048, 2 );
+	ctx->render( &expected );
+	protoCtx->render( &rendered );
+
+	BOOST_CHECK( dsp::rms( expected.getData(), expected.getSize() ) > 0.01f );
+	for( size_t i = 0; i < expected.getSize(); i++ )
+		BOOST_REQUIRE_EQUAL( rendered[i], expected[i] );
+}
+
+BOOST_AUTO_TEST_CASE( test_deferred_render_graph_updates )
+{
+	auto ctx = ContextOffline::create( 44100, 64, 1 );
+	auto constant = ctx->makeNode( new CallbackProcessor( []( Buffer *buffer, size_t sampleRate ) {
+		fill( buffer->getData(), buffer->getData() + buffer->getSize(), 0.5f );
+	}, Node::Format().autoEnable() ) );
+
+	Buffer buffer( 64, 1 );
+	{
+		ScopedDeferredRenderGraphUpdates deferredUpdates( ctx.get() );
+		constant >> ctx->getOutput();
+
+		// the connection isn't published until updates resume.
+		ctx->render( &buffer );
+		BOOST_CHECK_EQUAL( buffer[0], 0.0f );
+	}
+
+	ctx->render( &buffer );
+	BOOST_CHECK_EQUAL( buffer[0], 0.5f );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
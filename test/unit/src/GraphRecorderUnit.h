@@ -0,0 +1,192 @@
+#pragma once
+
+#include "cinder/audio2/GraphRecorder.h"
+#include "cinder/audio2/ContextOffline.h"
+#include "cinder/audio2/NodeEffect.h"
+#include "cinder/audio2/Gen.h"
+#include "cinder/audio2/dsp/Dsp.h"
+
+BOOST_AUTO_TEST_SUITE( test_graph_recorder )
+
+using namespace std;
+using namespace ci;
+using namespace ci::audio2;
+
+namespace {
+
+void setNodeFns( GraphReplayer *replayer )
+{
+	replayer->setNodeType<Gain>();
+	replayer->setNodeFn( demangledTypeName( typeid( GenSine ).name() ), [] { return new GenSine( Node::Format().autoEnable() ); } );
+	replayer->setNodeFn( demangledTypeName( typeid( GenTriangle ).name() ), [] { return new GenTriangle( 110.0f, Node::Format().autoEnable() ); } );
+}
+
+// renders \a numFrames more frames of \a ctx into \a result, which must be large enough to hold everything rendered.
+void renderAppend( const ContextOfflineRef &ctx, size_t numFrames, Buffer *result )
+{
+	Buffer rendered( numFrames, result->getNumChannels() );
+	ctx->render( &rendered );
+
+	result->copyOffset( rendered, numFrames, (size_t)ctx->getNumProcessedFrames() - numFrames, 0 );
+}
+
+struct StartCountingGain : public Gain {
+	StartCountingGain() : mNumStarts( 0 )	{}
+
+	void start() override	{ ++mNumStarts; Gain::start(); }
+
+	size_t mNumStarts;
+};
+
+// holds its Param in a heap allocated sub-object, rather than as a member.
+struct HeapParamGain : public Gain {
+	HeapParamGain() : mLevel( new Param( this, 1 ) )	{}
+
+	std::unique_ptr<Param> mLevel;
+};
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE( test_record_replay )
+{
+	auto ctx = ContextOffline::create( 44100, 64, 2 );
+	auto recorder = make_shared<GraphRecorder>();
+	ctx->setGraphRecorder( recorder );
+
+	Buffer expected( 3584, 2 );
+
+	auto gen = ctx->makeNode( new GenSine( Node::Format().autoEnable() ) );
+	auto gain = ctx->makeNode( new Gain( 1.0f ) );
+	gen->setFreq( 440.0f );
+	gen >> gain >> ctx->getOutput();
+	renderAppend( ctx, 1024, &expected );
+
+	gain->getParam()->applyRamp( 0.25f, 0.01f, Param::Options().rampFn( rampOutQuad ) );
+	renderAppend( ctx, 1024, &expected );
+
+	// disconnectAll() is recorded once, rather than along with the disconnects it makes.
+	gen->disconnectAll();
+	auto gen2 = ctx->makeNode( new GenTriangle( 110.0f, Node::Format().autoEnable() ) );
+	gen2 >> gain;
+	renderAppend( ctx, 1024, &expected );
+
+	gen2->setEnabled( false );
+	renderAppend( ctx, 512, &expected );
+
+	BOOST_CHECK_EQUAL( recorder->getNumEdits(), 7 );
+
+	ctx->setGraphRecorder( nullptr );
+	gen2->setEnabled( true );
+	BOOST_CHECK_EQUAL( recorder->getNumEdits(), 7 );
+
+	GraphReplayer replayer( recorder->getData() );
+	BOOST_CHECK_EQUAL( replayer.getNumEdits(), 7 );
+	BOOST_CHECK_EQUAL( replayer.getSampleRate(), 44100 );
+	BOOST_CHECK_EQUAL( replayer.getFramesPerBlock(), 64 );
+	BOOST_CHECK_EQUAL( replayer.getNumChannels(), 2 );
+	BOOST_CHECK_EQUAL( replayer.getNumFrames(), 3072 );
+
+	setNodeFns( &replayer );
+
+	BufferDynamic replayed;
+	auto replayCtx = replayer.createContext();
+	GraphReplayStats stats = replayer.replay( replayCtx, 512, &replayed );
+	BOOST_CHECK_EQUAL( stats.mNumEdits, 7 );
+	BOOST_CHECK_EQUAL( stats.mNumFrames, 3584 );
+	BOOST_CHECK_EQUAL( replayer.getNodes().size(), 4 );
+
+	BOOST_REQUIRE_EQUAL( replayed.getNumFrames(), expected.getNumFrames() );
+	BOOST_REQUIRE_EQUAL( replayed.getNumChannels(), expected.getNumChannels() );
+	BOOST_CHECK( dsp::rms( expected.getData(), expected.getSize() ) > 0.01f );
+	for( size_t i = 0; i < expected.getSize(); i++ )
+		BOOST_REQUIRE_EQUAL( replayed[i], expected[i] );
+}
+
+BOOST_AUTO_TEST_CASE( test_set_enabled_calls_overridden_start )
+{
+	auto ctx = ContextOffline::create( 44100, 64, 1 );
+	auto recorder = make_shared<GraphRecorder>();
+	ctx->setGraphRecorder( recorder );
+
+	auto gen = ctx->makeNode( new GenSine( Node::Format().autoEnable() ) );
+	auto gain = ctx->makeNode( new StartCountingGain );
+	gen >> gain >> ctx->getOutput();
+
+	Buffer rendered( 256, 1 );
+	ctx->render( &rendered );
+	gain->setEnabled( false );
+	ctx->render( &rendered );
+	gain->setEnabled( true );
+	ctx->render( &rendered );
+
+	BOOST_CHECK_EQUAL( gain->mNumStarts, 2 );
+	BOOST_CHECK_EQUAL( recorder->getNumEdits(), 4 );
+
+	StartCountingGain *replayedGain = nullptr;
+	GraphReplayer replayer( recorder->getData() );
+	setNodeFns( &replayer );
+	replayer.setNodeFn( demangledTypeName( typeid( StartCountingGain ).name() ), [&] { replayedGain = new StartCountingGain; return replayedGain; } );
+	replayer.replay( replayer.createContext(), 256 );
+
+	BOOST_REQUIRE( replayedGain );
+	BOOST_CHECK_EQUAL( replayedGain->mNumStarts, 2 );
+}
+
+BOOST_AUTO_TEST_CASE( test_param_index )
+{
+	auto ctx = ContextOffline::create( 44100, 64, 1 );
+	auto recorder = make_shared<GraphRecorder>();
+	ctx->setGraphRecorder( recorder );
+
+	auto gain = ctx->makeNode( new HeapParamGain );
+	gain >> ctx->getOutput();
+	gain->mLevel->setValue( 0.5f );
+
+	BOOST_REQUIRE_EQUAL( gain->getParams().size(), 2 );
+	BOOST_CHECK( gain->getParams()[1] == gain->mLevel.get() );
+
+	HeapParamGain *replayedGain = nullptr;
+	GraphReplayer replayer( recorder->getData() );
+	replayer.setNodeFn( demangledTypeName( typeid( HeapParamGain ).name() ), [&] { replayedGain = new HeapParamGain; return replayedGain; } );
+	replayer.replay( replayer.createContext() );
+
+	BOOST_REQUIRE( replayedGain );
+	BOOST_CHECK_EQUAL( replayedGain->mLevel->getValue(), 0.5f );
+	BOOST_CHECK_EQUAL( replayedGain->getParam()->getValue(), 1 );
+
+	// a Node of another type that doesn't have the Param can't be replayed.
+	replayer.setNodeFn( demangledTypeName( typeid( HeapParamGain ).name() ), [] { return new GenSine; } );
+	BOOST_CHECK_THROW( replayer.replay( replayer.createContext() ), AudioExc );
+}
+
+BOOST_AUTO_TEST_CASE( test_write_read )
+{
+	auto ctx = ContextOffline::create( 48000, 128, 1 );
+	auto recorder = make_shared<GraphRecorder>();
+	ctx->setGraphRecorder( recorder );
+
+	auto gen = ctx->makeNode( new GenSine( 220.0f, Node::Format().autoEnable() ) );
+	gen >> ctx->getOutput();
+	Buffer buffer( 256, 1 );
+	ctx->render( &buffer );
+	gen->stop( 0.01 );
+
+	fs::path path = fs::temp_directory_path() / "audio2_graph_recorder_unit.log";
+	recorder->write( path );
+
+	GraphReplayer replayer( path );
+	fs::remove( path );
+
+	BOOST_CHECK_EQUAL( replayer.getNumEdits(), 2 );
+	BOOST_CHECK_EQUAL( replayer.getSampleRate(), 48000 );
+	BOOST_CHECK_EQUAL( replayer.getNumFrames(), 256 );
+
+	// Node's without a NodeFn can't be replayed.
+	BOOST_CHECK_THROW( replayer.replay( replayer.createContext() ), AudioExc );
+
+	vector<uint8_t> truncated = recorder->getData();
+	truncated.pop_back();
+	BOOST_CHECK_THROW( GraphReplayer( truncated ).getNumEdits(), AudioExc );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "cinder/audio2/MemoryPool.h"
+#include "cinder/audio2/ContextOffline.h"
+#include "cinder/audio2/NodeEffect.h"
+#include "cinder/audio2/Gen.h"
+#include "cinder/audio2/dsp/Dsp.h"
+
+BOOST_AUTO_TEST_SUITE( test_memory_pool )
+
+using namespace std;
+using namespace ci;
+using namespace ci::audio2;
+
+BOOST_AUTO_TEST_CASE( test_allocate )
+{
+	MemoryPool *pool = new MemoryPool;
+
+	void *a = MemoryPool::allocate( pool, 100 );
+	void *b = MemoryPool::allocate( pool, 100 );
+	BOOST_CHECK( a != b );
+	BOOST_CHECK_EQUAL( (size_t)a % MemoryPool::getAlignment(), 0 );
+	BOOST_CHECK_EQUAL( (size_t)b % MemoryPool::getAlignment(), 0 );
+
+	// along with their headers, both fit in a 256 byte block, carved from one slab.
+	MemoryPool::Stats stats = pool->getStats();
+	BOOST_CHECK_EQUAL( stats.mNumAllocations, 2 );
+	BOOST_CHECK_EQUAL( stats.mNumAllocatedBytes, 512 );
+	BOOST_CHECK_EQUAL( stats.mNumSlabs, 1 );
+
+	// freed blocks are reused.
+	MemoryPool::deallocate( a );
+	void *c = MemoryPool::allocate( pool, 90 );
+	BOOST_CHECK_EQUAL( a, c );
+
+	// large allocations come from the heap.
+	void *large = MemoryPool::allocate( pool, 1024 * 1024 );
+	stats = pool->getStats();
+	BOOST_CHECK_EQUAL( stats.mNumAllocations, 3 );
+	BOOST_CHECK_EQUAL( stats.mNumSlabs, 1 );
+	BOOST_CHECK( stats.mNumAllocatedBytes > 1024 * 1024 );
+	BOOST_CHECK_EQUAL( (size_t)large % MemoryPool::getAlignment(), 0 );
+
+	MemoryPool::deallocate( large );
+	MemoryPool::deallocate( b );
+	MemoryPool::deallocate( c );
+	MemoryPool::deallocate( nullptr );
+
+	stats = pool->getStats();
+	BOOST_CHECK_EQUAL( stats.mNumAllocations, 0 );
+	BOOST_CHECK_EQUAL( stats.mNumAllocatedBytes, 0 );
+
+	// without a pool, memory comes from the heap.
+	void *heap = MemoryPool::allocate( nullptr, 100 );
+	BOOST_CHECK( heap );
+	BOOST_CHECK_EQUAL( (size_t)heap % MemoryPool::getAlignment(), 0 );
+	MemoryPool::deallocate( heap );
+
+	pool->release();
+}
+
+BOOST_AUTO_TEST_CASE( test_pooled_buffers )
+{
+	MemoryPool *pool = new MemoryPool;
+
+	BufferDynamic buffer( 512, 2, pool );
+	BOOST_CHECK_EQUAL( buffer.getMemoryPool(), pool );
+	BOOST_CHECK_EQUAL( pool->getStats().mNumAllocations, 1 );
+	BOOST_CHECK_EQUAL( dsp::rms( buffer.getData(), buffer.getSize() ), 0.0f );
+
+	for( size_t i = 0; i < buffer.getSize(); i++ )
+		buffer[i] = float( i );
+
+	// copies share the pool, moves take the storage.
+	Buffer copied = buffer;
+	BOOST_CHECK_EQUAL( copied.getMemoryPool(), pool );
+	BOOST_CHECK_EQUAL( pool->getStats().mNumAllocations, 2 );
+	BOOST_CHECK_EQUAL( copied[700], 700.0f );
+
+	Buffer moved = std::move( copied );
+	BOOST_CHECK_EQUAL( pool->getStats().mNumAllocations, 2 );
+	BOOST_CHECK_EQUAL( moved[700], 700.0f );
+	BOOST_CHECK( copied.isEmpty() );
+
+	// growing preserves the existing samples and zeroes the rest.
+	buffer.setNumChannels( 4 );
+	BOOST_CHECK_EQUAL( buffer[700], 700.0f );
+	BOOST_CHECK_EQUAL( buffer.getChannel( 3 )[10], 0.0f );
+
+	// moving to the heap and back preserves the samples.
+	buffer.setMemoryPool( nullptr );
+	BOOST_CHECK_EQUAL( pool->getStats().mNumAllocations, 1 );
+	BOOST_CHECK_EQUAL( buffer[700], 700.0f );
+
+	// the pool outlives its owner until its last block is freed.
+	pool->release();
+	moved = Buffer();
+	BOOST_CHECK_EQUAL( buffer[700], 700.0f );
+}
+
+BOOST_AUTO_TEST_CASE( test_pooled_nodes )
+{
+	auto ctx = ContextOffline::create( 44100, 64, 2 );
+	MemoryPool *pool = ctx->getMemoryPool();
+	BOOST_REQUIRE( pool );
+
+	size_t numAllocations = pool->getStats().mNumAllocations;
+
+	auto gen = ctx->makePooledNode<GenSine>( 440.0f, Node::Format().autoEnable() );
+	auto gain = ctx->makePooledNode<Gain>( 0.5f );
+	gen >> gain >> ctx->getOutput();
+
+	// each Node and its control block, along with their Buffer's and those of the RenderGraph.
+	BOOST_CHECK( pool->getStats().mNumAllocations >= numAllocations + 4 );
+
+	Buffer rendered( 1024, 2 );
+	ctx->render( &rendered );
+	BOOST_CHECK( dsp::rms( rendered.getData(), rendered.getSize() ) > 0.1f );
+
+	// pooled Node's can outlive their Context, along with its pool.
+	gen->disconnectAll();
+	ctx.reset();
+	BOOST_CHECK_EQUAL( gen->getFreq(), 440.0f );
+	BOOST_CHECK_EQUAL( gen->getNumChannels(), 1 );
+	gen.reset();
+	gain.reset();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
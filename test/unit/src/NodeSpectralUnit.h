@@ -0,0 +1,109 @@
+#pragma once
+
+#include "cinder/audio2/NodeSpectral.h"
+#include "cinder/audio2/ContextOffline.h"
+#include "cinder/audio2/NodeEffect.h"
+
+BOOST_AUTO_TEST_SUITE( test_node_spectral )
+
+using namespace std;
+using namespace ci;
+using namespace ci::audio2;
+
+namespace {
+
+// sum of sines that complete a whole number of periods per FFT frame of fftSize, at bins \a lowBin and \a highBin.
+float twoToneSample( size_t frame, size_t fftSize, size_t lowBin, size_t highBin )
+{
+	double phase = 2.0 * M_PI * (double)frame / (double)fftSize;
+	return float( 0.25 * sin( phase * lowBin ) + 0.25 * sin( phase * highBin ) );
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE( test_identity )
+{
+	const size_t fftSize = 512;
+
+	// a block size that doesn't divide the hop, so frames complete in the middle of a block.
+	auto ctx = ContextOffline::create( 44100, 100, 1 );
+	size_t frame = 0;
+	auto source = ctx->makeNode( new CallbackProcessor( [&]( Buffer *buffer, size_t sampleRate ) {
+		for( size_t i = 0; i < buffer->getNumFrames(); i++ )
+			buffer->getData()[i] = twoToneSample( frame++, fftSize, 3, 57 );
+	}, Node::Format().autoEnable() ) );
+
+	auto spectral = ctx->makeNode( new NodeSpectral( NodeSpectral::Format().fftSize( fftSize ).hopSize( 128 ) ) );
+	BOOST_CHECK_EQUAL( spectral->getHopSize(), 128 );
+	BOOST_CHECK_EQUAL( spectral->getLatencyFrames(), fftSize );
+
+	source >> spectral >> ctx->getOutput();
+
+	Buffer buffer( fftSize * 8, 1 );
+	ctx->render( &buffer );
+
+	// with no processors, the input is reconstructed after the latency.
+	const size_t latency = spectral->getLatencyFrames();
+	for( size_t i = 0; i < buffer.getNumFrames(); i++ ) {
+		float expected = i < latency ? 0.0f : twoToneSample( i - latency, fftSize, 3, 57 );
+		BOOST_REQUIRE_SMALL( buffer[i] - expected, 1e-4f );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( test_processor_chain )
+{
+	const size_t fftSize = 256;
+	const size_t cutoffBin = 16;
+
+	auto ctx = ContextOffline::create( 44100, 64, 2 );
+	size_t frame = 0;
+	auto source = ctx->makeNode( new CallbackProcessor( [&]( Buffer *buffer, size_t sampleRate ) {
+		for( size_t i = 0; i < buffer->getNumFrames(); i++ ) {
+			float sample = twoToneSample( frame++, fftSize, 4, 80 );
+			buffer->getChannel( 0 )[i] = buffer->getChannel( 1 )[i] = sample;
+		}
+	}, Node::Format().autoEnable().channels( 2 ) ) );
+
+	auto spectral = ctx->makeNode( new NodeSpectral( NodeSpectral::Format().fftSize( fftSize ).hopSize( 64 ) ) );
+
+	// the first processor counts the frames it sees, the second removes everything above cutoffBin.
+	size_t numProcessedFrames[2] = { 0, 0 };
+	auto counter = make_shared<SpectralCallbackProcessor>( [&]( BufferSpectral *spectral, size_t channel ) {
+		BOOST_REQUIRE( channel < 2 );
+		numProcessedFrames[channel]++;
+	} );
+	auto lowpass = make_shared<SpectralCallbackProcessor>( [&]( BufferSpectral *spectral, size_t channel ) {
+		fill( spectral->getReal() + cutoffBin, spectral->getReal() + spectral->getNumFrames(), 0.0f );
+		fill( spectral->getImag() + cutoffBin, spectral->getImag() + spectral->getNumFrames(), 0.0f );
+		spectral->getImag()[0] = 0; // nyquist
+	} );
+
+	spectral->addProcessor( counter );
+	spectral->addProcessor( lowpass );
+	BOOST_REQUIRE_EQUAL( spectral->getProcessors().size(), 2 );
+	BOOST_CHECK( spectral->getProcessors()[0] == counter );
+
+	source >> spectral >> ctx->getOutput();
+
+	Buffer buffer( fftSize * 8, 2 );
+	ctx->render( &buffer );
+
+	BOOST_CHECK_EQUAL( numProcessedFrames[0], buffer.getNumFrames() / spectral->getHopSize() );
+	BOOST_CHECK_EQUAL( numProcessedFrames[1], numProcessedFrames[0] );
+
+	// once the first whole frame has been output, only the low tone remains.
+	const size_t latency = spectral->getLatencyFrames();
+	for( size_t ch = 0; ch < 2; ch++ ) {
+		for( size_t i = latency + fftSize; i < buffer.getNumFrames(); i++ ) {
+			float expected = twoToneSample( i - latency, fftSize, 4, 0 );
+			BOOST_REQUIRE_SMALL( buffer.getChannel( ch )[i] - expected, 1e-3f );
+		}
+	}
+
+	spectral->removeProcessor( lowpass );
+	BOOST_CHECK_EQUAL( spectral->getProcessors().size(), 1 );
+	spectral->clearProcessors();
+	BOOST_CHECK( spectral->getProcessors().empty() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "cinder/audio2/NodeSubgraph.h"
+#include "cinder/audio2/ContextOffline.h"
+#include "cinder/audio2/NodeEffect.h"
+#include "cinder/audio2/Gen.h"
+#include "cinder/audio2/dsp/Dsp.h"
+
+BOOST_AUTO_TEST_SUITE( test_node_subgraph )
+
+using namespace std;
+using namespace ci;
+using namespace ci::audio2;
+
+BOOST_AUTO_TEST_CASE( test_larger_block_size )
+{
+	auto ctx = ContextOffline::create( 44100, 64, 1 );
+	auto source = ctx->makeNode( new CallbackProcessor( []( Buffer *buffer, size_t sampleRate ) {
+		fill( buffer->getData(), buffer->getData() + buffer->getSize(), 0.25f );
+	}, Node::Format().autoEnable() ) );
+
+	auto subgraph = ctx->makeNode( new NodeSubgraph( NodeSubgraph::Format().framesPerBlock( 256 ).channels( 1 ) ) );
+	auto subCtx = subgraph->getSubgraphContext();
+	BOOST_CHECK_EQUAL( subCtx->getFramesPerBlock(), 256 );
+
+	// records the block sizes the sub-graph is processed with.
+	size_t numSubgraphBlocks = 0;
+	auto counter = subCtx->makeNode( new CallbackProcessor( [&]( Buffer *buffer, size_t sampleRate ) {
+		BOOST_REQUIRE_EQUAL( buffer->getNumFrames(), 256 );
+		numSubgraphBlocks++;
+	}, Node::Format().autoEnable() ) );
+	counter >> subCtx->getOutput();
+	subgraph->getSubgraphInput() >> subCtx->makeNode( new Gain( 2.0f ) ) >> subCtx->getOutput();
+
+	source >> subgraph >> ctx->getOutput();
+
+	Buffer buffer( 64 * 16, 1 );
+	ctx->render( &buffer );
+
+	// the output is delayed until the first whole sub-graph block has been buffered.
+	BOOST_CHECK_EQUAL( subgraph->getLatencyFrames(), 192 );
+	BOOST_CHECK_EQUAL( numSubgraphBlocks, 4 );
+	for( size_t i = 0; i < buffer.getNumFrames(); i++ )
+		BOOST_REQUIRE_EQUAL( buffer[i], i < 192 ? 0.0f : 0.5f );
+}
+
+BOOST_AUTO_TEST_CASE( test_oversample )
+{
+	auto ctx = ContextOffline::create( 44100, 256, 1 );
+	auto sine = ctx->makeNode( new GenSine( 440, Node::Format().autoEnable() ) );
+
+	auto subgraph = ctx->makeNode( new NodeSubgraph( NodeSubgraph::Format().oversample( 2 ).channels( 1 ) ) );
+	auto subCtx = subgraph->getSubgraphContext();
+	BOOST_CHECK_EQUAL( subCtx->getSampleRate(), 88200 );
+	BOOST_CHECK_EQUAL( subCtx->getFramesPerBlock(), 512 );
+
+	subgraph->getSubgraphInput() >> subCtx->getOutput();
+	sine >> subgraph >> ctx->getOutput();
+
+	Buffer buffer( 44100, 1 );
+	ctx->render( &buffer );
+
+	// once the resamplers have filled, the sine passes through at the same level.
+	const size_t numTailFrames = 22050;
+	float rms = dsp::rms( buffer.getData() + buffer.getNumFrames() - numTailFrames, numTailFrames );
+	BOOST_CHECK_CLOSE( rms, 1.0f / sqrt( 2.0f ), 5.0f );
+}
+
+// NodeOutputOffline whose samplerate can be changed, like a device's.
+struct VariableRateOutput : public NodeOutputOffline {
+	VariableRateOutput( size_t sampleRate, size_t framesPerBlock )
+		: NodeOutputOffline( sampleRate, framesPerBlock, Node::Format().channels( 1 ) ), mRate( sampleRate )
+	{}
+
+	size_t getOutputSampleRate() override	{ return mRate; }
+
+	size_t mRate;
+};
+
+BOOST_AUTO_TEST_CASE( test_samplerate_change )
+{
+	auto ctx = ContextOffline::create( 44100, 256, 1 );
+	auto output = ctx->makeNode( new VariableRateOutput( 44100, 256 ) );
+	ctx->setOutput( output );
+
+	auto subgraph = ctx->makeNode( new NodeSubgraph( NodeSubgraph::Format().oversample( 2 ).channels( 1 ) ) );
+	auto subCtx = subgraph->getSubgraphContext();
+	subgraph->getSubgraphInput() >> subCtx->getOutput();
+	ctx->makeNode( new GenSine( 440, Node::Format().autoEnable() ) ) >> subgraph >> ctx->getOutput();
+
+	Buffer buffer( 1024, 1 );
+	ctx->render( &buffer );
+	BOOST_CHECK_EQUAL( subCtx->getSampleRate(), 88200 );
+
+	// the same sequence as a LineOut whose device's samplerate changes.
+	ctx->stop();
+	ctx->uninitializeAllNodes();
+	output->mRate = 48000;
+	ctx->initializeAllNodes();
+
+	BOOST_CHECK( subgraph->getSubgraphContext() != subCtx );
+	BOOST_CHECK_EQUAL( subgraph->getSubgraphContext()->getSampleRate(), 96000 );
+	ctx->render( &buffer );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
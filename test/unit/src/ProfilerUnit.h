@@ -0,0 +1,175 @@
+#pragma once
+
+#include "cinder/audio2/Profiler.h"
+#include "cinder/audio2/ContextOffline.h"
+#include "cinder/audio2/NodeEffect.h"
+#include "cinder/audio2/Gen.h"
+
+#include <atomic>
+#include <thread>
+
+BOOST_AUTO_TEST_SUITE( test_profiler )
+
+using namespace std;
+using namespace ci;
+using namespace ci::audio2;
+
+BOOST_AUTO_TEST_CASE( test_process_profile_stats )
+{
+	ProcessProfile profile;
+	BOOST_CHECK_EQUAL( profile.getStats().mNumCalls, 0 );
+
+	// 99 short calls and one long one.
+	for( size_t i = 0; i < 99; i++ )
+		profile.record( 1000 );
+	profile.record( 1000000 );
+
+	ProfileStats stats = profile.getStats();
+	BOOST_CHECK_EQUAL( stats.mNumCalls, 100 );
+	BOOST_CHECK_CLOSE( stats.mMinSeconds, 1e-6, 0.001 );
+	BOOST_CHECK_CLOSE( stats.mMaxSeconds, 1e-3, 0.001 );
+	BOOST_CHECK_CLOSE( stats.mMeanSeconds, ( 99 * 1e-6 + 1e-3 ) / 100, 0.001 );
+
+	// percentiles are bucket upper bounds, within a quarter octave above the recorded value.
+	BOOST_CHECK( stats.mMedianSeconds >= 1e-6 && stats.mMedianSeconds < 1e-6 * 1.2 );
+	BOOST_CHECK( stats.mPercentile99Seconds >= 1e-6 && stats.mPercentile99Seconds < 1e-6 * 1.2 );
+
+	profile.reset();
+	BOOST_CHECK_EQUAL( profile.getStats().mNumCalls, 0 );
+}
+
+BOOST_AUTO_TEST_CASE( test_context_profile_snapshot )
+{
+	auto ctx = ContextOffline::create( 44100, 64, 1 );
+	auto gen = ctx->makeNode( new GenSine( 440, Node::Format().autoEnable() ) );
+	auto gain = ctx->makeNode( new Gain( 0.5f ) );
+	gen >> gain >> ctx->getOutput();
+
+	Buffer buffer( 64 * 10, 1 );
+	ctx->render( &buffer );
+
+	ProfileSnapshot snapshot = ctx->getProfileSnapshot();
+
+	// render cycles are timed by the NodeOutput whether or not profiling is compiled in.
+	BOOST_CHECK_EQUAL( snapshot.mBlockStats.mNumCalls, 10 );
+	BOOST_CHECK_CLOSE( snapshot.mBlockDeadlineSeconds, 64.0 / 44100.0, 0.01 );
+
+#if defined( CINDER_AUDIO_PROFILING )
+	const ProfileStats *genStats = snapshot.findStats( gen.get() );
+	BOOST_REQUIRE( genStats );
+	BOOST_CHECK_EQUAL( genStats->mNumCalls, 10 );
+	BOOST_CHECK( genStats->mMaxSeconds >= genStats->mMinSeconds );
+
+	ctx->resetProfile();
+	BOOST_CHECK_EQUAL( ctx->getProfileSnapshot().findStats( gen.get() )->mNumCalls, 0 );
+#else
+	// without profiling compiled in, Node's are not timed.
+	BOOST_CHECK( snapshot.mNodeStats.empty() );
+
+	ctx->resetProfile();
+#endif
+
+	BOOST_CHECK_EQUAL( ctx->getProfileSnapshot().mBlockStats.mNumCalls, 0 );
+}
+
+BOOST_AUTO_TEST_CASE( test_snapshot_does_not_lock )
+{
+	auto ctx = ContextOffline::create( 44100, 64, 1 );
+	ctx->makeNode( new GenSine( 440, Node::Format().autoEnable() ) ) >> ctx->getOutput();
+
+	Buffer buffer( 64 * 4, 1 );
+	ctx->render( &buffer );
+
+	// polled from another thread while the Context's mutex is held, as a UI thread would while the graph is being edited.
+	atomic<bool> done( false );
+	size_t numBlocks = 0;
+
+	unique_lock<mutex> lock( ctx->getMutex() );
+	thread poller( [&] {
+		ctx->getProfileSnapshot();
+		ctx->resetProfile();
+		numBlocks = ctx->getCpuBudgetReport().mNumBlocks;
+		done = true;
+	} );
+
+	for( size_t i = 0; i < 200 && ! done; i++ )
+		this_thread::sleep_for( chrono::milliseconds( 10 ) );
+
+	BOOST_CHECK( done );
+
+	// if the poller did block, it finishes once the mutex is released.
+	lock.unlock();
+	poller.join();
+	BOOST_CHECK_EQUAL( numBlocks, 0 );
+}
+
+BOOST_AUTO_TEST_CASE( test_deadline_misses )
+{
+	auto ctx = ContextOffline::create( 44100, 64, 1 );
+	auto output = ctx->getOutput();
+
+	// the third block takes longer than the 1.45 ms it has to render in.
+	size_t numBlocks = 0;
+	auto fn = [&numBlocks]( Buffer *buffer, size_t sampleRate ) {
+		if( numBlocks++ == 2 )
+			this_thread::sleep_for( chrono::milliseconds( 5 ) );
+	};
+	ctx->makeNode( new CallbackProcessor( fn, Node::Format().autoEnable() ) ) >> output;
+
+	Buffer buffer( 64 * 4, 1 );
+	ctx->render( &buffer );
+
+	BOOST_CHECK_EQUAL( output->getNumDeadlineMisses(), 1 );
+	BOOST_CHECK_EQUAL( output->getLastDeadlineMiss(), 128 );
+	BOOST_CHECK_EQUAL( output->getLastDeadlineMiss(), 0 );
+
+	// the slow block lands in a histogram bucket above the deadline.
+	const ProcessProfile &profile = output->getRenderProfile();
+	uint64_t numAboveDeadline = 0;
+	for( size_t i = 0; i < ProcessProfile::getNumBuckets(); i++ ) {
+		if( ProcessProfile::getBucketUpperBound( i ) > output->getBlockDeadlineSeconds() * 2 )
+			numAboveDeadline += profile.getBucketCount( i );
+	}
+	BOOST_CHECK_EQUAL( numAboveDeadline, 1 );
+	BOOST_CHECK( output->getRenderStats().mMaxSeconds >= 0.005 );
+
+	output->resetRenderStats();
+	BOOST_CHECK_EQUAL( output->getNumDeadlineMisses(), 0 );
+	BOOST_CHECK_EQUAL( output->getRenderStats().mNumCalls, 0 );
+}
+
+BOOST_AUTO_TEST_CASE( test_cpu_budget_report )
+{
+	auto ctx = ContextOffline::create( 44100, 512, 1 );
+	auto output = ctx->getOutput();
+	output->setCpuBudget( 0.1 );
+
+	// the second block takes about a quarter of the 11.6 ms it has to render in, which is over budget but not a deadline miss.
+	size_t numBlocks = 0;
+	auto fn = [&numBlocks]( Buffer *buffer, size_t sampleRate ) {
+		if( numBlocks++ == 1 )
+			this_thread::sleep_for( chrono::milliseconds( 3 ) );
+	};
+	ctx->makeNode( new CallbackProcessor( fn, Node::Format().autoEnable() ) ) >> output;
+
+	Buffer buffer( 512 * 4, 1 );
+	ctx->render( &buffer );
+
+	CpuBudgetReport report = ctx->getCpuBudgetReport();
+	BOOST_CHECK_EQUAL( report.mBudget, 0.1 );
+	BOOST_CHECK_EQUAL( report.mNumBlocks, 4 );
+	BOOST_CHECK( report.mNumOverBudget >= 1 );
+	BOOST_CHECK_EQUAL( report.mNumOverBudget, output->getNumOverBudget() );
+	BOOST_CHECK( report.mMaxLoad > 0.2 );
+	BOOST_CHECK( report.mMeanLoad <= report.mMaxLoad );
+	BOOST_CHECK( ! report.isWithinBudget() );
+	BOOST_CHECK( report.getHeadroom() < 0 );
+
+	ctx->resetProfile();
+	report = ctx->getCpuBudgetReport();
+	BOOST_CHECK_EQUAL( report.mNumBlocks, 0 );
+	BOOST_CHECK_EQUAL( report.mNumOverBudget, 0 );
+	BOOST_CHECK( report.isWithinBudget() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "utils.h"
+#include "cinder/audio2/dsp/Simd.h"
+#include "cinder/audio2/dsp/Dsp.h"
+
+#include <chrono>
+#include <limits>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE( test_simd )
+
+using namespace std;
+using namespace ci;
+using namespace ci::audio2;
+
+namespace {
+
+void fillRandom( vector<float> *array )
+{
+	for( size_t i = 0; i < array->size(); i++ )
+		(*array)[i] = randFloat( -1.0f, 1.0f );
+}
+
+float maxError( const float *a, const float *b, size_t length )
+{
+	float error = 0;
+	for( size_t i = 0; i < length; i++ )
+		error = max( error, fabs( a[i] - b[i] ) );
+
+	return error;
+}
+
+// compares every kernel of \a kernels with the scalar reference. The arrays are offset by one float so the loads are unaligned.
+void checkKernels( const dsp::SimdKernels &kernels, size_t length )
+{
+	const dsp::SimdKernels &ref = *dsp::getSupportedSimdKernels().front();
+	const string message = string( kernels.mName ) + ", length: " + to_string( length );
+
+	vector<float> a( length + 1 ), b( length + 1 ), result( length + 1 ), expected( length + 1 );
+	fillRandom( &a );
+	fillRandom( &b );
+	const float *arrayA = a.data() + 1;
+	const float *arrayB = b.data() + 1;
+
+	kernels.mFill( 0.5f, result.data() + 1, length );
+	ref.mFill( 0.5f, expected.data() + 1, length );
+	BOOST_CHECK_MESSAGE( maxError( result.data(), expected.data(), length + 1 ) == 0, "fill " + message );
+
+	kernels.mAddScalar( arrayA, 0.25f, result.data() + 1, length );
+	ref.mAddScalar( arrayA, 0.25f, expected.data() + 1, length );
+	BOOST_CHECK_MESSAGE( maxError( result.data(), expected.data(), length + 1 ) < ACCEPTABLE_FLOAT_ERROR, "addScalar " + message );
+
+	kernels.mAdd( arrayA, arrayB, result.data() + 1, length );
+	ref.mAdd( arrayA, arrayB, expected.data() + 1, length );
+	BOOST_CHECK_MESSAGE( maxError( result.data(), expected.data(), length + 1 ) < ACCEPTABLE_FLOAT_ERROR, "add " + message );
+
+	kernels.mSub( arrayA, arrayB, result.data() + 1, length );
+	ref.mSub( arrayA, arrayB, expected.data() + 1, length );
+	BOOST_CHECK_MESSAGE( maxError( result.data(), expected.data(), length + 1 ) < ACCEPTABLE_FLOAT_ERROR, "sub " + message );
+
+	kernels.mMulScalar( arrayA, 0.75f, result.data() + 1, length );
+	ref.mMulScalar( arrayA, 0.75f, expected.data() + 1, length );
+	BOOST_CHECK_MESSAGE( maxError( result.data(), expected.data(), length + 1 ) < ACCEPTABLE_FLOAT_ERROR, "mulScalar " + message );
+
+	kernels.mMul( arrayA, arrayB, result.data() + 1, length );
+	ref.mMul( arrayA, arrayB, expected.data() + 1, length );
+	BOOST_CHECK_MESSAGE( maxError( result.data(), expected.data(), length + 1 ) < ACCEPTABLE_FLOAT_ERROR, "mul " + message );
+
+	kernels.mAddMul( arrayA, arrayB, 0.5f, result.data() + 1, length );
+	ref.mAddMul( arrayA, arrayB, 0.5f, expected.data() + 1, length );
+	BOOST_CHECK_MESSAGE( maxError( result.data(), expected.data(), length + 1 ) < ACCEPTABLE_FLOAT_ERROR, "addMul " + message );
+
+	// in-place, as Converter's sumBuffers() calls add and addMul.
+	copy( a.begin(), a.end(), result.begin() );
+	kernels.mAdd( result.data() + 1, arrayB, result.data() + 1, length );
+	ref.mAdd( arrayA, arrayB, expected.data() + 1, length );
+	BOOST_CHECK_MESSAGE( maxError( result.data() + 1, expected.data() + 1, length ) < ACCEPTABLE_FLOAT_ERROR, "in-place add " + message );
+
+	// the reductions are summed in a different order, so they can only be expected to match within a tolerance that grows with length.
+	const float reductionTolerance = ACCEPTABLE_FLOAT_ERROR * float( length + 1 );
+	BOOST_CHECK_MESSAGE( fabs( kernels.mSum( arrayA, length ) - ref.mSum( arrayA, length ) ) < reductionTolerance, "sum " + message );
+	BOOST_CHECK_MESSAGE( fabs( kernels.mSumSquares( arrayA, length ) - ref.mSumSquares( arrayA, length ) ) < reductionTolerance, "sumSquares " + message );
+	BOOST_CHECK_MESSAGE( kernels.mMax( arrayA, length ) == ref.mMax( arrayA, length ), "max " + message );
+
+	// random bits cover the full range of both integer formats, including the most negative values. The arrays end with the last
+	// sample, so that reading past it is caught by address sanitizers.
+	vector<int16_t> samples16( length + 1 );
+	for( size_t i = 0; i < samples16.size(); i++ )
+		samples16[i] = int16_t( randInt( 65536 ) - 32768 );
+
+	vector<uint8_t> bytes( length * 3 + 1 );
+	for( size_t i = 0; i < bytes.size(); i++ )
+		bytes[i] = uint8_t( randInt( 256 ) );
+
+	kernels.mInt16ToFloat( samples16.data() + 1, 1.0f / 32768.0f, result.data() + 1, length );
+	ref.mInt16ToFloat( samples16.data() + 1, 1.0f / 32768.0f, expected.data() + 1, length );
+	BOOST_CHECK_MESSAGE( maxError( result.data() + 1, expected.data() + 1, length ) == 0, "int16ToFloat " + message );
+
+	kernels.mInt24ToFloat( bytes.data() + 1, 1.0f / 8388608.0f, result.data() + 1, length );
+	ref.mInt24ToFloat( bytes.data() + 1, 1.0f / 8388608.0f, expected.data() + 1, length );
+	BOOST_CHECK_MESSAGE( maxError( result.data() + 1, expected.data() + 1, length ) == 0, "int24ToFloat " + message );
+}
+
+// returns the nanoseconds per sample that \a fn takes to process an array of \a length, averaged over \a iterations calls. The fastest
+// of several runs is returned, as it is the least affected by other work on the machine.
+template <typename FnT>
+double measureNanosecondsPerSample( const FnT &fn, size_t length, size_t iterations )
+{
+	const size_t numRuns = 5;
+
+	double fastest = numeric_limits<double>::max();
+	for( size_t run = 0; run < numRuns; run++ ) {
+		auto beginTime = chrono::steady_clock::now();
+		for( size_t i = 0; i < iterations; i++ )
+			fn();
+
+		double nanoseconds = chrono::duration<double, nano>( chrono::steady_clock::now() - beginTime ).count();
+		fastest = min( fastest, nanoseconds / double( length * iterations ) );
+	}
+
+	return fastest;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE( test_kernels_match_scalar )
+{
+	const size_t lengths[] = { 0, 1, 3, 4, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100, 512, 1023 };
+
+	auto supported = dsp::getSupportedSimdKernels();
+	BOOST_REQUIRE( ! supported.empty() );
+	BOOST_CHECK_EQUAL( string( supported.front()->mName ), "scalar" );
+
+	for( size_t i = 1; i < supported.size(); i++ ) {
+		for( size_t length : lengths )
+			checkKernels( *supported[i], length );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( test_max_of_negative_values )
+{
+	const float values[] = { -3, -2, -5, -1.5f, -4, -7, -9, -8, -6, -2.5f, -3.5f, -4.5f, -5.5f, -6.5f, -7.5f, -8.5f, -9.5f };
+	const size_t length = sizeof( values ) / sizeof( values[0] );
+
+	for( const dsp::SimdKernels *kernels : dsp::getSupportedSimdKernels() ) {
+		BOOST_CHECK_EQUAL( kernels->mMax( values, length ), -1.5f );
+		BOOST_CHECK_EQUAL( kernels->mMax( values, 0 ), 0 );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( test_dispatch )
+{
+	auto supported = dsp::getSupportedSimdKernels();
+	BOOST_CHECK_EQUAL( string( dsp::getSimdKernels().mName ), supported.back()->mName );
+
+	vector<float> a( 100 );
+	fillRandom( &a );
+	float widestRms = dsp::rms( a.data(), a.size() );
+
+	dsp::setSimdKernels( supported.front() );
+	BOOST_CHECK_EQUAL( string( dsp::getSimdKernels().mName ), "scalar" );
+	BOOST_CHECK_CLOSE( dsp::rms( a.data(), a.size() ), widestRms, 0.001f );
+
+	dsp::setSimdKernels( nullptr );
+	BOOST_CHECK_EQUAL( string( dsp::getSimdKernels().mName ), supported.back()->mName );
+}
+
+BOOST_AUTO_TEST_CASE( test_report_reduction_timings )
+{
+	const size_t length = 512;
+	const size_t iterations = 2000;
+
+	vector<float> a( length );
+	fillRandom( &a );
+
+	// accumulated so the reductions aren't optimized away.
+	volatile float sink = 0;
+
+	// wall-clock timings depend on the machine and its load, so they are only reported (with --log_level=message), never checked.
+	auto supported = dsp::getSupportedSimdKernels();
+	const dsp::SimdKernels *ref = supported.front();
+	double refSum = measureNanosecondsPerSample( [&] { sink = sink + ref->mSum( a.data(), length ); }, length, iterations );
+	double refSumSquares = measureNanosecondsPerSample( [&] { sink = sink + ref->mSumSquares( a.data(), length ); }, length, iterations );
+
+	for( size_t i = 1; i < supported.size(); i++ ) {
+		const dsp::SimdKernels *kernels = supported[i];
+		double sum = measureNanosecondsPerSample( [&] { sink = sink + kernels->mSum( a.data(), length ); }, length, iterations );
+		double sumSquares = measureNanosecondsPerSample( [&] { sink = sink + kernels->mSumSquares( a.data(), length ); }, length, iterations );
+
+		BOOST_TEST_MESSAGE( string( kernels->mName ) + " sum: " + to_string( sum ) + "ns, scalar: " + to_string( refSum ) + "ns" );
+		BOOST_TEST_MESSAGE( string( kernels->mName ) + " sumSquares: " + to_string( sumSquares ) + "ns, scalar: " + to_string( refSumSquares ) + "ns" );
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
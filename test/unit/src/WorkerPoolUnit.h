@@ -0,0 +1,63 @@
+#pragma once
+
+#include "cinder/audio2/WorkerPool.h"
+
+BOOST_AUTO_TEST_SUITE( test_worker_pool )
+
+using namespace std;
+using namespace ci;
+using namespace ci::audio2;
+
+BOOST_AUTO_TEST_CASE( test_each_task_runs_once )
+{
+	WorkerPool pool( 3 );
+	BOOST_REQUIRE_EQUAL( pool.getNumThreads(), 3 );
+
+	const size_t numTasks = 257;
+	vector<atomic<int> > counts( numTasks );
+
+	for( size_t batch = 0; batch < 1000; batch++ ) {
+		for( auto &c : counts )
+			c = 0;
+
+		pool.run( numTasks, [&counts]( size_t i ) { counts[i]++; } );
+
+		for( size_t i = 0; i < numTasks; i++ )
+			BOOST_REQUIRE_EQUAL( counts[i].load(), 1 );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( test_non_realtime )
+{
+	// without spinning, workers sleep between batches and are woken for each one.
+	WorkerPool pool( WorkerPool::Options().numThreads( 2 ).realtime( false ) );
+	BOOST_CHECK_EQUAL( pool.getNumThreads(), 2 );
+	BOOST_CHECK( ! pool.isRealtime() );
+	BOOST_CHECK( WorkerPool( 1 ).isRealtime() );
+
+	atomic<size_t> total( 0 );
+	for( size_t batch = 0; batch < 100; batch++ )
+		pool.run( 16, [&total]( size_t i ) { total++; } );
+
+	BOOST_CHECK_EQUAL( total, 100 * 16 );
+}
+
+BOOST_AUTO_TEST_CASE( test_concurrent_run )
+{
+	// a second thread calling run() while the pool is busy processes its tasks serially.
+	WorkerPool pool( 2 );
+	atomic<size_t> total( 0 );
+
+	auto runBatches = [&] {
+		for( size_t batch = 0; batch < 500; batch++ )
+			pool.run( 16, [&total]( size_t i ) { total++; } );
+	};
+
+	thread other( runBatches );
+	runBatches();
+	other.join();
+
+	BOOST_CHECK_EQUAL( total.load(), 2 * 500 * 16 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -7,4 +7,14 @@
 
 #include "BufferUnit.h"
 #include "FftUnit.h"
-#include "RingbufferUnit.h"
\ No newline at end of file
+#include "RingbufferUnit.h"
+#include "ContextOfflineUnit.h"
+#include "WorkerPoolUnit.h"
+#include "ContextNullUnit.h"
+#include "ProfilerUnit.h"
+#include "NodeSubgraphUnit.h"
+#include "NodeSpectralUnit.h"
+#include "GraphPrototypeUnit.h"
+#include "MemoryPoolUnit.h"
+#include "GraphRecorderUnit.h"
+#include "SimdUnit.h"
\ No newline at end of file